@@ -7,6 +7,7 @@
 #include "../../Common.h"
 #include "../../libApp/commands/CommandBroker.h"
 #include "../../lib/tasks/OnTask.h"
+#include "../Plugins.config.h"
 
 #include <NimBLEDevice.h>
 
@@ -17,6 +18,13 @@ static const char *NUS_SERVICE_UUID = "6E400001-B5A3-F393-E0A9-E50E24DCCA9E";
 static const char *NUS_TX_CHAR_UUID = "6E400002-B5A3-F393-E0A9-E50E24DCCA9E";
 static const char *NUS_RX_CHAR_UUID = "6E400003-B5A3-F393-E0A9-E50E24DCCA9E";
 
+#ifdef HAS_METRICS_PLUGIN
+  // time from a command reaching the broker to its reply (or timeout)
+  static MetricsPlugin::Family *roundTripMetric = nullptr;
+  static int metricsChannel = -1;
+  static uint32_t brokerFull = 0;
+#endif
+
 // ── BLE callbacks ─────────────────────────────────────────────────────────────
 
 class BleServerCallbacks : public NimBLEServerCallbacks {
@@ -29,6 +37,9 @@ class BleServerCallbacks : public NimBLEServerCallbacks {
 
 class BleWriteCallbacks : public NimBLECharacteristicCallbacks {
   void onWrite(NimBLECharacteristic *ch) override {
+    #ifdef HAS_METRICS_PLUGIN
+      MetricsPlugin::HeapScope scope(HEAP_TAG_BLE);
+    #endif
     const std::string &v = ch->getValue();
     if (!v.empty())
       bluetoothBle.onBleWrite(reinterpret_cast<const uint8_t *>(v.data()), v.length());
@@ -37,7 +48,12 @@ class BleWriteCallbacks : public NimBLECharacteristicCallbacks {
 
 // ── OnTask wrapper ────────────────────────────────────────────────────────────
 
-static void bleWrapper() { bluetoothBle.loop(); }
+#ifdef HAS_METRICS_PLUGIN
+  static int bleJob = -1;
+  static void bleWrapper() { MetricsPlugin::JobTimer timer(bleJob); MetricsPlugin::HeapScope scope(HEAP_TAG_BLE); bluetoothBle.loop(); }
+#else
+  static void bleWrapper() { bluetoothBle.loop(); }
+#endif
 
 // ── BluetoothBle::init ────────────────────────────────────────────────────────
 
@@ -76,6 +92,26 @@ void BluetoothBle::init() {
 
   VLF("MSG: BluetoothBle, advertising as '" BLE_DEVICE_NAME "'");
 
+  #ifdef HAS_METRICS_PLUGIN
+    roundTripMetric = metricsPlugin.addSummary("ble_command_round_trip_seconds", "BLE command round trip through the command broker");
+    bleJob = metricsPlugin.addJob("bluetoothBle", 20);
+    metricsChannel = metricsPlugin.addCommandChannel("ble");
+
+    // the broker belongs to OnStepX, what's seen here is the one slot this plugin holds at a time and the
+    // commands waiting behind it in the receive buffer
+    metricsPlugin.addFamily("ble_command_pending", "BLE command in flight in a CommandBroker slot (1: yes)", "gauge", {}, 1,
+      [this](MetricsPlugin::Family &f) { f.set(0, pendingHandle != 0 ? 1 : 0); });
+    metricsPlugin.addFamily("ble_command_buffer", "BLE received command text waiting to be sent", "gauge", {"unit"}, 1, [this](MetricsPlugin::Family &f) {
+      xSemaphoreTake(mutex, portMAX_DELAY);
+      int waiting = rxLen;
+      xSemaphoreGive(mutex);
+      f.label(0, 0, "bytes");
+      f.set(0, waiting);
+    });
+    metricsPlugin.addFamily("ble_command_broker_full", "BLE commands not sent since the CommandBroker slots were full", "counter", {}, 1,
+      [](MetricsPlugin::Family &f) { f.setInteger(0, brokerFull); });
+  #endif
+
   // Poll loop every 20 ms; priority 7 matches the sample plugin.
   tasks.add(20, 0, true, 7, bleWrapper);
 }
@@ -106,6 +142,9 @@ void BluetoothBle::onBleWrite(const uint8_t *data, size_t len) {
   rxLen       += (int)n;
   rxBuf[rxLen] = '\0';
   xSemaphoreGive(mutex);
+  #ifdef HAS_METRICS_PLUGIN
+    metricsPlugin.commandDiscarded(metricsChannel, (int)(len - n));
+  #endif
 }
 
 // ── loop (runs on OnTask every 20 ms) ────────────────────────────────────────
@@ -116,6 +155,10 @@ void BluetoothBle::loop() {
     char reply[128] = "";
     CommandBrokerStatus s = commandBroker.result(pendingHandle, reply, sizeof(reply));
     if (s == CB_DONE || s == CB_TIMEOUT) {
+      #ifdef HAS_METRICS_PLUGIN
+        if (roundTripMetric) roundTripMetric->observe(0, (millis() - pendingSince)/1000.0);
+        metricsPlugin.commandDone(metricsChannel, pendingCommand, (millis() - pendingSince)*1000UL, s == CB_TIMEOUT);
+      #endif
       if (s == CB_DONE && reply[0] != '\0') {
         size_t rlen = strlen(reply);
         char buf[130];
@@ -166,8 +209,15 @@ void BluetoothBle::loop() {
 
 void BluetoothBle::processCommand(const char *cmd) {
   VF("MSG: BluetoothBle, cmd: "); VLF(cmd);
+  pendingSince  = millis();
+  strncpy(pendingCommand, cmd, sizeof(pendingCommand) - 1);
   pendingHandle = commandBroker.request(cmd, BLE_RESPONSE_TIMEOUT_MS);
-  if (!pendingHandle) { DLF("ERR: BluetoothBle, CommandBroker slots full"); }
+  if (!pendingHandle) {
+    DLF("ERR: BluetoothBle, CommandBroker slots full");
+    #ifdef HAS_METRICS_PLUGIN
+      brokerFull++;
+    #endif
+  }
 }
 
 // ── command (no custom LX200 commands) ───────────────────────────────────────
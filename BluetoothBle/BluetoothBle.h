@@ -45,6 +45,8 @@ private:
 
   bool    clientConnected = false;
   uint8_t pendingHandle   = 0;  // CommandBroker handle; 0 = none in-flight
+  unsigned long pendingSince = 0;  // millis() when the in-flight command was requested
+  char    pendingCommand[8] = "";  // start of the in-flight command, enough for its two letter prefix
 };
 
 extern BluetoothBle bluetoothBle;
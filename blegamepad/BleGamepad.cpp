@@ -3,14 +3,21 @@
 #include "BleGamepad.h"
 #include "Common.h"
 #include "../../lib/tasks/OnTask.h"
+#include "../Plugins.config.h"
 
 #include <NimBLEDevice.h>
 #include "BleConfig.h"
 
-void blegamepadWrapper() { blegamepad.loop(); }
+#ifdef HAS_METRICS_PLUGIN
+  int blegamepadJob = -1;
+  void blegamepadWrapper() { MetricsPlugin::JobTimer timer(blegamepadJob); MetricsPlugin::HeapScope scope(HEAP_TAG_GAMEPAD); blegamepad.loop(); }
+#else
+  void blegamepadWrapper() { blegamepad.loop(); }
+#endif
 
 void BleGamepad::init() {
   VLF("MSG: Plugins, starting: BleGamepad");
+  onStepBle.init();
   bleInit();
   bleSetup();
 
@@ -27,6 +34,9 @@ void BleGamepad::init() {
   // start a task that runs twice a second, run at priority level 7 so
   // we can block using tasks.yield(); fairly aggressively without significant impact on operation
   tasks.add(500, 0, true, 7, blegamepadWrapper);
+  #ifdef HAS_METRICS_PLUGIN
+    blegamepadJob = metricsPlugin.addJob("blegamepad", 500);
+  #endif
   VLF("MSG: BleGamepad Plugin ready");
 }
 
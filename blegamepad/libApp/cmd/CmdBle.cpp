@@ -3,15 +3,41 @@
 
 #include "CmdBle.h"
 #include "../../../../libApp/commands/ProcessCmds.h"
+#include "../../../Plugins.config.h"
 
 int timeout = TIMEOUT;
 
+#ifdef HAS_METRICS_PLUGIN
+  static int metricsChannel = -1;
+#endif
+
+void OnStepCmdBle::init() {
+  #ifdef HAS_METRICS_PLUGIN
+    if (metricsChannel < 0) metricsChannel = metricsPlugin.addCommandChannel("blegamepad");
+  #endif
+}
+
 void OnStepCmdBle::serialRecvFlush() {
-  while (SERIAL_ONSTEP.available() > 0) SERIAL_ONSTEP.read();
+  int discarded = 0;
+  while (SERIAL_ONSTEP.available() > 0) { SERIAL_ONSTEP.read(); discarded++; }
+  #ifdef HAS_METRICS_PLUGIN
+    metricsPlugin.commandDiscarded(metricsChannel, discarded);
+  #endif
 }
 
 // smart LX200 aware command and response (up to 80 chars) over serial
 bool OnStepCmdBle::processCommand(const char* cmd, char* response, long timeOutMs) {
+  #ifdef HAS_METRICS_PLUGIN
+    unsigned long startTime = micros();
+    bool success = processCommandUntimed(cmd, response, timeOutMs);
+    metricsPlugin.commandDone(metricsChannel, cmd, micros() - startTime, !success);
+    return success;
+  #else
+    return processCommandUntimed(cmd, response, timeOutMs);
+  #endif
+}
+
+bool OnStepCmdBle::processCommandUntimed(const char* cmd, char* response, long timeOutMs) {
   SERIAL_ONSTEP.setTimeout(timeOutMs);
 
   // clear the read/write buffers
@@ -10,6 +10,9 @@
 
 class OnStepCmdBle {
   public:
+    // register the command channel's metrics
+    void init();
+
     void serialRecvFlush();
 
     // low level smart LX200 aware command and response (up to 80 chars) over serial (includes any '#' frame char)
@@ -34,6 +37,7 @@ class OnStepCmdBle {
     char* commandErrorToStr(int e);
 
   private:
+    bool processCommandUntimed(const char* cmd, char* response, long timeOutMs);
 };
 
 // timeout 
@@ -5,12 +5,17 @@
 #include "ElegantOTAPlugin.h"
 #include "../../Common.h"
 #include "../../lib/tasks/OnTask.h"
+#include "../Plugins.config.h"
 
 #include "../../lib/ethernet/webServer/WebServer.h"
 #include "../../lib/wifi/webServer/WebServer.h"
 
 WebServer *eOTAWebServer = nullptr;
 
+#ifdef HAS_METRICS_PLUGIN
+  int elegantOtaJob = -1;
+#endif
+
 void ElegantOTAPlugin::init() {
 #ifdef __ONSTEP_HAS_WEBSERVER
   eOTAWebServer = &www;
@@ -57,7 +62,12 @@ void ElegantOTAPlugin::initialiseElegantOTA() {
   VLF("MSG: Plugins, starting: elegantOTA");
   ElegantOTA.begin(eOTAWebServer, ELEGANTOTA_PLUGIN_USERNAME, ELEGANTOTA_PLUGIN_PASSWORD);
 
-  tasks.add(100, 0, true, 7, [](){ ElegantOTA.loop();});
+  #ifdef HAS_METRICS_PLUGIN
+    elegantOtaJob = metricsPlugin.addJob("elegantOTA", 100);
+    tasks.add(100, 0, true, 7, [](){ MetricsPlugin::JobTimer timer(elegantOtaJob); ElegantOTA.loop();});
+  #else
+    tasks.add(100, 0, true, 7, [](){ ElegantOTA.loop();});
+  #endif
   #ifndef __ONSTEP_HAS_WEBSERVER
   tasks.add(10, 0, true, 7, [](){ eOTAWebServer->handleClient();});
   #endif
@@ -6,14 +6,23 @@
 #include "../../lib/tasks/OnTask.h"
 #include "../../lib/convert/Convert.h"
 #include "../../telescope/mount/goto/Goto.h"
+#include "../Plugins.config.h"
 
-void rheostatWrapper() { guideRateRheostat.loop(); }
+#ifdef HAS_METRICS_PLUGIN
+  int rheostatJob = -1;
+  void rheostatWrapper() { MetricsPlugin::JobTimer timer(rheostatJob); guideRateRheostat.loop(); }
+#else
+  void rheostatWrapper() { guideRateRheostat.loop(); }
+#endif
 
 void GuideRateRheostat::init() {
   VLF("MSG: Plugins, starting: GuideRateRheostat");
 
   // start a task that runs once a second, run at priority level 7 so
   tasks.add(1000, 0, true, 7, rheostatWrapper);
+  #ifdef HAS_METRICS_PLUGIN
+    rheostatJob = metricsPlugin.addJob("guideRateRheostat", 1000);
+  #endif
 }
 
 void GuideRateRheostat::loop() {
@@ -0,0 +1,96 @@
+// Metrics plugin, LX200 command channel metrics
+#include "MetricsPlugin.h"
+
+// commands are reported by channel and the two letters after the ':' (or ACK), each gets its series
+// the first time it's seen so only the commands actually used take a place
+
+static const double commandBounds[] = {0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0};
+
+// the name of a command, characters that would need escaping in a label value are replaced
+static void commandName(const char *command, char *name) {
+    if (command[0] == (char)6) { strcpy(name, "ACK"); return; }
+    if (command[0] == ':' || command[0] == ';') command++;
+    int n = 0;
+    while (n < 2 && command[n] != 0 && command[n] != '#') {
+        char c = command[n];
+        name[n++] = (c < ' ' || c == '"' || c == '\\') ? '_' : c;
+    }
+    if (n == 0) name[n++] = '?';
+    name[n] = 0;
+}
+
+// the families are added with the first channel, which can be before init()
+int MetricsPlugin::addCommandChannel(const char *name) {
+    if (channelCount >= METRICS_COMMAND_CHANNELS_MAX) { DF("WRN: Metrics, can't add command channel "); DL(name); return -1; }
+
+    if (channelCount == 0) {
+        commandLatency = addHistogram("lx200_command_latency_seconds", "LX200 command time to its reply or timeout", {"channel", "command"},
+                                      METRICS_COMMANDS_MAX, commandBounds, sizeof(commandBounds)/sizeof(commandBounds[0]));
+        if (commandLatency != NULL) commandLatency->setCount(0);
+
+        addFamily("lx200_command_timeouts", "LX200 commands whose reply timed out", "counter", {"channel", "command"}, METRICS_COMMANDS_MAX, [this](Family &f) {
+            portENTER_CRITICAL(&commandLock);
+            int count = commandCount;
+            portEXIT_CRITICAL(&commandLock);
+            f.setCount(count);
+            for (int i = 0; i < count; i++) {
+                portENTER_CRITICAL(&commandLock);
+                uint32_t timeouts = commands[i].timeouts;
+                portEXIT_CRITICAL(&commandLock);
+                f.label(i, 0, channelNames[commands[i].channel]);
+                f.label(i, 1, commands[i].name);
+                f.setInteger(i, timeouts);
+            }
+        });
+
+        addFamily("lx200_discarded", "LX200 channel bytes flushed before a command or dropped with its buffer full", "counter", {"channel", "unit"},
+                  METRICS_COMMAND_CHANNELS_MAX, [this](Family &f) {
+            f.setCount(channelCount);
+            for (int i = 0; i < channelCount; i++) {
+                portENTER_CRITICAL(&commandLock);
+                uint64_t discarded = channelDiscarded[i];
+                portEXIT_CRITICAL(&commandLock);
+                f.label(i, 0, channelNames[i]);
+                f.label(i, 1, "bytes");
+                f.setInteger(i, discarded);
+            }
+        });
+    }
+
+    portENTER_CRITICAL(&commandLock);
+    channelNames[channelCount] = name;
+    channelDiscarded[channelCount] = 0;
+    int channel = channelCount++;
+    portEXIT_CRITICAL(&commandLock);
+    return channel;
+}
+
+void MetricsPlugin::commandDone(int channel, const char *command, unsigned long us, bool timedOut) {
+    if (channel < 0 || commandLatency == NULL) return;
+    char name[4];
+    commandName(command, name);
+
+    portENTER_CRITICAL(&commandLock);
+    int i = 0;
+    while (i < commandCount && (commands[i].channel != channel || strcmp(commands[i].name, name) != 0)) i++;
+    if (i == commandCount && commandCount < METRICS_COMMANDS_MAX) {
+        commands[i].channel = channel;
+        strcpy(commands[i].name, name);
+        commands[i].timeouts = 0;
+        commandLatency->label(i, 0, channelNames[channel]);
+        commandLatency->label(i, 1, commands[i].name);
+        commandLatency->setCount(++commandCount);
+    }
+    bool known = i < commandCount;
+    if (known && timedOut) commands[i].timeouts++;
+    portEXIT_CRITICAL(&commandLock);
+
+    if (known) commandLatency->observe(i, us/1000000.0);
+}
+
+void MetricsPlugin::commandDiscarded(int channel, int bytes) {
+    if (channel < 0 || bytes <= 0) return;
+    portENTER_CRITICAL(&commandLock);
+    channelDiscarded[channel] += bytes;
+    portEXIT_CRITICAL(&commandLock);
+}
@@ -0,0 +1,167 @@
+// Metrics plugin, heap allocations attributed to plugins
+#include "MetricsPlugin.h"
+
+#if METRICS_HEAP_TRACKING == ON
+
+#ifndef CONFIG_HEAP_USE_HOOKS
+  #warning "Metrics, METRICS_HEAP_TRACKING needs CONFIG_HEAP_USE_HOOKS in the ESP-IDF configuration, nothing will be attributed"
+#endif
+
+// the allocator calls the hooks for every allocation and free, possibly with the flash cache off, so they
+// are in IRAM, use only internal RAM and do no more than a short table lookup under a spinlock
+
+struct HeapTask {
+    TaskHandle_t task;
+    uint8_t tag;
+};
+struct HeapEntry {
+    void *ptr;
+    uint32_t size;
+    uint8_t tag;
+};
+
+static HeapTask heapTasks[METRICS_HEAP_TASKS_MAX];
+static HeapEntry *heapEntries = NULL;  // open addressed on the pointer, NULL if empty
+static volatile uint32_t heapTracked = 0;
+static uint32_t heapLive[HEAP_TAG_COUNT];
+static uint32_t heapLiveCount[HEAP_TAG_COUNT];
+static uint32_t heapAllocations[HEAP_TAG_COUNT];
+static uint32_t heapUntracked = 0;
+static portMUX_TYPE heapLock = portMUX_INITIALIZER_UNLOCKED;
+static const char *heapTagNames[HEAP_TAG_COUNT] = {"other", "website", "metrics", "ble", "gamepad"};
+
+#define HEAP_SLOT_MASK (METRICS_HEAP_TRACKING_SLOTS - 1)
+
+static inline uint32_t heapSlot(void *ptr) { return (((uint32_t)ptr >> 2)*2654435761UL) & HEAP_SLOT_MASK; }
+
+// the slot holding ptr, or the empty slot where it would go, there is always one since the table is kept under 3/4 full
+static inline uint32_t IRAM_ATTR heapFind(void *ptr) {
+    uint32_t i = heapSlot(ptr);
+    while (heapEntries[i].ptr != NULL && heapEntries[i].ptr != ptr) i = (i + 1) & HEAP_SLOT_MASK;
+    return i;
+}
+
+MetricsPlugin::HeapScope::HeapScope(uint8_t tag) {
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    slot = -1;
+    previous = HEAP_TAG_OTHER;
+    int empty = -1;
+    portENTER_CRITICAL(&heapLock);
+    for (int i = 0; i < METRICS_HEAP_TASKS_MAX; i++) {
+        if (heapTasks[i].task == task) { slot = i; break; }
+        if (heapTasks[i].task == NULL && empty < 0) empty = i;
+    }
+    if (slot < 0 && empty >= 0) { slot = empty; heapTasks[slot].task = task; heapTasks[slot].tag = HEAP_TAG_OTHER; }
+    if (slot >= 0) { previous = heapTasks[slot].tag; heapTasks[slot].tag = tag; }
+    portEXIT_CRITICAL(&heapLock);
+}
+
+MetricsPlugin::HeapScope::~HeapScope() {
+    if (slot < 0) return;
+    portENTER_CRITICAL(&heapLock);
+    heapTasks[slot].tag = previous;
+    if (previous == HEAP_TAG_OTHER) heapTasks[slot].task = NULL;
+    portEXIT_CRITICAL(&heapLock);
+}
+
+// a block resized in place is passed again with its new size, it keeps the tag it was allocated with
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps) {
+    (void)caps;
+    if (heapEntries == NULL) return;
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL_SAFE(&heapLock);
+    uint8_t tag = HEAP_TAG_OTHER;
+    for (int i = 0; i < METRICS_HEAP_TASKS_MAX; i++) if (heapTasks[i].task == task) { tag = heapTasks[i].tag; break; }
+
+    uint32_t i = heapFind(ptr);
+    HeapEntry &entry = heapEntries[i];
+    if (entry.ptr == ptr) {
+        heapLive[entry.tag] += size - entry.size;
+        entry.size = size;
+    } else
+
+    if (tag != HEAP_TAG_OTHER) {
+        heapAllocations[tag]++;
+        if (heapTracked < METRICS_HEAP_TRACKING_SLOTS*3/4) {
+            entry.ptr = ptr;
+            entry.size = size;
+            entry.tag = tag;
+            heapTracked++;
+            heapLive[tag] += size;
+            heapLiveCount[tag]++;
+        } else heapUntracked++;
+    }
+    portEXIT_CRITICAL_SAFE(&heapLock);
+}
+
+// the entry is removed by moving later entries of the same probe run back, so lookups never need tombstones
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void *ptr) {
+    if (heapEntries == NULL || heapTracked == 0) return;
+
+    portENTER_CRITICAL_SAFE(&heapLock);
+    uint32_t i = heapFind(ptr);
+    if (heapEntries[i].ptr == ptr) {
+        heapLive[heapEntries[i].tag] -= heapEntries[i].size;
+        heapLiveCount[heapEntries[i].tag]--;
+        heapTracked--;
+
+        uint32_t j = i;
+        for (;;) {
+            j = (j + 1) & HEAP_SLOT_MASK;
+            if (heapEntries[j].ptr == NULL) break;
+            uint32_t k = heapSlot(heapEntries[j].ptr);
+            // the entry at j stays if its home slot k is cyclically after the gap at i and at or before j
+            if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+            heapEntries[i] = heapEntries[j];
+            i = j;
+        }
+        heapEntries[i].ptr = NULL;
+    }
+    portEXIT_CRITICAL_SAFE(&heapLock);
+}
+
+void MetricsPlugin::initHeapMetrics() {
+    HeapEntry *entries = (HeapEntry *)heap_caps_calloc(METRICS_HEAP_TRACKING_SLOTS, sizeof(HeapEntry), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (entries == NULL) { DLF("WRN: Metrics, out of memory for heap tracking"); return; }
+    heapEntries = entries;
+
+    // the counts are copied under the lock so an allocation meanwhile can't tear them, other isn't tracked
+    addFamily("heap_plugin_live", "Heap allocated by each plugin and not yet freed", "gauge", {"plugin", "unit"}, HEAP_TAG_COUNT - 1, [](Family &f) {
+        for (int i = 1; i < HEAP_TAG_COUNT; i++) {
+            portENTER_CRITICAL(&heapLock);
+            uint32_t live = heapLive[i];
+            portEXIT_CRITICAL(&heapLock);
+            f.label(i - 1, 0, heapTagNames[i]);
+            f.label(i - 1, 1, "bytes");
+            f.setInteger(i - 1, live);
+        }
+    });
+    addFamily("heap_plugin_live_allocations", "Heap allocations by each plugin not yet freed", "gauge", {"plugin"}, HEAP_TAG_COUNT - 1, [](Family &f) {
+        for (int i = 1; i < HEAP_TAG_COUNT; i++) {
+            portENTER_CRITICAL(&heapLock);
+            uint32_t count = heapLiveCount[i];
+            portEXIT_CRITICAL(&heapLock);
+            f.label(i - 1, 0, heapTagNames[i]);
+            f.setInteger(i - 1, count);
+        }
+    });
+    addFamily("heap_plugin_allocations", "Heap allocations by each plugin", "counter", {"plugin"}, HEAP_TAG_COUNT - 1, [](Family &f) {
+        for (int i = 1; i < HEAP_TAG_COUNT; i++) {
+            portENTER_CRITICAL(&heapLock);
+            uint32_t count = heapAllocations[i];
+            portEXIT_CRITICAL(&heapLock);
+            f.label(i - 1, 0, heapTagNames[i]);
+            f.setInteger(i - 1, count);
+        }
+    });
+    addFamily("heap_untracked_allocations", "Heap allocations not tracked since the table was full", "counter", {}, 1, [](Family &f) {
+        f.setInteger(0, heapUntracked);
+    });
+}
+
+#else
+
+void MetricsPlugin::initHeapMetrics() {}
+
+#endif
@@ -0,0 +1,180 @@
+// Metrics plugin, on-device history of selected values
+#include "MetricsPlugin.h"
+#include "../../lib/ethernet/webServer/WebServer.h"
+#include "../../lib/wifi/webServer/WebServer.h"
+
+#include <esp_wifi.h>
+
+#define HISTORY_STEPS {1, 60, 600}
+
+static inline uint32_t uptimeSeconds() { return (uint32_t)(esp_timer_get_time()/1000000LL); }
+
+bool MetricsPlugin::addHistory(const char *name, const std::function<double()> &read) {
+#if METRICS_HISTORY == ON
+    if (historyCount >= METRICS_HISTORY_SERIES_MAX) { DF("WRN: Metrics, history full adding "); DL(name); return false; }
+
+    History &h = history[historyCount];
+    const int points[3] = METRICS_HISTORY_POINTS;
+    for (int i = 0; i < 3; i++) {
+        HistoryRing &ring = h.rings[i];
+        ring.size = points[i];
+        ring.points = (float *)heap_caps_malloc(ring.size*sizeof(float), MALLOC_CAP_SPIRAM);
+        if (ring.points == NULL) {
+            ring.size = points[i]/8;
+            ring.points = (float *)malloc(ring.size*sizeof(float));
+        }
+        if (ring.points == NULL) {
+            for (int j = 0; j < i; j++) free(h.rings[j].points);
+            DF("WRN: Metrics, out of memory adding history "); DL(name);
+            return false;
+        }
+        ring.count = 0;
+        ring.head = 0;
+        ring.last = 0;
+    }
+    h.name = name;
+    h.read = read;
+    for (int i = 0; i < 2; i++) { h.sum[i] = 0.0; h.count[i] = 0; h.samples[i] = 0; }
+
+    // the sampler only looks at series below the count so this one is complete before it sees it
+    portENTER_CRITICAL(&historyLock);
+    historyCount++;
+    portEXIT_CRITICAL(&historyLock);
+    return true;
+#else
+    (void)name; (void)read;
+    return false;
+#endif
+}
+
+#if METRICS_HISTORY == ON
+
+TaskHandle_t _metricsHistoryTask;
+void metricsHistoryTask(void *parameter) {
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(1000));
+        MetricsPlugin::HeapScope heapScope(HEAP_TAG_METRICS);
+        metricsPlugin.sampleHistory();
+    }
+}
+
+void MetricsPlugin::initHistory() {
+    addHistory("heap_free", [](){ return (double)ESP.getFreeHeap(); });
+    addHistory("cpu_temperature", [](){ return (double)temperatureRead(); });
+    addHistory("wifi_rssi", [](){
+        wifi_ap_record_t ap;
+        if (!WiFi.isConnected() || esp_wifi_sta_get_ap_info(&ap) != ESP_OK) return (double)NAN;
+        return (double)ap.rssi;
+    });
+
+    VLF("MSG: Metrics, starting history FreeRTOS task (priority 1)");
+    xTaskCreatePinnedToCore(metricsHistoryTask, "MetricsHistTask", 3000, NULL, 1, &_metricsHistoryTask, 0);
+}
+
+// adds a point to a ring, called with the history lock held
+void MetricsPlugin::historyPush(HistoryRing &ring, float value, uint32_t time) {
+    ring.points[ring.head] = value;
+    if (++ring.head >= ring.size) ring.head = 0;
+    if (ring.count < ring.size) ring.count++;
+    ring.last = time;
+}
+
+// takes a sample of each series, the averages of 60 samples make the 1 minute points and of 10 of those
+// the 10 minute points, unknown samples are left out of the averages
+void MetricsPlugin::sampleHistory() {
+    uint32_t now = uptimeSeconds();
+    int count = historyCount;
+
+    for (int i = 0; i < count; i++) {
+        History &h = history[i];
+        double value = h.read();
+
+        float minute = NAN, tenMinute = NAN;
+        bool minuteDone = false, tenMinuteDone = false;
+        if (!isnan(value)) { h.sum[0] += value; h.count[0]++; }
+        if (++h.samples[0] >= 60) {
+            if (h.count[0] > 0) minute = h.sum[0]/h.count[0];
+            h.sum[0] = 0.0; h.count[0] = 0; h.samples[0] = 0;
+            minuteDone = true;
+
+            if (!isnan(minute)) { h.sum[1] += minute; h.count[1]++; }
+            if (++h.samples[1] >= 10) {
+                if (h.count[1] > 0) tenMinute = h.sum[1]/h.count[1];
+                h.sum[1] = 0.0; h.count[1] = 0; h.samples[1] = 0;
+                tenMinuteDone = true;
+            }
+        }
+
+        portENTER_CRITICAL(&historyLock);
+        historyPush(h.rings[0], value, now);
+        if (minuteDone) historyPush(h.rings[1], minute, now);
+        if (tenMinuteDone) historyPush(h.rings[2], tenMinute, now);
+        portEXIT_CRITICAL(&historyLock);
+    }
+}
+
+// GET METRICS_PLUGIN_PATH/range?series=name&from=s&step=s
+// from is the uptime in seconds of the first point wanted, or if negative that many seconds ago (default all)
+// step picks the resolution, the finest of 1, 60 and 600 seconds not finer than it (default 1)
+// without a series the names of those held are listed
+void MetricsPlugin::handleRange() {
+    HeapScope heapScope(HEAP_TAG_METRICS);
+    String name = www.arg("series");
+    int i = 0;
+    while (i < historyCount && !name.equals(history[i].name)) i++;
+
+    if (i >= historyCount) {
+        response.clear();
+        for (int j = 0; j < historyCount; j++) { response.concat(history[j].name); response.concat('\n'); }
+        www.send(name.length() == 0 ? 200 : 404, "text/plain", response);
+        response.clear();
+        return;
+    }
+
+    const uint32_t steps[3] = HISTORY_STEPS;
+    long step = www.arg("step").toInt();
+    int resolution = 0;
+    while (resolution < 2 && step >= (long)steps[resolution + 1]) resolution++;
+
+    uint32_t now = uptimeSeconds();
+    String fromArg = www.arg("from");
+    long from = fromArg.toInt();
+    uint32_t first = 0;
+    if (fromArg.length() > 0) first = from < 0 ? (-from > (long)now ? 0 : now + from) : from;
+
+    www.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    www.sendHeader("Cache-Control", "no-cache");
+    www.send(200, "text/plain", String());
+
+    char line[64];
+    snprintf(line, sizeof(line), "# %s step %lu s uptime %lu s\ntime,value\n", history[i].name, (unsigned long)steps[resolution], (unsigned long)now);
+    response.clear();
+    response.concat(line);
+
+    // positions are from the ring as it was at the start, points are then read one at a time under the lock
+    // so the sampler is never held up for long, a point could only change if the ring wrapped meanwhile
+    HistoryRing &ring = history[i].rings[resolution];
+    portENTER_CRITICAL(&historyLock);
+    int count = ring.count;
+    int head = ring.head;
+    uint32_t last = ring.last;
+    portEXIT_CRITICAL(&historyLock);
+    for (int k = count - 1; k >= 0; k--) {
+        uint32_t time = last - k*steps[resolution];
+        if (time < first) continue;
+
+        portENTER_CRITICAL(&historyLock);
+        float value = ring.points[(head - 1 - k + ring.size) % ring.size];
+        portEXIT_CRITICAL(&historyLock);
+
+        if (isnan(value)) snprintf(line, sizeof(line), "%lu,NaN\n", (unsigned long)time);
+        else snprintf(line, sizeof(line), "%lu,%.9g\n", (unsigned long)time, value);
+        response.concat(line);
+        flush();
+    }
+    flush(true);
+    www.sendContent("");
+}
+
+#endif
@@ -5,6 +5,7 @@
 #define METRICS_CONTENT_TYPE "text/plain; version=0.0.4"
 
 #include <ctime>
+#include <esp_wifi.h>
 #ifdef ESP32
 #define UPTIME esp_timer_get_time() / 1'000'000.0f 
 #else
@@ -32,7 +33,20 @@ time_t getUnixTimestampUTC(TinyGPSDate& date, TinyGPSTime& time) {
 
 void MetricsPlugin::init() {
   VLF("MSG: Plugins, starting: metrics");
+  response.reserve(METRICS_CHUNK_SIZE + 256);
+  registryLock = xSemaphoreCreateMutex();
+  if (populatorLock == NULL) populatorLock = xSemaphoreCreateMutex();
+  initHeapMetrics();
+  initSystemMetrics();
+  initTaskMetrics();
   www.on(METRICS_PLUGIN_PATH, HTTP_GET, std::bind(&MetricsPlugin::populateMetrics, this));
+  #if METRICS_HISTORY == ON
+    initHistory();
+    www.on(METRICS_PLUGIN_PATH "/range", HTTP_GET, std::bind(&MetricsPlugin::handleRange, this));
+  #endif
+  #if METRICS_PUSH != OFF
+    initPush();
+  #endif
 }
 
 const char *resetReasonName(esp_reset_reason_t r) {
@@ -52,73 +66,483 @@ const char *resetReasonName(esp_reset_reason_t r) {
   }
 }
 
+// label values for the system metrics, those that can change are rewritten before each scrape
+static char sketchMd5[33];
+static char chipCores[4], chipModel[24], chipRevision[4], chipFrequency[8];
+static char wifiSsid[33], wifiChannel[4], wifiBssid[18], wifiMac[18];
+static char wifiIp[16], wifiGateway[16], wifiSubnet[16], wifiDns[16];
+
+static void formatIp(char *s, const IPAddress &ip) {
+    snprintf(s, 16, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+static void formatMac(char *s, const uint8_t *mac) {
+    snprintf(s, 18, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+void MetricsPlugin::initSystemMetrics() {
+    strncpy(sketchMd5, ESP.getSketchMD5().c_str(), sizeof(sketchMd5) - 1);
+    snprintf(chipCores, sizeof(chipCores), "%u", (unsigned)ESP.getChipCores());
+    strncpy(chipModel, ESP.getChipModel(), sizeof(chipModel) - 1);
+    snprintf(chipRevision, sizeof(chipRevision), "%u", (unsigned)ESP.getChipRevision());
+    snprintf(chipFrequency, sizeof(chipFrequency), "%u", (unsigned)ESP.getCpuFreqMHz());
+
+    // max-alloc is the largest free block, fragmentation is the fraction of the free memory outside it
+    addFamily("memory", "ESP32 Memory usage", "gauge", {"md5", "type", "memory", "unit"}, 12, [](Family &f) {
+        static const char *types[] = {"free", "size", "min-free", "max-alloc"};
+        for (int i = 0; i < 10; i++) {
+            f.label(i, 1, i < 8 ? types[i % 4] : (i == 8 ? "size" : "free"));
+            f.label(i, 2, i < 4 ? "heap" : (i < 8 ? "psram" : "sketch"));
+            f.label(i, 3, "bytes");
+        }
+        for (int i = 10; i < 12; i++) {
+            f.label(i, 1, "fragmentation");
+            f.label(i, 2, i == 10 ? "heap" : "psram");
+            f.label(i, 3, "ratio");
+        }
+        f.label(8, 0, sketchMd5);
+        f.set(0, ESP.getFreeHeap());
+        f.set(1, ESP.getHeapSize());
+        f.set(2, ESP.getMinFreeHeap());
+        f.set(3, ESP.getMaxAllocHeap());
+        f.set(4, ESP.getFreePsram());
+        f.set(5, ESP.getPsramSize());
+        f.set(6, ESP.getMinFreePsram());
+        f.set(7, ESP.getMaxAllocPsram());
+        f.set(8, ESP.getSketchSize());
+        f.set(9, ESP.getFreeSketchSpace());
+        uint32_t heapFree = ESP.getFreeHeap(), psramFree = ESP.getFreePsram();
+        f.set(10, heapFree > 0 ? 1.0 - (double)ESP.getMaxAllocHeap()/heapFree : 0.0);
+        f.set(11, psramFree > 0 ? 1.0 - (double)ESP.getMaxAllocPsram()/psramFree : 0.0);
+    });
+
+    addFamily("chip", "Chip Info", "gauge", {"cores", "model", "revision", "frequency_MHz"}, 1, [](Family &f) {
+        f.label(0, 0, chipCores);
+        f.label(0, 1, chipModel);
+        f.label(0, 2, chipRevision);
+        f.label(0, 3, chipFrequency);
+        f.set(0, 0.f);
+    });
+
+    addFamily("wifi_rssi", "WiFi RSSI", "gauge", {"ssid", "channel"}, 1, [](Family &f) {
+        wifi_ap_record_t ap;
+        if (!WiFi.isConnected() || esp_wifi_sta_get_ap_info(&ap) != ESP_OK) { f.setCount(0); return; }
+        f.setCount(1);
+        strncpy(wifiSsid, (const char *)ap.ssid, sizeof(wifiSsid) - 1);
+        snprintf(wifiChannel, sizeof(wifiChannel), "%u", (unsigned)ap.primary);
+        formatMac(wifiBssid, ap.bssid);
+        f.label(0, 0, wifiSsid);
+        f.label(0, 1, wifiChannel);
+        f.set(0, ap.rssi);
+    });
+
+    addFamily("wifi", "WiFi Info", "gauge",
+              {"connected", "ssid", "channel", "ip", "gateway", "subnet", "dns", "hostname", "mac", "bssid"}, 1, [](Family &f) {
+        bool connected = WiFi.isConnected();
+        f.label(0, 0, connected ? "1" : "0");
+        for (int i = 1; i < 10; i++) f.label(0, i, NULL);
+        f.set(0, 0.f);
+        if (!connected) return;
+
+        // ssid, channel and bssid were read for wifi_rssi just before
+        uint8_t mac[6];
+        WiFi.macAddress(mac);
+        formatMac(wifiMac, mac);
+        formatIp(wifiIp, WiFi.localIP());
+        formatIp(wifiGateway, WiFi.gatewayIP());
+        formatIp(wifiSubnet, WiFi.subnetMask());
+        formatIp(wifiDns, WiFi.dnsIP());
+        const char *values[] = {wifiSsid, wifiChannel, wifiIp, wifiGateway, wifiSubnet, wifiDns, WiFi.getHostname(), wifiMac, wifiBssid};
+        for (int i = 1; i < 10; i++) f.label(0, i, values[i - 1]);
+    });
+
+    addFamily("uptime", "ESP32 uptime", "gauge", {"unit"}, 1, [](Family &f) {
+        f.label(0, 0, "seconds");
+        f.set(0, UPTIME);
+    });
+
+    addFamily("reset_reason", "ESP32 reset reason", "gauge", {"reason"}, 1, [](Family &f) {
+        esp_reset_reason_t reason = esp_reset_reason();
+        f.label(0, 0, resetReasonName(reason));
+        f.set(0, static_cast<float>(reason));
+    });
+
+    addFamily("cpu_temperature", "ESP32 CPU temperature", "gauge", {"unit"}, 1, [](Family &f) {
+        f.label(0, 0, "celsius");
+        f.set(0, temperatureRead());
+    });
+}
+
+MetricsPlugin::Family *MetricsPlugin::add(const char *name, const char *help, const char *type, uint8_t kind,
+                                          std::initializer_list<const char *> labels, int series) {
+    if (familyCount >= METRICS_FAMILIES_MAX || labels.size() > METRICS_FAMILY_LABELS_MAX || series < 1) {
+        DF("WRN: Metrics, can't add family "); DL(name);
+        return NULL;
+    }
+
+    Family &family = families[familyCount];
+    memset(family.labelNames, 0, sizeof(family.labelNames));
+    family.labelCount = 0;
+    for (const char *label: labels) {
+        int index = internLabel(label);
+        if (index < 0) { DF("WRN: Metrics, label names full adding "); DL(name); return NULL; }
+        family.labelNames[family.labelCount++] = index;
+    }
+
+    family.labelValues = family.labelCount > 0 ? (const char **)calloc(series*family.labelCount, sizeof(const char *)) : NULL;
+    if (family.labelCount > 0 && family.labelValues == NULL) { DF("WRN: Metrics, out of memory adding "); DL(name); return NULL; }
+
+    family.name = name;
+    family.help = help;
+    family.type = type;
+    family.kind = kind;
+    family.seriesMax = series;
+    family.seriesCount = series;
+    family.collect = nullptr;
+    family.scraped = false;
+    family.refresh = 0;
+    family.lastRefresh = 0;
+    family.published = NULL;
+    family.publishedLabels = NULL;
+    family.publishedCount = 0;
+    family.values = NULL;
+    family.bounds = NULL;
+    family.boundCount = 0;
+    family.counts = NULL;
+    family.sums = NULL;
+    family.samples = NULL;
+    family.sampleNext = NULL;
+    return &family;
+}
+
+MetricsPlugin::Family *MetricsPlugin::addFamily(const char *name, const char *help, const char *type,
+                                                std::initializer_list<const char *> labels, int series, const Collector &collect,
+                                                unsigned long refreshMs) {
+    Family *family = add(name, help, type, KIND_VALUE, labels, series);
+    if (family == NULL) return NULL;
+
+    family->values = (Family::Value *)calloc(series, sizeof(Family::Value));
+    if (collect && refreshMs > 0) {
+        family->published = (Family::Value *)calloc(series, sizeof(Family::Value));
+        if (family->labelCount > 0) family->publishedLabels = (const char **)calloc(series*family->labelCount, sizeof(const char *));
+    }
+    if (family->values == NULL || (collect && refreshMs > 0 && (family->published == NULL ||
+                                   (family->labelCount > 0 && family->publishedLabels == NULL)))) {
+        free(family->values);
+        free(family->published);
+        free(family->publishedLabels);
+        free(family->labelValues);
+        DF("WRN: Metrics, out of memory adding "); DL(name);
+        return NULL;
+    }
+
+    family->collect = collect;
+    if (family->published != NULL) {
+        family->refresh = refreshMs;
+        family->lastRefresh = millis() - refreshMs;
+        startCollect();
+    }
+    familyCount++;
+    return family;
+}
+
+MetricsPlugin::Family *MetricsPlugin::addHistogram(const char *name, const char *help, std::initializer_list<const char *> labels,
+                                                   int series, const double *bounds, int boundCount) {
+    if (boundCount < 1 || boundCount > METRICS_HISTOGRAM_BOUNDS_MAX) { DF("WRN: Metrics, bad histogram bounds "); DL(name); return NULL; }
+    Family *family = add(name, help, "histogram", KIND_HISTOGRAM, labels, series);
+    if (family == NULL) return NULL;
+
+    family->bounds = bounds;
+    family->boundCount = boundCount;
+    family->counts = (uint64_t *)calloc(series*(boundCount + 1), sizeof(uint64_t));
+    family->sums = (double *)calloc(series, sizeof(double));
+    if (family->counts == NULL || family->sums == NULL) {
+        free(family->counts);
+        free(family->sums);
+        free(family->labelValues);
+        DF("WRN: Metrics, out of memory adding "); DL(name);
+        return NULL;
+    }
+
+    familyCount++;
+    return family;
+}
+
+MetricsPlugin::Family *MetricsPlugin::addSummary(const char *name, const char *help, std::initializer_list<const char *> labels, int series) {
+    Family *family = add(name, help, "summary", KIND_SUMMARY, labels, series);
+    if (family == NULL) return NULL;
+
+    family->counts = (uint64_t *)calloc(series, sizeof(uint64_t));
+    family->sums = (double *)calloc(series, sizeof(double));
+    family->samples = (double *)calloc(series*METRICS_SUMMARY_SAMPLES, sizeof(double));
+    family->sampleNext = (uint16_t *)calloc(series, sizeof(uint16_t));
+    if (family->counts == NULL || family->sums == NULL || family->samples == NULL || family->sampleNext == NULL) {
+        free(family->counts);
+        free(family->sums);
+        free(family->samples);
+        free(family->sampleNext);
+        free(family->labelValues);
+        DF("WRN: Metrics, out of memory adding "); DL(name);
+        return NULL;
+    }
+
+    familyCount++;
+    return family;
+}
+
+// doubles are used throughout since the ESP32 FPU is single precision only, so this does no FPU work and
+// can run in an interrupt; it and the soft-float double routines it calls are in flash though, so not from
+// an IRAM_ATTR handler, one that may run while the flash cache is disabled
+void MetricsPlugin::Family::observe(int series, double value) {
+    if (series < 0 || series >= seriesMax) return;
+
+    if (kind == KIND_HISTOGRAM) {
+        int bucket = 0;
+        while (bucket < boundCount && value > bounds[bucket]) bucket++;
+        portENTER_CRITICAL_SAFE(&lock);
+        counts[series*(boundCount + 1) + bucket]++;
+        sums[series] += value;
+        portEXIT_CRITICAL_SAFE(&lock);
+    } else
+
+    if (kind == KIND_SUMMARY) {
+        portENTER_CRITICAL_SAFE(&lock);
+        samples[series*METRICS_SUMMARY_SAMPLES + sampleNext[series]] = value;
+        if (++sampleNext[series] >= METRICS_SUMMARY_SAMPLES) sampleNext[series] = 0;
+        counts[series]++;
+        sums[series] += value;
+        portEXIT_CRITICAL_SAFE(&lock);
+    }
+}
+
+int MetricsPlugin::Family::exposed() {
+    if (published == NULL) return seriesCount;
+    portENTER_CRITICAL(&lock);
+    int count = publishedCount;
+    portEXIT_CRITICAL(&lock);
+    return count;
+}
+
+void MetricsPlugin::Family::read(int series, Value &value, const char **labels) {
+    if (published == NULL) {
+        value = values[series];
+        if (labelCount > 0) memcpy(labels, &labelValues[series*labelCount], labelCount*sizeof(const char *));
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    value = published[series];
+    if (labelCount > 0) memcpy(labels, &publishedLabels[series*labelCount], labelCount*sizeof(const char *));
+    portEXIT_CRITICAL(&lock);
+}
+
+int MetricsPlugin::internLabel(const char *name) {
+    for (int i = 0; i < labelNameCount; i++) {
+        if (labelNames[i] == name || strcmp(labelNames[i], name) == 0) return i;
+    }
+    if (labelNameCount >= METRICS_LABEL_NAMES_MAX) return -1;
+    labelNames[labelNameCount] = name;
+    return labelNameCount++;
+}
+
+// nine significant digits keeps small values (times in seconds) and coordinates to better than an arc-second
+static void formatValue(char *s, int size, double value) {
+    if (isnan(value)) strcpy(s, "NaN"); else
+    if (isinf(value)) strcpy(s, value > 0 ? "+Inf" : "-Inf"); else
+    snprintf(s, size, "%.9g", value);
+}
+
+// formats one line into the response, a label whose value is NULL is left out, an extra label
+// (le or quantile) is added if extraLabel isn't NULL
+void MetricsPlugin::writeSeries(const Family &family, const char *const *labels, const char *suffix,
+                                const char *extraLabel, const char *extraValue, const char *value) {
+    response.concat(family.name);
+    response.concat(suffix);
+    response.concat('{');
+    bool first = true;
+    for (int j = 0; j < family.labelCount; j++) {
+        const char *labelValue = labels[j];
+        if (labelValue == NULL) continue;
+        if (!first) response.concat(',');
+        first = false;
+        response.concat(labelNames[family.labelNames[j]]);
+        response.concat("=\"");
+        response.concat(labelValue);
+        response.concat('"');
+    }
+    if (extraLabel != NULL) {
+        if (!first) response.concat(',');
+        response.concat(extraLabel);
+        response.concat("=\"");
+        response.concat(extraValue);
+        response.concat('"');
+    }
+    response.concat("} ");
+    response.concat(value);
+    response.concat('\n');
+    flush();
+}
+
+// formats a family into the response, histograms and summaries are read under their lock a series at a time
+void MetricsPlugin::write(Family &family) {
+    int count = family.exposed();
+    if (count == 0) return;
+
+    response.concat("# HELP "); response.concat(family.name); response.concat(' '); response.concat(family.help);
+    response.concat("\n# TYPE "); response.concat(family.name); response.concat(' '); response.concat(family.type);
+    response.concat('\n');
+
+    char value[24];
+    char bound[16];
+    for (int i = 0; i < count; i++) {
+        const char *labels[METRICS_FAMILY_LABELS_MAX];
+        if (family.kind == KIND_VALUE) {
+            Family::Value v;
+            family.read(i, v, labels);
+            if (v.whole) snprintf(value, sizeof(value), "%llu", (unsigned long long)v.integer);
+            else formatValue(value, sizeof(value), v.real);
+            writeSeries(family, labels, "", NULL, NULL, value);
+            continue;
+        }
+
+        // histograms and summaries are only observed into, their labels are set once
+        if (family.labelCount > 0) memcpy(labels, &family.labelValues[i*family.labelCount], family.labelCount*sizeof(const char *));
+
+        if (family.kind == KIND_HISTOGRAM) {
+            uint64_t counts[METRICS_HISTOGRAM_BOUNDS_MAX + 1];
+            double sum;
+            portENTER_CRITICAL(&family.lock);
+            memcpy(counts, &family.counts[i*(family.boundCount + 1)], (family.boundCount + 1)*sizeof(uint64_t));
+            sum = family.sums[i];
+            portEXIT_CRITICAL(&family.lock);
+
+            uint64_t cumulative = 0;
+            for (int j = 0; j <= family.boundCount; j++) {
+                cumulative += counts[j];
+                if (j < family.boundCount) snprintf(bound, sizeof(bound), "%g", family.bounds[j]); else strcpy(bound, "+Inf");
+                snprintf(value, sizeof(value), "%llu", (unsigned long long)cumulative);
+                writeSeries(family, labels, "_bucket", "le", bound, value);
+            }
+            formatValue(value, sizeof(value), sum);
+            writeSeries(family, labels, "_sum", NULL, NULL, value);
+            snprintf(value, sizeof(value), "%llu", (unsigned long long)cumulative);
+            writeSeries(family, labels, "_count", NULL, NULL, value);
+        } else
+
+        if (family.kind == KIND_SUMMARY) {
+            double samples[METRICS_SUMMARY_SAMPLES];
+            uint64_t count;
+            double sum;
+            portENTER_CRITICAL(&family.lock);
+            memcpy(samples, &family.samples[i*METRICS_SUMMARY_SAMPLES], sizeof(samples));
+            count = family.counts[i];
+            sum = family.sums[i];
+            portEXIT_CRITICAL(&family.lock);
+
+            // until the buffer fills only the first count samples are in use, order doesn't matter once sorted
+            int n = count < METRICS_SUMMARY_SAMPLES ? (int)count : METRICS_SUMMARY_SAMPLES;
+            for (int j = 1; j < n; j++) {
+                double v = samples[j];
+                int k = j - 1;
+                while (k >= 0 && samples[k] > v) { samples[k + 1] = samples[k]; k--; }
+                samples[k + 1] = v;
+            }
+
+            static const double quantiles[] = {0.5, 0.9, 0.99};
+            static const char *quantileNames[] = {"0.5", "0.9", "0.99"};
+            for (int j = 0; j < 3; j++) {
+                if (n == 0) strcpy(value, "NaN"); else formatValue(value, sizeof(value), samples[(int)lround(quantiles[j]*(n - 1))]);
+                writeSeries(family, labels, "", "quantile", quantileNames[j], value);
+            }
+            formatValue(value, sizeof(value), sum);
+            writeSeries(family, labels, "_sum", NULL, NULL, value);
+            snprintf(value, sizeof(value), "%llu", (unsigned long long)count);
+            writeSeries(family, labels, "_count", NULL, NULL, value);
+        }
+    }
+}
+
+// sends what has been formatted once there is a chunk's worth (or anything, if forced)
+void MetricsPlugin::flush(bool force) {
+    if (response.length() == 0 || (!force && response.length() < METRICS_CHUNK_SIZE)) return;
+    www.sendContent(response);
+    response.clear();
+}
+
 void MetricsPlugin::populateMetrics() {
+    HeapScope heapScope(HEAP_TAG_METRICS);
+
+    // streamed so the memory needed is bounded by a chunk (or the largest populator metric) not the whole response,
+    // clearing keeps the reserved capacity so the chunks normally allocate nothing
+    www.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    www.send(200, METRICS_CONTENT_TYPE, String());
+
     response.clear();
-    response += Metric{"memory", "ESP32 Memory usage", "gauge"}
-        .entry(Metric::Entry{1.f * ESP.getFreeHeap()}.label("type", "free").label("memory", "heap").label("unit", "bytes"))
-        .entry(Metric::Entry{1.f * ESP.getHeapSize()}.label("type", "size").label("memory", "heap").label("unit", "bytes"))
-        .entry(Metric::Entry{1.f * ESP.getMinFreeHeap()}.label("type", "min-free").label("memory", "heap").label("unit", "bytes"))
-        .entry(Metric::Entry{1.f * ESP.getMaxAllocHeap()}.label("type", "max-alloc").label("memory", "heap").label("unit", "bytes"))
-        
-        .entry(Metric::Entry{1.f * ESP.getFreePsram()}.label("type", "free").label("memory", "psram").label("unit", "bytes"))
-        .entry(Metric::Entry{1.f * ESP.getPsramSize()}.label("type", "size").label("memory", "psram").label("unit", "bytes"))
-        .entry(Metric::Entry{1.f * ESP.getMinFreePsram()}.label("type", "min-free").label("memory", "psram").label("unit", "bytes"))
-        .entry(Metric::Entry{1.f * ESP.getMaxAllocPsram()}.label("type", "max-alloc").label("memory", "psram").label("unit", "bytes"))
-        
-        .entry(Metric::Entry{1.f * ESP.getSketchSize()}.label("md5", ESP.getSketchMD5()).label("type", "size").label("memory", "sketch").label("unit", "bytes"))
-        .entry(Metric::Entry{1.f * ESP.getFreeSketchSpace()}.label("type", "free").label("memory", "sketch").label("unit", "bytes"))
-        .toString();
-
-    response += Metric{"chip", "Chip Info", "gauge"}
-        .entry(Metric::Entry{0.f}
-            .label("cores", String(ESP.getChipCores()))
-            .label("model", String(ESP.getChipModel()))
-            .label("revision", String(ESP.getChipRevision()))
-            .label("frequency_MHz", String(ESP.getCpuFreqMHz()))
-        ).toString();
-
-    Metric wifiMetric = Metric{"wifi", "WiFi Info", "gauge"}
-        .entry(Metric::Entry{0.f}
-            .label("connected", String(WiFi.isConnected()))
-        );
-    if(WiFi.isConnected()) {
-        response += Metric{"wifi_rssi", "WiFi RSSI", "gauge"}
-            .entry(Metric::Entry{static_cast<float>(WiFi.RSSI())}
-                .label("ssid", WiFi.SSID())
-                .label("channel", String(WiFi.channel()))
-            )
-            .toString();
-        wifiMetric.entries.back()
-            .label("ssid", WiFi.SSID())
-            .label("channel", String(WiFi.channel()))
-            .label("ip", WiFi.localIP().toString())
-            .label("gateway", WiFi.gatewayIP().toString())
-            .label("subnet", WiFi.subnetMask().toString())
-            .label("dns", WiFi.dnsIP().toString())
-            .label("hostname", WiFi.getHostname())
-            .label("mac", WiFi.macAddress())
-            .label("bssid", WiFi.BSSIDstr());
-    }
-
-    response += wifiMetric.toString();
-
-
-    response += Metric{"uptime", "ESP32 uptime", "gauge"}
-        .entry(Metric::Entry{UPTIME}.label("unit", "seconds"))
-        .toString();
-    esp_reset_reason_t reason = esp_reset_reason();
-    response += Metric{"reset_reason", "ESP32 reset reason", "gauge"}
-        .entry(Metric::Entry{static_cast<float>(reason)}
-            .label("reason", String(resetReasonName(reason)))
-        ).toString();
-    response += Metric{"cpu_temperature", "ESP32 CPU temperature", "gauge"}
-        .entry(Metric::Entry{temperatureRead()}
-            .label("unit", String("celsius"))
-        ).toString();
-    for(const MetricPopulator &metricPopulator: metricPopulators) {
-        response += metricPopulator().toString();
-    }
-    www.send(200, METRICS_CONTENT_TYPE, response);
+    xSemaphoreTake(registryLock, portMAX_DELAY);
+    for (int i = 0; i < familyCount; i++) {
+        if (families[i].collect && families[i].refresh == 0) { families[i].collect(families[i]); families[i].scraped = true; }
+        write(families[i]);
+    }
+    xSemaphoreGive(registryLock);
+    flush(true);
+
+    // entries are only ever added, so one stays valid while the lock is let go for its populator to run
+    xSemaphoreTake(populatorLock, portMAX_DELAY);
+    for(const Populator &populator: metricPopulators) {
+        if (populator.refresh == 0) {
+            xSemaphoreGive(populatorLock);
+            www.sendContent(populator.populate().toString());
+            xSemaphoreTake(populatorLock, portMAX_DELAY);
+            continue;
+        }
+        if (populator.text.length() > 0) www.sendContent(populator.text);
+    }
+    xSemaphoreGive(populatorLock);
+    www.sendContent("");
+}
+
+TaskHandle_t _metricsCollectTask = NULL;
+void metricsCollectTask(void *parameter) {
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        MetricsPlugin::HeapScope heapScope(HEAP_TAG_METRICS);
+        metricsPlugin.collect();
+    }
+}
+
+// started by the first family or populator collected in the background, which can be before init()
+void MetricsPlugin::startCollect() {
+    if (_metricsCollectTask != NULL) return;
+    if (populatorLock == NULL) populatorLock = xSemaphoreCreateMutex();
+    VLF("MSG: Metrics, starting collector FreeRTOS task (priority 1)");
+    xTaskCreatePinnedToCore(metricsCollectTask, "MetricsCollTask", 4000, NULL, 1, &_metricsCollectTask, 0);
+}
+
+// runs the collectors and populators that are due, a collector updates the family's values in place
+// and then they are published for the scrape together, populators make their text before it replaces the last
+void MetricsPlugin::collect() {
+    for (int i = 0; i < familyCount; i++) {
+        Family &family = families[i];
+        if (family.refresh == 0 || millis() - family.lastRefresh < family.refresh) continue;
+        family.lastRefresh = millis();
+        family.collect(family);
+
+        portENTER_CRITICAL(&family.lock);
+        memcpy(family.published, family.values, family.seriesMax*sizeof(Family::Value));
+        if (family.labelCount > 0) memcpy(family.publishedLabels, family.labelValues, family.seriesMax*family.labelCount*sizeof(const char *));
+        family.publishedCount = family.seriesCount;
+        portEXIT_CRITICAL(&family.lock);
+    }
+
+    xSemaphoreTake(populatorLock, portMAX_DELAY);
+    for (Populator &populator: metricPopulators) {
+        if (populator.refresh == 0 || millis() - populator.last < populator.refresh) continue;
+        populator.last = millis();
+        xSemaphoreGive(populatorLock);
+        String text = populator.populate().toString();
+        xSemaphoreTake(populatorLock, portMAX_DELAY);
+        populator.text = std::move(text);
+    }
+    xSemaphoreGive(populatorLock);
 }
 
 
@@ -158,51 +582,34 @@ MetricsPlugin::Metric::Entry &MetricsPlugin::Metric::Entry::label(const String &
 
 #ifdef __HAS_GPS_METRICS
 void MetricsPlugin::initGpsMetrics(TinyGPSPlus &gps) {
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_fix", "GPS (1: valid fix)", "gauge"}
-      .entry(MetricsPlugin::Metric::Entry{gps.location.isValid() && gps.date.isValid() ? 1.f : 0.f}
-    );
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_longitude", "GPS Longitude", "gauge"}
-      .entry(MetricsPlugin::Metric::Entry{static_cast<float>(gps.location.lng())});
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_latitude", "GPS Latitude", "gauge"}
-      .entry(MetricsPlugin::Metric::Entry{static_cast<float>(gps.location.lat())});
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_satellites", "GPS Satellites", "gauge"}
-      .entry(MetricsPlugin::Metric::Entry{static_cast<float>(gps.satellites.value())});
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_epoch", "GPS Epoch", "counter"}
-      .entry(MetricsPlugin::Metric::Entry{static_cast<float>(getUnixTimestampUTC(gps.date, gps.time))});
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_chars_processed", "GPS chars processed", "counter"}
-      .entry(
-        MetricsPlugin::Metric::Entry{static_cast<float>(gps.charsProcessed())}
-      );
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_sentences_with_fix", "GPS sentences with fix", "counter"}
-      .entry(
-        MetricsPlugin::Metric::Entry{static_cast<float>(gps.sentencesWithFix())}
-      );
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_sentences_passed_checksum", "GPS sentences passed checksum", "counter"}
-      .entry(
-        MetricsPlugin::Metric::Entry{static_cast<float>(gps.passedChecksum())}
-      );
-  });
-  addMetricPopulator([&gps](){
-    return MetricsPlugin::Metric{"gps_sentences_failed_checksum", "GPS sentences failed checksum", "counter"}
-      .entry(
-        MetricsPlugin::Metric::Entry{static_cast<float>(gps.failedChecksum())}
-      );
-  });
+  // read in the background once a second, so a scrape doesn't wait on the GPS object
+  addFamily("gps_fix", "GPS (1: valid fix)", "gauge", {}, 1, [&gps](Family &f) {
+    f.set(0, gps.location.isValid() && gps.date.isValid() ? 1.f : 0.f);
+  }, 1000);
+  addFamily("gps_longitude", "GPS Longitude", "gauge", {}, 1, [&gps](Family &f) {
+    f.set(0, gps.location.lng());
+  }, 1000);
+  addFamily("gps_latitude", "GPS Latitude", "gauge", {}, 1, [&gps](Family &f) {
+    f.set(0, gps.location.lat());
+  }, 1000);
+  addFamily("gps_satellites", "GPS Satellites", "gauge", {}, 1, [&gps](Family &f) {
+    f.set(0, static_cast<float>(gps.satellites.value()));
+  }, 1000);
+  addFamily("gps_epoch", "GPS Epoch", "counter", {}, 1, [&gps](Family &f) {
+    f.setInteger(0, getUnixTimestampUTC(gps.date, gps.time));
+  }, 1000);
+  addFamily("gps_chars_processed", "GPS chars processed", "counter", {}, 1, [&gps](Family &f) {
+    f.setInteger(0, gps.charsProcessed());
+  }, 1000);
+  addFamily("gps_sentences_with_fix", "GPS sentences with fix", "counter", {}, 1, [&gps](Family &f) {
+    f.setInteger(0, gps.sentencesWithFix());
+  }, 1000);
+  addFamily("gps_sentences_passed_checksum", "GPS sentences passed checksum", "counter", {}, 1, [&gps](Family &f) {
+    f.setInteger(0, gps.passedChecksum());
+  }, 1000);
+  addFamily("gps_sentences_failed_checksum", "GPS sentences failed checksum", "counter", {}, 1, [&gps](Family &f) {
+    f.setInteger(0, gps.failedChecksum());
+  }, 1000);
 }
 #endif
 
@@ -2,6 +2,8 @@
 #pragma once
 #include <Arduino.h>
 #include <list>
+#include <functional>
+#include <initializer_list>
 #include "../../Common.h"
 
 #define HAS_METRICS_PLUGIN
@@ -15,6 +17,89 @@
 #define METRICS_PLUGIN_PATH "/metrics"
 #endif
 
+// most metric families the registry holds
+#ifndef METRICS_FAMILIES_MAX
+#define METRICS_FAMILIES_MAX 64
+#endif
+
+// most distinct label names across all families, and most labels in one family
+#define METRICS_LABEL_NAMES_MAX 48
+#define METRICS_FAMILY_LABELS_MAX 10
+
+// most histogram buckets (not counting +Inf) and observations kept per summary series for its quantiles
+#define METRICS_HISTOGRAM_BOUNDS_MAX 16
+#define METRICS_SUMMARY_SAMPLES 64
+
+// most OnTask jobs timed and FreeRTOS tasks reported
+#define METRICS_JOBS_MAX 16
+#define METRICS_TASKS_MAX 32
+
+// most LX200 command channels, and distinct commands (two letter prefixes across the channels) reported,
+// commands beyond that aren't recorded
+#define METRICS_COMMAND_CHANNELS_MAX 4
+#define METRICS_COMMANDS_MAX 64
+
+// the response is streamed, text is sent to the client each time this much has been formatted
+#ifndef METRICS_CHUNK_SIZE
+#define METRICS_CHUNK_SIZE 1024
+#endif
+
+// on-device history of selected values at 1s, 1min and 10min resolution, served at METRICS_PLUGIN_PATH/range
+#ifndef METRICS_HISTORY
+#define METRICS_HISTORY ON
+#endif
+#ifndef METRICS_HISTORY_SERIES_MAX
+#define METRICS_HISTORY_SERIES_MAX 8
+#endif
+// points held at each resolution, 1 hour, 24 hours and 7 days (in PSRAM, an eighth of this without it)
+#define METRICS_HISTORY_POINTS {3600, 1440, 1008}
+
+// push the registry to a listener over UDP every METRICS_PUSH_INTERVAL ms, OFF, METRICS_PUSH_STATSD
+// (gauges with DogStatsD tags) or METRICS_PUSH_INFLUX (InfluxDB line protocol)
+#define METRICS_PUSH_STATSD 1
+#define METRICS_PUSH_INFLUX 2
+#ifndef METRICS_PUSH
+#define METRICS_PUSH OFF
+#endif
+#ifndef METRICS_PUSH_HOST
+#define METRICS_PUSH_HOST "192.168.0.2"      // IPv4 address of the listener
+#endif
+#ifndef METRICS_PUSH_PORT
+#define METRICS_PUSH_PORT 8125
+#endif
+#ifndef METRICS_PUSH_INTERVAL
+#define METRICS_PUSH_INTERVAL 10000
+#endif
+// largest datagram sent (below a 1500 byte MTU less the IP and UDP headers) and longest line
+#define METRICS_PUSH_DATAGRAM_SIZE 1400
+#define METRICS_PUSH_LINE_SIZE 256
+
+// attribute live heap allocations to plugins, the allocator only calls the hooks this needs when
+// CONFIG_HEAP_USE_HOOKS is set in the ESP-IDF configuration (a custom sdkconfig, the Arduino core leaves it off)
+#ifndef METRICS_HEAP_TRACKING
+#define METRICS_HEAP_TRACKING OFF
+#endif
+// most live allocations tracked at once (a power of two, in internal RAM at 12 bytes each), beyond
+// three quarters of this they are counted as untracked
+#ifndef METRICS_HEAP_TRACKING_SLOTS
+#define METRICS_HEAP_TRACKING_SLOTS 512
+#endif
+// most tasks in a HeapScope at once
+#define METRICS_HEAP_TASKS_MAX 8
+
+// who heap allocations are attributed to
+#define HEAP_TAG_OTHER   0
+#define HEAP_TAG_WEBSITE 1
+#define HEAP_TAG_METRICS 2
+#define HEAP_TAG_BLE     3
+#define HEAP_TAG_GAMEPAD 4
+#define HEAP_TAG_COUNT   5
+
+// how a family holds its values
+#define KIND_VALUE     0
+#define KIND_HISTOGRAM 1
+#define KIND_SUMMARY   2
+
 class MetricsPlugin{
 public:
   void init();
@@ -24,7 +109,137 @@ public:
   void initGpsMetrics(TinyGPSPlus &gps);
 #endif
 
+// A metric family with a fixed set of label names and a fixed number of series. Storage for the
+// series is allocated once when the family is added and the values are then updated in place, so
+// a scrape only formats them. Label values are pointers to strings owned by the caller which must
+// stay valid (typically literals or static buffers).
+class Family {
+public:
+    // set the value of a series, series must be less than capacity()
+    inline void set(int series, double value) { values[series].real = value; values[series].whole = false; }
+    // set the value of a series that counts whole things, it is kept as a 64 bit integer so it stays exact
+    inline void setInteger(int series, uint64_t value) { values[series].integer = value; values[series].whole = true; }
+    // set the value of a label of a series, label is its position in the names the family was added with
+    inline void label(int series, int label, const char *value) { labelValues[series*labelCount + label] = value; }
+    // number of series exposed, from 0 to capacity() (all of them initially)
+    inline void setCount(int count) { seriesCount = count < 0 ? 0 : (count > seriesMax ? seriesMax : count); }
+    inline int count() const { return seriesCount; }
+    inline int capacity() const { return seriesMax; }
+
+    // record an observation in a histogram or summary series, this can be called from any task or from an
+    // interrupt handler that isn't IRAM_ATTR (it runs from flash, see observe() in MetricsPlugin.cpp)
+    void observe(int series, double value);
+
+private:
+    friend class MetricsPlugin;
+    struct Value {
+        union { double real; uint64_t integer; };
+        bool whole;
+    };
+
+    const char *name;
+    const char *help;
+    const char *type;
+    uint8_t kind;
+    uint8_t labelCount;
+    uint8_t labelNames[METRICS_FAMILY_LABELS_MAX];   // indexes into the interned label names
+    int seriesMax;
+    int seriesCount;
+    const char **labelValues;
+    std::function<void(Family &)> collect;
+    bool scraped;              // collected by the scrape at least once, until then push leaves it out
+
+    // collected in the background, the values and label values as last published for the scrape to read
+    unsigned long refresh;     // in ms, 0 if collected by the scrape
+    unsigned long lastRefresh;
+    Value *published;
+    const char **publishedLabels;
+    int publishedCount;
+
+    // the number of series to expose and a copy of one of them, as published if collected in the background
+    int exposed();
+    void read(int series, Value &value, const char **labels);
+
+    // gauges and counters
+    Value *values;
+
+    // histograms and summaries, observations are recorded under a spinlock held for a few instructions
+    const double *bounds;      // histogram bucket upper bounds
+    uint8_t boundCount;
+    uint64_t *counts;          // histograms: per series observations in each bucket (not cumulative) and above the last
+                               // summaries: per series observations
+    double *sums;              // per series sum of the observations
+    double *samples;           // summaries: per series the last METRICS_SUMMARY_SAMPLES observations
+    uint16_t *sampleNext;
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+// called just before each scrape to bring a family's values up to date
+using Collector = std::function<void(Family &)>;
 
+// add a metric family with the given label names and number of series, returns NULL if the registry
+// is full or out of memory, name, help, type and label names must be literals (they are not copied)
+// given a refresh interval in ms the collector instead runs that often in a background task and a scrape
+// reads the values it last published, for collectors that are slow or do I/O (it must be safe to call from
+// another task, and not share label buffers with a family collected by the scrape)
+Family *addFamily(const char *name, const char *help, const char *type,
+                  std::initializer_list<const char *> labels = {}, int series = 1, const Collector &collect = nullptr,
+                  unsigned long refreshMs = 0);
+
+// add a histogram family, bounds are the bucket upper bounds in increasing order (up to METRICS_HISTOGRAM_BOUNDS_MAX)
+// and must stay valid, a +Inf bucket is added, exposed as name_bucket, name_sum and name_count
+Family *addHistogram(const char *name, const char *help, std::initializer_list<const char *> labels, int series,
+                     const double *bounds, int boundCount);
+
+// add a summary family, the 0.5, 0.9 and 0.99 quantiles are of the last METRICS_SUMMARY_SAMPLES observations
+// of each series, the sum and count are of all of them
+Family *addSummary(const char *name, const char *help, std::initializer_list<const char *> labels = {}, int series = 1);
+
+// add an OnTask job to be timed, period is the one it was added to tasks with, returns the job or -1 if the table is full
+int addJob(const char *name, unsigned long periodMs);
+
+// times one run of a job, create one at the start of the job's callback and it records the run when it goes out of scope:
+//   static void bleWrapper() { MetricsPlugin::JobTimer timer(bleJob); bluetoothBle.loop(); }
+class JobTimer {
+public:
+    JobTimer(int job) : job(job), start(micros()) {}
+    ~JobTimer();
+private:
+    int job;
+    unsigned long start;
+};
+
+// attributes what this task allocates while it's in scope to a plugin (until freed, by any task), scopes nest:
+//   void Website::poll() { MetricsPlugin::HeapScope scope(HEAP_TAG_WEBSITE); www.handleClient(); }
+class HeapScope {
+public:
+#if METRICS_HEAP_TRACKING == ON
+    HeapScope(uint8_t tag);
+    ~HeapScope();
+private:
+    int slot;
+    uint8_t previous;
+#else
+    HeapScope(uint8_t tag) { (void)tag; }
+#endif
+};
+
+// add an LX200 command channel to report, name must be a literal, returns the channel or -1 if there's no room
+int addCommandChannel(const char *name);
+
+// record a command on a channel by its two letter prefix, the time to its reply (or to giving up) and
+// whether the reply timed out
+void commandDone(int channel, const char *command, unsigned long us, bool timedOut);
+
+// record bytes a channel discarded, flushed before a command or dropped when its buffer was full
+void commandDiscarded(int channel, int bytes);
+
+// keep a history of a value sampled once a second by a background task, read must be safe to call from
+// any task and return NAN when the value isn't known, name must be a literal, returns false if there is no room
+bool addHistory(const char *name, const std::function<double()> &read);
+
+// Metrics built from scratch on each scrape, simpler to write but each allocates its labels and text
+// every time, prefer addFamily() for anything scraped regularly
 struct Metric {
     String name;
     String help;
@@ -41,14 +256,127 @@ struct Metric {
     Metric &entry(const Metric::Entry &entry);
 };
 
+// given a refresh interval in ms the populator runs that often in the background task and a scrape sends
+// the text it last made
 using MetricPopulator = std::function<Metric()>;
-void addMetricPopulator(const MetricPopulator &metricPopulator) {
-    metricPopulators.push_back(metricPopulator);
+void addMetricPopulator(const MetricPopulator &metricPopulator, unsigned long refreshMs = 0) {
+    if (populatorLock == NULL) populatorLock = xSemaphoreCreateMutex();
+    xSemaphoreTake(populatorLock, portMAX_DELAY);
+    metricPopulators.push_back({metricPopulator, refreshMs, millis() - refreshMs, String()});
+    xSemaphoreGive(populatorLock);
+    if (refreshMs > 0) startCollect();
 }
 
+// what each background task does when it wakes: runs the collectors and populators that are due, samples
+// the history and pushes the registry, called by the tasks (or by a host build, which has none)
+void collect();
+void sampleHistory();
+void push();
+
 private:
+    void initSystemMetrics();
+    void initTaskMetrics();
+    void initHeapMetrics();
+    void updateTasks();
+    void initHistory();
+    void handleRange();
+    friend void metricsHistoryTask(void *parameter);
+    void initPush();
+    void pushSeries(const Family &family, const char *const *labels, const char *suffix, bool whole, uint64_t integer, double real);
+    void pushSend();
+    friend void metricsPushTask(void *parameter);
+    void startCollect();
+    friend void metricsCollectTask(void *parameter);
+
+    // held while the populator list is added to or walked and while the text of a populator collected in the
+    // background is replaced or sent, but not while a populator runs
+    SemaphoreHandle_t populatorLock = NULL;
+
+    // held while collectors run and values are read, by the scrape and the push task
+    SemaphoreHandle_t registryLock = NULL;
+
+    struct HistoryRing {
+        float *points;
+        int size;
+        int count;                 // points held, up to size
+        int head;                  // index of the next point to write
+        uint32_t last;             // uptime in seconds at the end of the newest point's interval
+    };
+    struct History {
+        const char *name;
+        std::function<double()> read;
+        HistoryRing rings[3];      // 1 second, 1 minute and 10 minute points
+        double sum[2];             // running sums and counts toward the next 1 minute and 10 minute points
+        int count[2];
+        int samples[2];            // samples (seconds or minutes) so far toward them, known or not
+    };
+    History history[METRICS_HISTORY_SERIES_MAX];
+    volatile int historyCount = 0;
+    portMUX_TYPE historyLock = portMUX_INITIALIZER_UNLOCKED;
+    static void historyPush(HistoryRing &ring, float value, uint32_t time);
+
+    struct Command {
+        uint8_t channel;
+        char name[4];
+        uint32_t timeouts;
+    };
+    Command commands[METRICS_COMMANDS_MAX];
+    int commandCount = 0;
+    const char *channelNames[METRICS_COMMAND_CHANNELS_MAX];
+    uint64_t channelDiscarded[METRICS_COMMAND_CHANNELS_MAX];
+    int channelCount = 0;
+    Family *commandLatency = NULL;
+    portMUX_TYPE commandLock = portMUX_INITIALIZER_UNLOCKED;
+
+    struct Job {
+        const char *name;
+        unsigned long period;      // in us
+        unsigned long lastStart;   // micros() at the start of the last run
+        uint32_t runs;
+        uint32_t overruns;         // runs that took longer than the period or started a period or more late
+        uint64_t runtime;          // in us
+        unsigned long runtimeMax;  // in us
+        unsigned long jitterMax;   // largest difference between the period and the time from one run to the next in us
+    };
+    Job jobs[METRICS_JOBS_MAX];
+    int jobCount = 0;
+    portMUX_TYPE jobLock = portMUX_INITIALIZER_UNLOCKED;
+
+    struct TaskEntry {
+        TaskHandle_t handle;
+        char name[configMAX_TASK_NAME_LEN];
+        char core[4];
+        uint32_t lastCounter;      // last run time counter seen, it's 32 bits and wraps
+        uint64_t runtime;          // in run time counter units (us)
+        uint32_t stackFree;        // high water mark in bytes
+    };
+    TaskEntry *taskTable = NULL;
+    TaskEntry *taskSpare = NULL;       // the table from the previous update while the new one is built
+    int taskCount = 0;
+    TaskStatus_t *taskStatus = NULL;   // buffer for uxTaskGetSystemState()
+    float coreLoad[portNUM_PROCESSORS];
+    uint32_t lastIdle[portNUM_PROCESSORS];
+    int64_t lastTaskUpdate = 0;
+    int internLabel(const char *name);
+    Family *add(const char *name, const char *help, const char *type, uint8_t kind,
+                std::initializer_list<const char *> labels, int series);
+    void write(Family &family);
+    void writeSeries(const Family &family, const char *const *labels, const char *suffix, const char *extraLabel, const char *extraValue, const char *value);
+    void flush(bool force = false);
+
     String response;
-    std::list<MetricPopulator> metricPopulators;
+    struct Populator {
+        MetricPopulator populate;
+        unsigned long refresh;     // in ms, 0 if run by the scrape
+        unsigned long last;
+        String text;
+    };
+    std::list<Populator> metricPopulators;
+
+    Family families[METRICS_FAMILIES_MAX];
+    int familyCount = 0;
+    const char *labelNames[METRICS_LABEL_NAMES_MAX];
+    int labelNameCount = 0;
 };
 
 extern MetricsPlugin metricsPlugin;
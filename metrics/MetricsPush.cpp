@@ -0,0 +1,151 @@
+// Metrics plugin, pushes the registry to a StatsD or InfluxDB listener over UDP
+#include "MetricsPlugin.h"
+
+#if METRICS_PUSH != OFF
+
+#include <lwip/sockets.h>
+
+// lines are gathered into one datagram until the next wouldn't fit, so nothing is allocated per push
+static char pushBuffer[METRICS_PUSH_DATAGRAM_SIZE];
+static int pushLength = 0;
+static int pushSocket = -1;
+static struct sockaddr_in pushAddress;
+static uint32_t pushSent = 0;
+static uint32_t pushDropped = 0;
+
+TaskHandle_t _metricsPushTask;
+void metricsPushTask(void *parameter) {
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(METRICS_PUSH_INTERVAL));
+        MetricsPlugin::HeapScope heapScope(HEAP_TAG_METRICS);
+        metricsPlugin.push();
+    }
+}
+
+void MetricsPlugin::initPush() {
+    memset(&pushAddress, 0, sizeof(pushAddress));
+    pushAddress.sin_family = AF_INET;
+    pushAddress.sin_port = htons(METRICS_PUSH_PORT);
+    if (inet_aton(METRICS_PUSH_HOST, &pushAddress.sin_addr) == 0) { DLF("WRN: Metrics, push host must be an IPv4 address"); return; }
+    pushSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (pushSocket < 0) { DLF("WRN: Metrics, push socket not available"); return; }
+
+    addFamily("metrics_push_datagrams", "Datagrams pushed", "counter", {"result"}, 2, [](Family &f) {
+        f.label(0, 0, "sent");
+        f.setInteger(0, pushSent);
+        f.label(1, 0, "dropped");
+        f.setInteger(1, pushDropped);
+    });
+
+    VLF("MSG: Metrics, starting push FreeRTOS task (priority 1)");
+    xTaskCreatePinnedToCore(metricsPushTask, "MetricsPushTask", 4000, NULL, 1, &_metricsPushTask, 0);
+}
+
+// appends text to a line, in label values characters the format can't carry are escaped (InfluxDB)
+// or replaced (StatsD), returns false if the line is full
+static bool append(char *line, int &length, const char *text, bool labelValue = false) {
+    for (; *text; text++) {
+        char c = *text;
+        if (c == '\n') c = ' ';
+        if (labelValue) {
+          #if METRICS_PUSH == METRICS_PUSH_INFLUX
+            if (c == ',' || c == '=' || c == ' ') {
+                if (length >= METRICS_PUSH_LINE_SIZE - 1) return false;
+                line[length++] = '\\';
+            }
+          #else
+            if (c == ',' || c == '|') c = '_';
+          #endif
+        }
+        if (length >= METRICS_PUSH_LINE_SIZE - 1) return false;
+        line[length++] = c;
+    }
+    return true;
+}
+
+// formats one series as a line, a label whose value is NULL or empty is left out and values that
+// aren't finite aren't sent since neither format has a way to give them
+void MetricsPlugin::pushSeries(const Family &family, const char *const *labels, const char *suffix, bool whole, uint64_t integer, double real) {
+    char value[24];
+    if (whole) snprintf(value, sizeof(value), "%llu", (unsigned long long)integer); else {
+        if (!isfinite(real)) return;
+        snprintf(value, sizeof(value), "%.9g", real);
+    }
+
+    char line[METRICS_PUSH_LINE_SIZE];
+    int length = 0;
+    bool fits = append(line, length, family.name) && append(line, length, suffix);
+  #if METRICS_PUSH == METRICS_PUSH_INFLUX
+    // name,label=value,... value=1.5 (whole values as integers, value=12i)
+    for (int j = 0; j < family.labelCount && fits; j++) {
+        const char *labelValue = labels[j];
+        if (labelValue == NULL || labelValue[0] == 0) continue;
+        fits = append(line, length, ",") && append(line, length, labelNames[family.labelNames[j]]) &&
+               append(line, length, "=") && append(line, length, labelValue, true);
+    }
+    fits = fits && append(line, length, " value=") && append(line, length, value) && (!whole || append(line, length, "i"));
+  #else
+    // name:1.5|g|#label:value,... (counters too are sent as gauges since they are totals, not increments)
+    fits = fits && append(line, length, ":") && append(line, length, value) && append(line, length, "|g");
+    bool first = true;
+    for (int j = 0; j < family.labelCount && fits; j++) {
+        const char *labelValue = labels[j];
+        if (labelValue == NULL || labelValue[0] == 0) continue;
+        fits = append(line, length, first ? "|#" : ",") && append(line, length, labelNames[family.labelNames[j]]) &&
+               append(line, length, ":") && append(line, length, labelValue, true);
+        first = false;
+    }
+  #endif
+    if (!fits) return;
+    line[length++] = '\n';
+
+    if (pushLength + length > METRICS_PUSH_DATAGRAM_SIZE) pushSend();
+    memcpy(&pushBuffer[pushLength], line, length);
+    pushLength += length;
+}
+
+// sends the lines gathered, a datagram the network stack can't take right away is dropped rather than waited on
+void MetricsPlugin::pushSend() {
+    if (pushLength == 0) return;
+    if (sendto(pushSocket, pushBuffer, pushLength, MSG_DONTWAIT, (struct sockaddr *)&pushAddress, sizeof(pushAddress)) < 0) pushDropped++; else pushSent++;
+    pushLength = 0;
+}
+
+// histograms and summaries are pushed as their _count and _sum, the buckets and quantiles are only scraped;
+// the collectors aren't run, their side effects (state polling, the cpu_load interval) belong to the scrape,
+// so a family collected by the scrape is pushed as last scraped and one collected in the background as published
+void MetricsPlugin::push() {
+    pushLength = 0;
+    xSemaphoreTake(registryLock, portMAX_DELAY);
+    for (int i = 0; i < familyCount; i++) {
+        Family &family = families[i];
+        if (family.collect && family.refresh == 0 && !family.scraped) continue;
+
+        int exposed = family.exposed();
+        for (int j = 0; j < exposed; j++) {
+            const char *labels[METRICS_FAMILY_LABELS_MAX];
+            if (family.kind == KIND_VALUE) {
+                Family::Value v;
+                family.read(j, v, labels);
+                pushSeries(family, labels, "", v.whole, v.integer, v.real);
+            } else {
+                if (family.labelCount > 0) memcpy(labels, &family.labelValues[j*family.labelCount], family.labelCount*sizeof(const char *));
+                uint64_t count = 0;
+                double sum;
+                portENTER_CRITICAL(&family.lock);
+                if (family.kind == KIND_HISTOGRAM) {
+                    for (int k = 0; k <= family.boundCount; k++) count += family.counts[j*(family.boundCount + 1) + k];
+                } else count = family.counts[j];
+                sum = family.sums[j];
+                portEXIT_CRITICAL(&family.lock);
+                pushSeries(family, labels, "_count", true, count, 0.0);
+                pushSeries(family, labels, "_sum", false, 0, sum);
+            }
+        }
+    }
+    xSemaphoreGive(registryLock);
+    pushSend();
+}
+
+#endif
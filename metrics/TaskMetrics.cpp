@@ -0,0 +1,167 @@
+// Metrics plugin, OnTask job and FreeRTOS task metrics
+#include "MetricsPlugin.h"
+
+// OnTask jobs only report if they are timed with a JobTimer, FreeRTOS tasks need the trace facility
+// and run time stats (both on in the Arduino ESP32 builds) to report
+
+int MetricsPlugin::addJob(const char *name, unsigned long periodMs) {
+    if (jobCount >= METRICS_JOBS_MAX) { DF("WRN: Metrics, can't add job "); DL(name); return -1; }
+    Job &job = jobs[jobCount];
+    memset(&job, 0, sizeof(Job));
+    job.name = name;
+    job.period = periodMs*1000UL;
+    return jobCount++;
+}
+
+MetricsPlugin::JobTimer::~JobTimer() {
+    if (job < 0) return;
+    unsigned long runtime = micros() - start;
+
+    Job &j = metricsPlugin.jobs[job];
+    portENTER_CRITICAL(&metricsPlugin.jobLock);
+    bool overrun = runtime > j.period;
+    if (j.runs > 0) {
+        unsigned long interval = start - j.lastStart;
+        unsigned long jitter = interval > j.period ? interval - j.period : j.period - interval;
+        if (jitter > j.jitterMax) j.jitterMax = jitter;
+        if (interval >= 2*j.period) overrun = true;
+    }
+    if (overrun) j.overruns++;
+    j.lastStart = start;
+    j.runs++;
+    j.runtime += runtime;
+    if (runtime > j.runtimeMax) j.runtimeMax = runtime;
+    portEXIT_CRITICAL(&metricsPlugin.jobLock);
+}
+
+void MetricsPlugin::initTaskMetrics() {
+    // job values are copied under the lock so a run ending meanwhile can't tear them
+    addFamily("ontask_job_runs", "OnTask job runs", "counter", {"job"}, METRICS_JOBS_MAX, [this](Family &f) {
+        f.setCount(jobCount);
+        for (int i = 0; i < jobCount; i++) {
+            portENTER_CRITICAL(&jobLock);
+            uint32_t runs = jobs[i].runs;
+            portEXIT_CRITICAL(&jobLock);
+            f.label(i, 0, jobs[i].name);
+            f.setInteger(i, runs);
+        }
+    });
+    addFamily("ontask_job_runtime_seconds", "OnTask job total run time", "counter", {"job"}, METRICS_JOBS_MAX, [this](Family &f) {
+        f.setCount(jobCount);
+        for (int i = 0; i < jobCount; i++) {
+            portENTER_CRITICAL(&jobLock);
+            uint64_t runtime = jobs[i].runtime;
+            portEXIT_CRITICAL(&jobLock);
+            f.label(i, 0, jobs[i].name);
+            f.set(i, runtime/1000000.0);
+        }
+    });
+    addFamily("ontask_job_runtime_max_seconds", "OnTask job longest run", "gauge", {"job"}, METRICS_JOBS_MAX, [this](Family &f) {
+        f.setCount(jobCount);
+        for (int i = 0; i < jobCount; i++) { f.label(i, 0, jobs[i].name); f.set(i, jobs[i].runtimeMax/1000000.0); }
+    });
+    addFamily("ontask_job_jitter_max_seconds", "OnTask job largest difference between its period and the time between runs", "gauge",
+              {"job"}, METRICS_JOBS_MAX, [this](Family &f) {
+        f.setCount(jobCount);
+        for (int i = 0; i < jobCount; i++) { f.label(i, 0, jobs[i].name); f.set(i, jobs[i].jitterMax/1000000.0); }
+    });
+    addFamily("ontask_job_overruns", "OnTask job runs longer than the period or started a period or more late", "counter",
+              {"job"}, METRICS_JOBS_MAX, [this](Family &f) {
+        f.setCount(jobCount);
+        for (int i = 0; i < jobCount; i++) { f.label(i, 0, jobs[i].name); f.setInteger(i, jobs[i].overruns); }
+    });
+
+#if configUSE_TRACE_FACILITY == 1 && configGENERATE_RUN_TIME_STATS == 1
+    taskTable = (TaskEntry *)calloc(METRICS_TASKS_MAX, sizeof(TaskEntry));
+    taskSpare = (TaskEntry *)calloc(METRICS_TASKS_MAX, sizeof(TaskEntry));
+    taskStatus = (TaskStatus_t *)calloc(METRICS_TASKS_MAX, sizeof(TaskStatus_t));
+    if (taskTable == NULL || taskSpare == NULL || taskStatus == NULL) {
+        free(taskTable); taskTable = NULL;
+        free(taskSpare); taskSpare = NULL;
+        free(taskStatus); taskStatus = NULL;
+        DLF("WRN: Metrics, out of memory for task metrics");
+        return;
+    }
+    for (int i = 0; i < portNUM_PROCESSORS; i++) coreLoad[i] = 0.0F;
+
+    // the first family's collector takes the snapshot the others read from
+    addFamily("freertos_task_runtime_seconds", "FreeRTOS task total run time", "counter", {"task", "core"}, METRICS_TASKS_MAX, [this](Family &f) {
+        updateTasks();
+        f.setCount(taskCount);
+        for (int i = 0; i < taskCount; i++) {
+            f.label(i, 0, taskTable[i].name);
+            f.label(i, 1, taskTable[i].core[0] ? taskTable[i].core : NULL);
+            f.set(i, taskTable[i].runtime/1000000.0);
+        }
+    });
+    addFamily("freertos_task_stack_free", "FreeRTOS task stack high water mark", "gauge", {"task", "unit"}, METRICS_TASKS_MAX, [this](Family &f) {
+        f.setCount(taskCount);
+        for (int i = 0; i < taskCount; i++) {
+            f.label(i, 0, taskTable[i].name);
+            f.label(i, 1, "bytes");
+            f.setInteger(i, taskTable[i].stackFree);
+        }
+    });
+    static const char *coreNames[] = {"0", "1"};
+    addFamily("cpu_load", "CPU load by core since the last scrape", "gauge", {"core", "unit"}, portNUM_PROCESSORS, [this](Family &f) {
+        for (int i = 0; i < portNUM_PROCESSORS; i++) {
+            f.label(i, 0, coreNames[i]);
+            f.label(i, 1, "percent");
+            f.set(i, coreLoad[i]);
+        }
+    });
+#endif
+}
+
+// reads the state of all tasks, accumulating run time into 64 bits and the core loads from the idle tasks
+void MetricsPlugin::updateTasks() {
+#if configUSE_TRACE_FACILITY == 1 && configGENERATE_RUN_TIME_STATS == 1
+    uint32_t total;
+    int count = uxTaskGetSystemState(taskStatus, METRICS_TASKS_MAX, &total);
+    if (count == 0) { DLF("WRN: Metrics, too many tasks to report"); return; }
+
+    int64_t now = esp_timer_get_time();
+    int64_t elapsed = now - lastTaskUpdate;
+    lastTaskUpdate = now;
+
+    // keep the entries of tasks that still exist in the order reported, new tasks start from their current count
+    TaskEntry *previous = taskTable;
+    int previousCount = taskCount;
+    taskTable = taskSpare;
+    taskSpare = previous;
+    taskCount = 0;
+    for (int i = 0; i < count; i++) {
+        TaskStatus_t &status = taskStatus[i];
+        TaskEntry &entry = taskTable[taskCount++];
+
+        int j = 0;
+        while (j < previousCount && previous[j].handle != status.xHandle) j++;
+        if (j < previousCount) {
+            entry = previous[j];
+            entry.runtime += (uint32_t)(status.ulRunTimeCounter - entry.lastCounter);
+        } else {
+            memset(&entry, 0, sizeof(TaskEntry));
+            entry.handle = status.xHandle;
+            entry.runtime = status.ulRunTimeCounter;
+        }
+        entry.lastCounter = status.ulRunTimeCounter;
+        strncpy(entry.name, status.pcTaskName, sizeof(entry.name) - 1);
+        #if configTASKLIST_INCLUDE_COREID == 1
+            if (status.xCoreID < portNUM_PROCESSORS) snprintf(entry.core, sizeof(entry.core), "%d", (int)status.xCoreID);
+            else strcpy(entry.core, "any");
+        #endif
+        entry.stackFree = status.usStackHighWaterMark;
+
+        // the idle task of each core runs whenever nothing else does on it
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            if (status.xHandle != xTaskGetIdleTaskHandleForCPU(core)) continue;
+            uint32_t idle = status.ulRunTimeCounter - lastIdle[core];
+            lastIdle[core] = status.ulRunTimeCounter;
+            if (j < previousCount && elapsed > 0) {
+                float load = 100.0F*(1.0F - (float)idle/elapsed);
+                coreLoad[core] = load < 0.0F ? 0.0F : (load > 100.0F ? 100.0F : load);
+            }
+        }
+    }
+#endif
+}
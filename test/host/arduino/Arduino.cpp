@@ -0,0 +1,126 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for the Arduino core
+#include "Arduino.h"
+
+static unsigned long long clockMicros = 0;
+
+unsigned long long hostMicros() { return clockMicros; }
+void hostAdvance(unsigned long long us) { clockMicros += us; }
+
+unsigned long millis() { return (unsigned long)(clockMicros/1000ULL); }
+unsigned long micros() { return (unsigned long)clockMicros; }
+void delay(unsigned long ms) { hostAdvance(ms*1000ULL); }
+void delayMicroseconds(unsigned int us) { hostAdvance(us); }
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer) {
+  sprintf(buffer, "%*.*f", width, precision, value);
+  return buffer;
+}
+
+// a fixed seed so every run injects the same jitter and drops
+static uint32_t randomState = 0x12345678UL;
+uint32_t esp_random() {
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+// glibc's allocator is called through, counting each allocation
+extern "C" {
+  void *__libc_malloc(size_t size);
+  void *__libc_calloc(size_t n, size_t size);
+  void *__libc_realloc(void *p, size_t size);
+
+  static unsigned long allocations = 0;
+  void *malloc(size_t size) { allocations++; return __libc_malloc(size); }
+  void *calloc(size_t n, size_t size) { allocations++; return __libc_calloc(n, size); }
+  void *realloc(void *p, size_t size) { allocations++; return __libc_realloc(p, size); }
+}
+
+unsigned long hostAllocations() { return allocations; }
+
+bool hostVerbose = false;
+HostSerial Serial;
+HostEsp ESP;
+
+struct HostSemaphore {
+  bool recursive;
+  int count;
+};
+
+static SemaphoreHandle_t createSemaphore(bool recursive) {
+  SemaphoreHandle_t s = new HostSemaphore;
+  s->recursive = recursive;
+  s->count = 0;
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return createSemaphore(true); }
+SemaphoreHandle_t xSemaphoreCreateMutex() { return createSemaphore(false); }
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t ticks) {
+  (void)ticks;
+  s->count++;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s) {
+  if (s->count == 0) { fputs("host: recursive mutex given more times than taken\n", stderr); abort(); }
+  s->count--;
+  return pdTRUE;
+}
+
+// with one thread a mutex that is already held could never be given back, so waiting for it is a
+// lock order bug in the code under test and is reported as one
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+  if (s->count > 0) {
+    if (ticks == portMAX_DELAY) { fputs("host: mutex taken while already held, it would deadlock\n", stderr); abort(); }
+    return pdFALSE;
+  }
+  s->count++;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  if (s->count == 0) { fputs("host: mutex given when not held\n", stderr); abort(); }
+  s->count--;
+  return pdTRUE;
+}
+
+typedef struct HostTask {
+  char name[configMAX_TASK_NAME_LEN];
+  int core;
+} HostTask;
+
+#define HOST_TASKS_MAX 16
+static HostTask tasks[HOST_TASKS_MAX] = {{"IDLE0", 0}, {"IDLE1", 1}, {"loopTask", 1}};
+static int taskCount = 3;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack, void *parameter, int priority,
+                                   TaskHandle_t *handle, int core) {
+  (void)function; (void)stack; (void)parameter; (void)priority;
+  if (taskCount >= HOST_TASKS_MAX) { if (handle != NULL) *handle = NULL; return pdFAIL; }
+  HostTask &task = tasks[taskCount++];
+  snprintf(task.name, sizeof(task.name), "%s", name);
+  task.core = core;
+  if (handle != NULL) *handle = &task;
+  return pdPASS;
+}
+
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(UBaseType_t core) { return core < portNUM_PROCESSORS ? &tasks[core] : NULL; }
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t size, uint32_t *totalRunTime) {
+  if (size < (UBaseType_t)taskCount) return 0;
+  for (int i = 0; i < taskCount; i++) {
+    memset(&status[i], 0, sizeof(TaskStatus_t));
+    status[i].xHandle = &tasks[i];
+    status[i].pcTaskName = tasks[i].name;
+    status[i].xTaskNumber = i + 1;
+    status[i].ulRunTimeCounter = i < portNUM_PROCESSORS ? (uint32_t)hostMicros() : 0;
+    status[i].usStackHighWaterMark = 1024;
+    status[i].xCoreID = tasks[i].core;
+  }
+  if (totalRunTime != NULL) *totalRunTime = (uint32_t)hostMicros();
+  return taskCount;
+}
@@ -0,0 +1,195 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for the Arduino core, the ESP32 and FreeRTOS calls the plugins make
+#pragma once
+
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "WString.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// time is simulated: millis() and micros() read a clock that only delay() moves forward, so a run
+// gives the same timing every time and waiting on the simulated controller costs no real time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void yield() {}
+
+// advance the clock (in microseconds) as delay() does
+void hostAdvance(unsigned long long us);
+unsigned long long hostMicros();
+
+// program memory is ordinary memory
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) ((const __FlashStringHelper *)(s))
+#define FPSTR(s) ((const __FlashStringHelper *)(s))
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcat_P strcat
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define memcpy_P memcpy
+#define snprintf_P snprintf
+#define sprintf_P sprintf
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+
+#define constrain(v, low, high) ((v) < (low) ? (low) : ((v) > (high) ? (high) : (v)))
+// as the ESP32 core has them
+using std::min;
+using std::max;
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+inline bool isAlpha(int c) { return isalpha(c) != 0; }
+inline bool isSpace(int c) { return isspace(c) != 0; }
+
+char *dtostrf(double value, signed char width, unsigned char precision, char *buffer);
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return LOW; }
+
+// debug output, enabled at run time with hostVerbose
+extern bool hostVerbose;
+class HostSerial {
+  public:
+    template <typename T> void print(const T &v) { if (hostVerbose) write(String(v).c_str()); }
+    template <typename T> void println(const T &v) { if (hostVerbose) { write(String(v).c_str()); write("\n"); } }
+    void println() { if (hostVerbose) write("\n"); }
+  private:
+    void write(const char *s) { fputs(s, stderr); }
+};
+template <> inline void HostSerial::print(const bool &v) { if (hostVerbose) write(v ? "1" : "0"); }
+template <> inline void HostSerial::println(const bool &v) { if (hostVerbose) { write(v ? "1" : "0"); write("\n"); } }
+extern HostSerial Serial;
+
+// heap allocations (malloc, calloc, realloc and so operator new) made since the program started; String is a
+// std::string here, which like the ESP32's String keeps short values in place without allocating
+unsigned long hostAllocations();
+
+// ESP32 memory, the host has plenty and no PSRAM
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_8BIT     (1 << 2)
+inline void *heap_caps_malloc(size_t size, uint32_t caps) { return (caps & MALLOC_CAP_SPIRAM) ? NULL : malloc(size); }
+inline void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) { return (caps & MALLOC_CAP_SPIRAM) ? NULL : calloc(n, size); }
+inline bool psramFound() { return false; }
+uint32_t esp_random();
+
+class HostEsp {
+  public:
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getMinFreeHeap() { return 150000; }
+    uint32_t getMaxAllocHeap() { return 110000; }
+    uint32_t getHeapSize() { return 320000; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getMinFreePsram() { return 0; }
+    uint32_t getMaxAllocPsram() { return 0; }
+    uint32_t getPsramSize() { return 0; }
+    uint32_t getSketchSize() { return 1250000; }
+    uint32_t getFreeSketchSpace() { return 1310720; }
+    String getSketchMD5() { return "00000000000000000000000000000000"; }
+    uint8_t getChipCores() { return 2; }
+    const char *getChipModel() { return "ESP32-D0WD-V3"; }
+    uint8_t getChipRevision() { return 3; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart() { exit(0); }
+};
+extern HostEsp ESP;
+
+// the ESP32 system calls, uptime is the simulated clock
+inline int64_t esp_timer_get_time() { return (int64_t)hostMicros(); }
+inline float temperatureRead() { return 45.0F; }
+
+typedef enum {
+  ESP_RST_UNKNOWN, ESP_RST_POWERON, ESP_RST_EXT, ESP_RST_SW, ESP_RST_PANIC, ESP_RST_INT_WDT,
+  ESP_RST_TASK_WDT, ESP_RST_WDT, ESP_RST_DEEPSLEEP, ESP_RST_BROWNOUT, ESP_RST_SDIO
+} esp_reset_reason_t;
+inline esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+class IPAddress {
+  public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : bytes{a, b, c, d} {}
+    uint8_t operator[](int i) const { return bytes[i]; }
+  private:
+    uint8_t bytes[4];
+};
+
+// FreeRTOS, the bench runs on one thread so the locks only need to count their holder
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+typedef struct HostSemaphore *SemaphoreHandle_t;
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s);
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { static int task; return &task; }
+inline TickType_t xTaskGetTickCount() { return millis(); }
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+inline void vTaskDelayUntil(TickType_t *lastWake, TickType_t period) {
+  *lastWake += period;
+  long wait = (long)(*lastWake - xTaskGetTickCount());
+  if (wait > 0) delay(wait);
+}
+inline void taskYIELD() {}
+
+// tasks are listed but not started, the bench calls what they would run itself
+typedef void (*TaskFunction_t)(void *);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack, void *parameter, int priority,
+                                   TaskHandle_t *handle, int core);
+
+// the task list, with the trace facility and run time stats the Arduino ESP32 builds have; as nothing
+// runs in the tasks they report no run time and both cores' idle tasks all of it
+#define portNUM_PROCESSORS 2
+#define configMAX_TASK_NAME_LEN 16
+#define configUSE_TRACE_FACILITY 1
+#define configGENERATE_RUN_TIME_STATS 1
+#define configTASKLIST_INCLUDE_COREID 1
+
+typedef struct {
+  TaskHandle_t xHandle;
+  const char *pcTaskName;
+  UBaseType_t xTaskNumber;
+  int eCurrentState;
+  UBaseType_t uxCurrentPriority;
+  UBaseType_t uxBasePriority;
+  uint32_t ulRunTimeCounter;
+  void *pxStackBase;
+  uint32_t usStackHighWaterMark;
+  BaseType_t xCoreID;
+} TaskStatus_t;
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t size, uint32_t *totalRunTime);
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(UBaseType_t core);
+
+typedef struct { int count; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((mux)->count++)
+#define portEXIT_CRITICAL(mux) ((mux)->count--)
+#define portENTER_CRITICAL_SAFE(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_SAFE(mux) portEXIT_CRITICAL(mux)
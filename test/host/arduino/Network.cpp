@@ -0,0 +1,29 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for the ESP32's network stack
+#include "esp_wifi.h"
+#include "lwip/sockets.h"
+
+#include <string.h>
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap) {
+  static const uint8_t bssid[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x10};
+  memset(ap, 0, sizeof(wifi_ap_record_t));
+  memcpy(ap->bssid, bssid, sizeof(bssid));
+  strcpy((char *)ap->ssid, "host");
+  ap->primary = 6;
+  ap->rssi = -52;
+  return ESP_OK;
+}
+
+std::vector<std::string> hostDatagrams;
+
+int hostSocket(int domain, int type, int protocol) {
+  (void)domain; (void)type; (void)protocol;
+  return 3;
+}
+
+ssize_t hostSendto(int socket, const void *data, size_t size, int flags, const struct sockaddr *to, socklen_t toSize) {
+  (void)socket; (void)flags; (void)to; (void)toSize;
+  hostDatagrams.push_back(std::string((const char *)data, size));
+  return size;
+}
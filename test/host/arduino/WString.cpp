@@ -0,0 +1,94 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for the Arduino String class
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static std::string formatInteger(unsigned long long n, bool negative, unsigned char base) {
+  if (base < 2 || base > 36) base = 10;
+  char digits[72];
+  int i = sizeof(digits) - 1;
+  digits[i] = 0;
+  do { int d = n % base; digits[--i] = d < 10 ? '0' + d : 'a' + d - 10; n /= base; } while (n > 0);
+  if (negative) digits[--i] = '-';
+  return std::string(&digits[i]);
+}
+
+String::String(int n, unsigned char base) : String((long)n, base) {}
+String::String(unsigned int n, unsigned char base) : String((unsigned long)n, base) {}
+String::String(long n, unsigned char base) {
+  // like Arduino only base 10 shows a sign, other bases give the two's complement
+  if (base == 10) value = formatInteger(n < 0 ? -(unsigned long long)n : n, n < 0, base);
+  else value = formatInteger((unsigned long)n, false, base);
+}
+String::String(unsigned long n, unsigned char base) : value(formatInteger(n, false, base)) {}
+String::String(float n, unsigned char decimals) : String((double)n, decimals) {}
+String::String(double n, unsigned char decimals) {
+  char temp[64];
+  snprintf(temp, sizeof(temp), "%.*f", decimals, n);
+  value = temp;
+}
+
+bool String::equalsIgnoreCase(const String &s) const {
+  if (value.length() != s.value.length()) return false;
+  for (size_t i = 0; i < value.length(); i++) if (tolower(value[i]) != tolower(s.value[i])) return false;
+  return true;
+}
+
+bool String::endsWith(const String &s) const {
+  return value.length() >= s.value.length() && value.compare(value.length() - s.value.length(), s.value.length(), s.value) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t i = value.find(c, from);
+  return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::indexOf(const String &s, unsigned int from) const {
+  size_t i = value.find(s.value, from);
+  return i == std::string::npos ? -1 : (int)i;
+}
+
+int String::lastIndexOf(char c) const {
+  size_t i = value.rfind(c);
+  return i == std::string::npos ? -1 : (int)i;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) { unsigned int t = from; from = to; to = t; }
+  if (from >= value.length()) return String();
+  if (to > value.length()) to = value.length();
+  return String(value.substr(from, to - from));
+}
+
+void String::replace(const String &find, const String &with) {
+  if (find.value.empty()) return;
+  size_t i = 0;
+  while ((i = value.find(find.value, i)) != std::string::npos) {
+    value.replace(i, find.value.length(), with.value);
+    i += with.value.length();
+  }
+}
+
+void String::toLowerCase() { for (auto &c : value) c = tolower(c); }
+void String::toUpperCase() { for (auto &c : value) c = toupper(c); }
+
+void String::trim() {
+  size_t begin = 0, end = value.length();
+  while (begin < end && isspace((unsigned char)value[begin])) begin++;
+  while (end > begin && isspace((unsigned char)value[end - 1])) end--;
+  value = value.substr(begin, end - begin);
+}
+
+long String::toInt() const { return atol(value.c_str()); }
+float String::toFloat() const { return (float)atof(value.c_str()); }
+double String::toDouble() const { return atof(value.c_str()); }
+
+void String::toCharArray(char *buffer, unsigned int size) const {
+  if (size == 0) return;
+  strncpy(buffer, value.c_str(), size - 1);
+  buffer[size - 1] = 0;
+}
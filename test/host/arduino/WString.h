@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for the Arduino String class, the subset the plugins use
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+class __FlashStringHelper;
+
+class String {
+  public:
+    String() {}
+    String(const char *s) { if (s != NULL) value = s; }
+    String(const __FlashStringHelper *s) : String((const char *)s) {}
+    String(const std::string &s) : value(s) {}
+    explicit String(char c) : value(1, c) {}
+    explicit String(int n, unsigned char base = 10);
+    explicit String(unsigned int n, unsigned char base = 10);
+    explicit String(long n, unsigned char base = 10);
+    explicit String(unsigned long n, unsigned char base = 10);
+    explicit String(float n, unsigned char decimals = 2);
+    explicit String(double n, unsigned char decimals = 2);
+
+    inline unsigned int length() const { return value.length(); }
+    inline const char *c_str() const { return value.c_str(); }
+    inline bool reserve(unsigned int size) { value.reserve(size); return true; }
+    inline void clear() { value.clear(); }
+
+    bool concat(const String &s) { value += s.value; return true; }
+    bool concat(const char *s) { if (s != NULL) value += s; return true; }
+    bool concat(const __FlashStringHelper *s) { return concat((const char *)s); }
+    bool concat(char c) { value += c; return true; }
+    bool concat(unsigned char n) { return concat(String((unsigned int)n)); }
+    bool concat(int n) { return concat(String(n)); }
+    bool concat(unsigned int n) { return concat(String(n)); }
+    bool concat(long n) { return concat(String(n)); }
+    bool concat(unsigned long n) { return concat(String(n)); }
+    bool concat(float n) { return concat(String(n)); }
+    bool concat(double n) { return concat(String(n)); }
+
+    template <typename T> String &operator+=(const T &v) { concat(v); return *this; }
+    friend String operator+(const String &a, const String &b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const String &a, const char *b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const char *a, const String &b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const String &a, char b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const String &a, int b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const String &a, long b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const String &a, unsigned long b) { String s(a); s.concat(b); return s; }
+    friend String operator+(const String &a, double b) { String s(a); s.concat(b); return s; }
+
+    bool equals(const String &s) const { return value == s.value; }
+    bool equals(const char *s) const { return value == (s == NULL ? "" : s); }
+    bool equalsIgnoreCase(const String &s) const;
+    bool operator==(const String &s) const { return equals(s); }
+    bool operator==(const char *s) const { return equals(s); }
+    bool operator!=(const String &s) const { return !equals(s); }
+    bool operator!=(const char *s) const { return !equals(s); }
+    bool startsWith(const String &s) const { return value.compare(0, s.value.length(), s.value) == 0; }
+    bool endsWith(const String &s) const;
+
+    char charAt(unsigned int i) const { return i < value.length() ? value[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    void setCharAt(unsigned int i, char c) { if (i < value.length()) value[i] = c; }
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String &s, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const { return substring(from, value.length()); }
+    String substring(unsigned int from, unsigned int to) const;
+
+    void replace(const String &find, const String &with);
+    void remove(unsigned int index) { if (index < value.length()) value.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < value.length()) value.erase(index, count); }
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+    void toCharArray(char *buffer, unsigned int size) const;
+
+  private:
+    std::string value;
+};
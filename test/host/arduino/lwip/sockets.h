@@ -0,0 +1,19 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for lwIP's sockets, datagrams are kept for the bench to read instead of being sent
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <string>
+#include <vector>
+
+// what was sent since the bench last cleared it, one entry per datagram
+extern std::vector<std::string> hostDatagrams;
+
+int hostSocket(int domain, int type, int protocol);
+ssize_t hostSendto(int socket, const void *data, size_t size, int flags, const struct sockaddr *to, socklen_t toSize);
+
+#define socket hostSocket
+#define sendto hostSendto
@@ -0,0 +1,38 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's Common.h, the controller configuration the plugins are built against
+#pragma once
+
+#include <Arduino.h>
+
+#define STR_(x)                     #x
+#define STR(x)                      STR_(x)
+#define UNUSED(x)                   (void)(x)
+#define EmptyStr                    ""
+
+#define OFF                         -1
+#define ON                          -2
+
+#define WIFI                        1
+#define ETHERNET_W5100              2
+#define ETHERNET_W5500              3
+#define WIFI_ACCESS_POINT           1
+#define WIFI_STATION                2
+
+// auxiliary feature purposes
+#define SWITCH                      1
+#define ANALOG_OUTPUT               2
+#define DEW_HEATER                  3
+#define INTERVALOMETER              4
+#define SWITCH_UNPARKED             5
+#define MOMENTARY_SWITCH            6
+#define HIDDEN_SWITCH               7
+#define COVER_SWITCH                8
+
+#define OPERATIONAL_MODE            WIFI
+#define SERIAL_RADIO                WIFI_ACCESS_POINT
+#define SERIAL_IP_MODE              WIFI_ACCESS_POINT
+#define WEB_SERVER                  ON
+#define SERIAL_BAUD_DEFAULT         9600
+#define SERIAL_BAUD                 9600
+
+#include "lib/debug/Debug.h"
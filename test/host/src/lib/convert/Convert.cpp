@@ -0,0 +1,117 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's conversion library
+#include "Convert.h"
+
+// reads exactly digits decimal digits
+static bool readDigits(const char *&s, int digits, int *value) {
+  *value = 0;
+  for (int i = 0; i < digits; i++) {
+    if (!isdigit((unsigned char)s[i])) return false;
+    *value = *value*10 + (s[i] - '0');
+  }
+  s += digits;
+  return true;
+}
+
+bool Convert::dmsToDouble(double *f, char *dms, bool signPresent) {
+  const char *s = dms;
+  while (*s == ' ') s++;
+
+  double sign = 1.0;
+  int d, m, sec = 0;
+  if (signPresent) {
+    if (*s == '-') sign = -1.0; else if (*s != '+') return false;
+    s++;
+    if (!readDigits(s, 2, &d) || d > 90) return false;
+  } else {
+    if (!readDigits(s, 3, &d) || d > 360) return false;
+  }
+  if (*s == 0 || isdigit((unsigned char)*s)) return false;
+  s++;
+  if (!readDigits(s, 2, &m) || m > 59) return false;
+  if (*s != 0) {
+    if (isdigit((unsigned char)*s)) return false;
+    s++;
+    if (!readDigits(s, 2, &sec) || sec > 59) return false;
+    if (*s != 0) return false;
+  }
+
+  *f = sign*(d + m/60.0 + sec/3600.0);
+  return true;
+}
+
+bool Convert::hmsToDouble(double *f, char *hms) {
+  const char *s = hms;
+  while (*s == ' ') s++;
+
+  int h, m, sec = 0;
+  double fraction = 0.0;
+  if (!readDigits(s, 2, &h) || h > 23 || *s != ':') return false;
+  s++;
+  if (!readDigits(s, 2, &m) || m > 59) return false;
+  if (*s == '.') {
+    // HH:MM.M
+    if (!isdigit((unsigned char)s[1]) || s[2] != 0) return false;
+    *f = h + (m + (s[1] - '0')/10.0)/60.0;
+    return true;
+  }
+  if (*s != ':') return false;
+  s++;
+  if (!readDigits(s, 2, &sec) || sec > 59) return false;
+  if (*s == '.') {
+    char *end;
+    fraction = strtod(s, &end);
+    if (end == s + 1) return false;
+    s = end;
+  }
+  if (*s != 0) return false;
+
+  *f = h + m/60.0 + (sec + fraction)/3600.0;
+  return true;
+}
+
+void Convert::doubleToDms(char *reply, double f, bool fullRange, bool signPresent, PrecisionMode precision) {
+  const char *sign = "";
+  if (signPresent) sign = f < 0 ? "-" : "+";
+  long s = lround(fabs(f)*3600.0);
+  if (precision >= PM_HIGH) sprintf(reply, "%s%0*ld*%02ld:%02ld", sign, fullRange ? 3 : 2, s/3600, (s/60) % 60, s % 60);
+  else sprintf(reply, "%s%0*ld*%02ld", sign, fullRange ? 3 : 2, s/3600, (s/60) % 60);
+}
+
+bool Convert::atoi2(char *a, int16_t *i, bool sign) {
+  const char *s = a;
+  if (*s == '-' || *s == '+') { if (!sign) return false; s++; }
+  if (*s == 0) return false;
+  for (const char *p = s; *p; p++) if (!isdigit((unsigned char)*p)) return false;
+  long l = atol(a);
+  if (l < -32767 || l > 32767) return false;
+  *i = (int16_t)l;
+  return true;
+}
+
+void Convert::stripNumericStr(char *s, bool trailingZeros) {
+  char *digits = s;
+  if (*digits == '+' || *digits == '-') digits++;
+  char *first = digits;
+  while (first[0] == '0' && isdigit((unsigned char)first[1])) first++;
+  memmove(digits, first, strlen(first) + 1);
+
+  if (trailingZeros && strchr(s, '.') != NULL) {
+    int i = strlen(s) - 1;
+    while (i > 0 && s[i] == '0') s[i--] = 0;
+    if (s[i] == '.') s[i] = 0;
+  }
+}
+
+char *sstrcpyex(char *result, const char *source, size_t size) {
+  if (size == 0) return result;
+  strncpy(result, source, size - 1);
+  result[size - 1] = 0;
+  return result;
+}
+
+void sprintF(char *result, const char *format, double value) {
+  sprintf(result, format, value);
+}
+
+Convert convert;
@@ -0,0 +1,33 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's conversion library, the parts the plugins use
+#pragma once
+
+#include <Arduino.h>
+
+enum PrecisionMode {PM_LOWEST, PM_LOW, PM_HIGH, PM_HIGHEST};
+
+class Convert {
+  public:
+    // sDD*MM[:SS] with sign, DDD*MM[:SS] without, to degrees, false if not in that form
+    bool dmsToDouble(double *f, char *dms, bool signPresent);
+
+    // HH:MM:SS[.SSSS] or HH:MM.M to hours, false if not in that form
+    bool hmsToDouble(double *f, char *hms);
+
+    // degrees to sDD*MM (PM_LOW) or sDD*MM:SS (PM_HIGH), DDD when fullRange, with a sign when signPresent
+    void doubleToDms(char *reply, double f, bool fullRange, bool signPresent, PrecisionMode precision);
+
+    // text to int, false if it isn't a whole number in range
+    bool atoi2(char *a, int16_t *i, bool sign = true);
+
+    // remove leading zeros from a numeric string and optionally trailing zeros after its decimal point
+    void stripNumericStr(char *s, bool trailingZeros = false);
+};
+
+// copy at most size - 1 characters and terminate, like strncpy but always terminated
+char *sstrcpyex(char *result, const char *source, size_t size);
+
+// format one floating point value
+void sprintF(char *result, const char *format, double value);
+
+extern Convert convert;
@@ -0,0 +1,14 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's debug messages, shown when the bench runs with -v
+#pragma once
+
+#include <Arduino.h>
+
+#define V(x)   Serial.print(x)
+#define VF(x)  Serial.print(x)
+#define VL(x)  Serial.println(x)
+#define VLF(x) Serial.println(x)
+#define D(x)   Serial.print(x)
+#define DF(x)  Serial.print(x)
+#define DL(x)  Serial.println(x)
+#define DLF(x) Serial.println(x)
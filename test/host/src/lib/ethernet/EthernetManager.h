@@ -0,0 +1,3 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's Ethernet manager, the host build is a WiFi controller
+#pragma once
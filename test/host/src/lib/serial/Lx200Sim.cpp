@@ -0,0 +1,461 @@
+// -----------------------------------------------------------------------------------
+// Simulated OnStepX controller
+#include "Lx200Sim.h"
+
+#include <fstream>
+#include <sstream>
+
+// replies are framed as OnStepX frames them: strings end in '#', boolean and numeric replies don't
+static std::string framed(const std::string &s) { return s + "#"; }
+
+static std::string formatHms(double hours) {
+  long s = lround(hours*3600.0) % 86400L;
+  if (s < 0) s += 86400L;
+  char temp[16];
+  snprintf(temp, sizeof(temp), "%02ld:%02ld:%02ld", s/3600, (s/60) % 60, s % 60);
+  return temp;
+}
+
+// sDD*MM:SS when signed, DDD*MM:SS (three degree digits) when not, sign added to that for longitude
+static std::string formatDms(double degrees, bool sign, bool seconds = true, int digits = 2) {
+  long s = lround(fabs(degrees)*3600.0);
+  char temp[20];
+  if (seconds) snprintf(temp, sizeof(temp), "%s%0*ld*%02ld:%02ld", sign ? (degrees < 0 ? "-" : "+") : "", digits, s/3600, (s/60) % 60, s % 60);
+  else snprintf(temp, sizeof(temp), "%s%0*ld*%02ld", sign ? (degrees < 0 ? "-" : "+") : "", digits, s/3600, (s/60) % 60);
+  return temp;
+}
+
+static bool parseHms(const char *s, double *hours) {
+  int h, m, sec = 0;
+  int n = sscanf(s, "%d:%d:%d", &h, &m, &sec);
+  if (n < 2) return false;
+  *hours = h + m/60.0 + sec/3600.0;
+  return true;
+}
+
+static bool parseDms(const char *s, double *degrees) {
+  double sign = 1.0;
+  if (*s == '-') { sign = -1.0; s++; } else if (*s == '+') s++;
+  int d, m, sec = 0;
+  int n = sscanf(s, "%d%*c%d:%d", &d, &m, &sec);
+  if (n < 2) return false;
+  *degrees = sign*(d + m/60.0 + sec/3600.0);
+  return true;
+}
+
+Lx200Sim::Lx200Sim() : Lx200Sim(0) {}
+
+void Lx200Sim::reset() {
+  *this = Lx200Sim(0);
+}
+
+Lx200Sim::Lx200Sim(int) {
+  // a 480 second worm with a small periodic error correction curve
+  pec.resize(480);
+  for (size_t i = 0; i < pec.size(); i++) pec[i] = lround(20.0*sin(i*2.0*M_PI/pec.size()));
+
+  const char *names[4] = {"Camera", "Dew Heater", "Flats", "Intervalo"};
+  const int purposes[4] = {1, 3, 2, 4};
+  for (int i = 0; i < 8; i++) {
+    feature[i].purpose = i < 4 ? purposes[i] : 0;
+    feature[i].name = i < 4 ? names[i] : "";
+    feature[i].value1 = 0;
+    feature[i].value2 = feature[i].value3 = feature[i].value4 = 0.0F;
+  }
+  feature[1].value2 = -5.0F; feature[1].value3 = 5.0F; feature[1].value4 = 4.2F;
+  feature[3].value2 = 30.0F; feature[3].value3 = 2.0F; feature[3].value4 = 10.0F;
+
+  catalogName[0] = "Messier";
+  library[0] = {
+    {"M1", "SNR", "05:34:32", "+22*00:52"}, {"M13", "GC", "16:41:42", "+36*27:41"},
+    {"M31", "GAL", "00:42:44", "+41*16:09"}, {"M42", "DN", "05:35:17", "-05*23:28"},
+    {"M45", "OC", "03:47:24", "+24*07:00"}, {"M57", "PN", "18:53:35", "+33*01:45"},
+  };
+
+  // two mount axes, the rotator and the focuser, in OnStepX's order for a stepper axis
+  const char *mountAxis[] = {
+    "12800.0,1,1000000,5,$1", "-180,-360,0,3,$2", "180,0,360,3,$3", "0,0,1,1,$7",
+    "16,1,256,4,$8", "4,1,256,4,$9", "600,0,3000,3,$12", "600,0,3000,3,$13", "1200,0,3000,3,$14",
+  };
+  const char *focuserAxis[] = {
+    "1.0,1,1000,5,$4", "0,0,500000,3,$5", "50000,0,500000,3,$6", "0,0,1,1,$7",
+    "16,1,256,4,$8", "300,0,3000,3,$12", "300,0,3000,3,$13",
+  };
+  for (int axis = 0; axis < 4; axis++) {
+    if (axis < 3) axisParameters[axis].assign(std::begin(mountAxis), std::end(mountAxis));
+    else axisParameters[axis].assign(std::begin(focuserAxis), std::end(focuserAxis));
+  }
+}
+
+bool Lx200Sim::load(const char *path) {
+  std::ifstream file(path);
+  if (!file) { fprintf(stderr, "lx200: can't open %s\n", path); return false; }
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '#') continue;
+    std::istringstream fields(line.substr(begin));
+    std::string first, second, third;
+    fields >> first >> second;
+
+    bool valid = !second.empty();
+    if (first == "timing") {
+      double latency = 0, jitter = 0;
+      int drop = 0;
+      if (!(fields >> latency)) valid = false; else {
+        fields >> jitter >> drop;
+        setTiming(second == "*" ? "" : second.c_str(), latency, jitter, drop);
+      }
+    } else
+    if (first == "set") {
+      std::getline(fields >> std::ws, third);
+      valid = valid && setting(second, third);
+    } else
+    if (first[0] == ':' || first[0] == ';') {
+      // the reply is the rest of the line, it may hold spaces
+      std::string rest = line.substr(begin + first.length());
+      rest = rest.substr(rest.find_first_not_of(" \t"));
+      while (!rest.empty() && (rest.back() == '\r' || rest.back() == ' ')) rest.pop_back();
+      setReply(first.c_str(), rest.c_str());
+    } else valid = false;
+
+    if (!valid) { fprintf(stderr, "lx200: %s line %d not understood: %s\n", path, lineNumber, line.c_str()); return false; }
+  }
+  return true;
+}
+
+bool Lx200Sim::setting(const std::string &name, const std::string &value) {
+  if (name == "version") { version = value; return true; }
+  if (name == "mount") {
+    if (value == "gem") mountType = 'E'; else if (value == "fork") mountType = 'K'; else if (value == "altaz") mountType = 'A'; else return false;
+    return true;
+  }
+  if (name == "focusers") { focusers = atoi(value.c_str()); if (focusers < 0 || focusers > 6) return false; return true; }
+  if (name == "rotator") { rotator = value == "on"; return value == "on" || value == "off"; }
+  if (name == "tracking") { tracking = value == "on"; return value == "on" || value == "off"; }
+  if (name == "parked") { parked = value == "on"; return value == "on" || value == "off"; }
+  if (name == "pec") { pec.resize(atoi(value.c_str())); return true; }
+  if (name == "error") { error = atoi(value.c_str()); return error >= 0 && error <= 9; }
+  if (name == "ra") return parseHms(value.c_str(), &ra);
+  if (name == "dec") return parseDms(value.c_str(), &dec);
+  if (name == "latitude") return parseDms(value.c_str(), &latitude);
+  if (name == "longitude") return parseDms(value.c_str(), &longitude);
+  return false;
+}
+
+void Lx200Sim::setReply(const char *command, const char *reply) {
+  scripted[command] = (reply == NULL || strcmp(reply, "-") == 0) ? "\x01" : reply;
+}
+
+void Lx200Sim::setTiming(const char *prefix, double latencyMs, double jitterMs, int dropPercent) {
+  Lx200Timing t = {prefix, (unsigned long)lround(latencyMs*1000.0), (unsigned long)lround(jitterMs*1000.0), dropPercent};
+  for (auto &existing : timings) if (existing.prefix == t.prefix) { existing = t; return; }
+  timings.push_back(t);
+}
+
+const Lx200Timing &Lx200Sim::timing(const char *cmd) {
+  // OnStepX running its command loop answers a local command in well under a millisecond
+  static const Lx200Timing fallback = {"", 300, 0, 0};
+  const Lx200Timing *best = &fallback;
+  for (auto &t : timings) {
+    if (strncmp(cmd, t.prefix.c_str(), t.prefix.length()) == 0 && (best == &fallback || t.prefix.length() >= best->prefix.length())) best = &t;
+  }
+  return *best;
+}
+
+void Lx200Sim::command(const char *cmd, std::string &out, unsigned long &processingUs, bool &dropped) {
+  commands++;
+  // the :GX and :SX commands are told apart by their next two characters
+  size_t keyLength = (strncmp(cmd, ":GX", 3) == 0 || strncmp(cmd, ":SX", 3) == 0) ? 5 : 3;
+  std::string key = cmd[0] == (char)6 ? "ACK" : std::string(cmd, strnlen(cmd, keyLength));
+  Lx200CommandStats &s = stats[key];
+  s.count++;
+
+  out.clear();
+  auto found = scripted.find(cmd);
+  if (found != scripted.end()) { if (found->second != "\x01") out = found->second; } else
+  if (!reply(cmd, out)) { s.unknown++; out = "0"; }
+
+  const Lx200Timing &t = timing(cmd);
+  processingUs = t.latencyUs + (t.jitterUs > 0 ? esp_random() % (t.jitterUs + 1) : 0);
+  dropped = !out.empty() && t.dropPercent > 0 && (int)(esp_random() % 100) < t.dropPercent;
+  if (dropped) { s.dropped++; out.clear(); }
+}
+
+// the model, returns false for commands it doesn't know
+bool Lx200Sim::reply(const char *cmd, std::string &out) {
+  if (cmd[0] == (char)6) { out = "G"; return true; }
+  if (cmd[0] != ':') return false;
+  if (cmd[1] == 'F' || cmd[1] == 'f') return focuserReply(cmd, out);
+  if (cmd[1] == 'r' || strcmp(cmd, ":GX98#") == 0) return rotatorReply(cmd, out);
+  if (strncmp(cmd, ":GXX", 4) == 0 || strncmp(cmd, ":GXY", 4) == 0 || strncmp(cmd, ":SXX", 4) == 0) return auxiliaryReply(cmd, out);
+  if (cmd[1] == 'L') return libraryReply(cmd, out);
+  return mountReply(cmd, out);
+}
+
+std::string Lx200Sim::status() {
+  std::string s;
+  if (!tracking) s += 'n';
+  if (!slewing) s += 'N';
+  s += parked ? 'P' : 'p';
+  if (atHome) s += 'H';
+  if (!pec.empty()) s += 'R';
+  s += mountType;
+  s += (char)('0' + pulseGuideRate);
+  s += (char)('0' + guideRate);
+  s += (char)('0' + error);
+  return s;
+}
+
+bool Lx200Sim::mountReply(const char *cmd, std::string &out) {
+  char temp[80];
+  const char *c = cmd + 1;
+  int n1, n2;
+
+  if (!strcmp(c, "GVP#")) { out = framed("On-Step"); return true; }
+  if (!strcmp(c, "GVN#")) { out = framed(version); return true; }
+  if (!strcmp(c, "GVC#")) { out = framed("Host_Simulator"); return true; }
+  if (!strcmp(c, "GVH#")) { out = framed("Host"); return true; }
+  if (!strcmp(c, "GU#")) { out = framed(status()); return true; }
+
+  if (!strcmp(c, "GR#") || !strcmp(c, "GRa#")) { out = framed(formatHms(ra)); return true; }
+  if (!strcmp(c, "GD#") || !strcmp(c, "GDe#")) { out = framed(formatDms(dec, true)); return true; }
+  if (!strcmp(c, "Gr#") || !strcmp(c, "Gra#")) { out = framed(formatHms(targetRa)); return true; }
+  if (!strcmp(c, "Gd#") || !strcmp(c, "Gde#")) { out = framed(formatDms(targetDec, true)); return true; }
+  if (!strcmp(c, "GA#") || !strcmp(c, "GAH#")) { out = framed(formatDms(alt, true)); return true; }
+  if (!strcmp(c, "GZ#") || !strcmp(c, "GZH#")) { out = framed(formatDms(azm, false, true, 3)); return true; }
+  if (!strcmp(c, "Gt#") || !strcmp(c, "GtH#")) { out = framed(formatDms(latitude, true, c[2] == 'H')); return true; }
+  if (!strcmp(c, "Gg#") || !strcmp(c, "GgH#")) { out = framed(formatDms(longitude, true, c[2] == 'H', 3)); return true; }
+  if (!strcmp(c, "GS#")) { out = framed(formatHms(fmod(ra + 1.25, 24.0))); return true; }
+  if (!strcmp(c, "GX80#")) { out = framed(formatHms(21.0 + millis()/3600000.0)); return true; }
+  if (!strcmp(c, "GX81#")) { out = framed("10/19/26"); return true; }
+  if (!strcmp(c, "GT#")) { snprintf(temp, sizeof(temp), "%0.5f", tracking ? trackingRate : 0.0); out = framed(temp); return true; }
+  if (!strcmp(c, "GX94#")) { snprintf(temp, sizeof(temp), "%d", pierSide); out = framed(temp); return true; }
+  if (!strcmp(c, "GX96#")) { out = framed("B"); return true; }
+  if (!strcmp(c, "GX02#")) { out = framed("42"); return true; }
+  if (!strcmp(c, "GX03#")) { out = framed("-17"); return true; }
+  if (!strcmp(c, "GX92#") || !strcmp(c, "GX93#")) { out = framed("2.000"); return true; }
+  if (!strcmp(c, "GX97#")) { out = framed("2.0"); return true; }
+  if (!strcmp(c, "GX9A#")) { out = framed("12.5"); return true; }
+  if (!strcmp(c, "GX9B#")) { out = framed("1013.2"); return true; }
+  if (!strcmp(c, "GX9C#")) { out = framed("61.0"); return true; }
+  if (!strcmp(c, "GX9E#")) { out = framed("5.3"); return true; }
+  if (!strcmp(c, "GX9F#")) { out = framed("41.0"); return true; }
+  if (!strcmp(c, "GXFA#")) { out = framed("12%"); return true; }
+  if (!strcmp(c, "GXE9#") || !strcmp(c, "GXEA#")) { out = framed("15"); return true; }
+  if (!strcmp(c, "GXEM#")) { out = framed("1"); return true; }
+  if (!strcmp(c, "GG#")) { out = framed("+05:00"); return true; }
+  if (!strcmp(c, "Gh#")) { out = framed("-10*"); return true; }
+  if (!strcmp(c, "Go#")) { out = framed("+85*"); return true; }
+  if (!strcmp(c, "%BR#") || !strcmp(c, "%BD#")) { out = framed(c[2] == 'R' ? "60" : "30"); return true; }
+  if (!strcmp(c, "h?#")) { out = framed("0,0,0"); return true; }
+  if (!strcmp(c, "A?#")) { out = framed("900"); return true; }
+  if (sscanf(c, "GXU%d#", &n1) == 1) { out = framed(n1 <= 4 ? "ST" : "0"); return true; }
+
+  // PEC, a table entry per second of worm rotation
+  if (!strcmp(c, "GXE7#") || !strcmp(c, "VW#")) { snprintf(temp, sizeof(temp), "%d", (int)pec.size()*100); out = framed(temp); return true; }
+  if (!strcmp(c, "VS#")) { out = framed("100.0"); return true; }
+  if (!strcmp(c, "$QZ?#")) { out = framed("I"); return true; }
+  if (sscanf(c, "VR%d#", &n1) == 1) {
+    if (n1 < 0 || n1 >= (int)pec.size()) return false;
+    snprintf(temp, sizeof(temp), "%d", pec[n1]); out = framed(temp); return true;
+  }
+  if (sscanf(c, "WR%d,%d#", &n1, &n2) == 2) {
+    if (n1 >= 0 && n1 < (int)pec.size()) pec[n1] = n2;
+    return true;
+  }
+
+  // axis settings
+  if (sscanf(c, "GXA%d,", &n1) == 1 && n1 >= 1 && n1 <= 9) {
+    std::vector<std::string> &p = axisParameters[n1 - 1];
+    const char *which = strchr(c, ',') + 1;
+    if (*which == 'M') { out = framed(p.empty() ? "0" : "TMC2209"); return true; }
+    int i = atoi(which);
+    if (i == 0) { snprintf(temp, sizeof(temp), "%d", (int)p.size()); out = framed(temp); return true; }
+    if (i < 1 || i > (int)p.size()) return false;
+    out = framed(p[i - 1]);
+    return true;
+  }
+  if (sscanf(c, "SXA%d,%d,", &n1, &n2) == 2 && n1 >= 1 && n1 <= 9) {
+    std::vector<std::string> &p = axisParameters[n1 - 1];
+    if (n2 < 1 || n2 > (int)p.size()) { out = "0"; return true; }
+    double value = atof(strrchr(c, ',') + 1);
+    long min, max;
+    if (sscanf(p[n2 - 1].c_str(), "%*[^,],%ld,%ld", &min, &max) != 2 || value < min || value > max) { out = "0"; return true; }
+    std::string rest = p[n2 - 1].substr(p[n2 - 1].find(','));
+    snprintf(temp, sizeof(temp), "%g", value);
+    p[n2 - 1] = temp + rest;
+    out = "1";
+    return true;
+  }
+
+  // target, goto and sync
+  if (c[0] == 'S' && c[1] == 'r') { out = parseHms(c + 2, &targetRa) ? "1" : "0"; return true; }
+  if (c[0] == 'S' && c[1] == 'd') { out = parseDms(c + 2, &targetDec) ? "1" : "0"; return true; }
+  if (!strcmp(c, "MS#")) {
+    if (parked) { out = "5"; return true; }
+    ra = targetRa; dec = targetDec; atHome = false;
+    out = "0";
+    return true;
+  }
+  if (!strcmp(c, "CS#")) { ra = targetRa; dec = targetDec; return true; }
+  if (!strcmp(c, "Te#")) { tracking = !parked; out = parked ? "0" : "1"; return true; }
+  if (!strcmp(c, "Td#")) { tracking = false; out = "1"; return true; }
+  if (!strcmp(c, "hP#")) { parked = true; tracking = false; out = "1"; return true; }
+  if (!strcmp(c, "hR#")) { parked = false; out = "1"; return true; }
+  if (!strcmp(c, "hQ#")) { out = "1"; return true; }
+  if (!strcmp(c, "hC#") || !strcmp(c, "hF#")) { atHome = true; tracking = false; return true; }
+
+  // guiding, stops, rates and the rest of the commands without a reply
+  if (c[0] == 'M' && strchr("ewnsg", c[1])) return true;
+  if (c[0] == 'Q' || c[0] == 'R' || c[0] == 'B' || c[0] == 'U') return true;
+  if (c[0] == 'T' && strchr("QR+-SLK", c[1])) return true;
+
+  // other settings are accepted
+  if (c[0] == 'S') { out = "1"; return true; }
+  return false;
+}
+
+bool Lx200Sim::focuserReply(const char *cmd, std::string &out) {
+  char temp[40];
+  const char *c = cmd + 1;
+
+  // :FA# active focuser, :Fna# present, :FAn# select
+  if (!strcmp(c, "FA#")) { snprintf(temp, sizeof(temp), "%d", focusers > 0 ? focuserSelected : 0); out = temp; return true; }
+  if (c[1] >= '1' && c[1] <= '6' && c[2] == 'a') { out = c[1] - '0' <= focusers ? "1" : "0"; return true; }
+  if (c[1] == 'A' && c[2] >= '1' && c[2] <= '6') {
+    if (c[2] - '0' > focusers) { out = "0"; return true; }
+    focuserSelected = c[2] - '0'; out = "1"; return true;
+  }
+  if (c[0] != 'F' || focusers == 0) return false;
+
+  if (!strcmp(c, "Ft#")) { snprintf(temp, sizeof(temp), "%0.1f", focuserTemperature); out = framed(temp); return true; }
+  if (!strcmp(c, "FG#")) { snprintf(temp, sizeof(temp), "%0.0f", focuserPosition); out = framed(temp); return true; }
+  if (!strcmp(c, "Fb#")) { out = framed("50"); return true; }
+  if (!strcmp(c, "Fd#")) { out = framed("5"); return true; }
+  if (!strcmp(c, "Fc#")) { out = "0"; return true; }
+  if (!strcmp(c, "FC#")) { out = framed("0.00000"); return true; }
+  if (!strcmp(c, "FW#")) { out = framed("200"); return true; }
+  if (!strcmp(c, "FT#")) { out = framed("S3"); return true; }
+  if (c[1] == 'S') { focuserPosition = atof(c + 2); out = "1"; return true; }
+  if (strchr("+-QZHhF1234", c[1])) return true;
+  if (strchr("pc", c[1])) { out = "1"; return true; }
+  return false;
+}
+
+bool Lx200Sim::rotatorReply(const char *cmd, std::string &out) {
+  const char *c = cmd + 1;
+
+  if (!strcmp(c, "GX98#")) { out = framed(rotator ? "R" : "N"); return true; }
+  if (!rotator) return false;
+  if (!strcmp(c, "rT#")) { out = framed("S3"); return true; }
+  if (!strcmp(c, "rG#")) { out = framed(formatDms(rotatorAngle, true, false, 3)); return true; }
+  if (!strcmp(c, "rW#")) { out = framed("1.0"); return true; }
+  if (!strcmp(c, "rb#")) { out = framed("0"); return true; }
+  if (c[1] == 'S' || c[1] == '~') {
+    double angle;
+    if (c[1] == 'S' && parseDms(c + 2, &angle)) rotatorAngle = angle;
+    out = "1";
+    return true;
+  }
+  if (strchr("+-PRFC<>Q12345679c3", c[1])) return true;
+  return false;
+}
+
+bool Lx200Sim::auxiliaryReply(const char *cmd, std::string &out) {
+  char temp[80];
+  int i;
+
+  if (!strcmp(cmd, ":GXY0#")) {
+    std::string present;
+    for (int j = 0; j < 8; j++) present += feature[j].purpose != 0 ? '1' : '0';
+    out = framed(present);
+    return true;
+  }
+  if (sscanf(cmd, ":GXY%d#", &i) == 1 && i >= 1 && i <= 8) {
+    Lx200Feature &f = feature[i - 1];
+    if (f.purpose == 0) { out = framed("N/A"); return true; }
+    snprintf(temp, sizeof(temp), "%s,%d", f.name.c_str(), f.purpose);
+    out = framed(temp);
+    return true;
+  }
+  if (sscanf(cmd, ":GXX%d#", &i) == 1 && i >= 1 && i <= 8) {
+    Lx200Feature &f = feature[i - 1];
+    if (f.purpose == 0) return false;
+    if (f.purpose == 1 || f.purpose == 2) snprintf(temp, sizeof(temp), "%d", f.value1);
+    else snprintf(temp, sizeof(temp), "%d,%0.1f,%0.1f,%0.1f", f.value1, f.value2, f.value3, f.value4);
+    out = framed(temp);
+    return true;
+  }
+  char which;
+  double value;
+  if (sscanf(cmd, ":SXX%d,%c%lf#", &i, &which, &value) == 3 && i >= 1 && i <= 8 && feature[i - 1].purpose != 0) {
+    Lx200Feature &f = feature[i - 1];
+    if (which == 'V') f.value1 = lround(value); else
+    if (which == 'Z' || which == 'E') f.value2 = value; else
+    if (which == 'S' || which == 'D') f.value3 = value; else
+    if (which == 'C') f.value4 = value; else { out = "0"; return true; }
+    out = "1";
+    return true;
+  }
+  return false;
+}
+
+bool Lx200Sim::libraryReply(const char *cmd, std::string &out) {
+  char temp[80];
+  const char *c = cmd + 1;
+  int n;
+
+  if (!strcmp(c, "L?#")) {
+    size_t used = 0;
+    for (auto &l : library) used += l.size();
+    snprintf(temp, sizeof(temp), "%d", (int)(2000 - used));
+    out = framed(temp);
+    return true;
+  }
+  if (sscanf(c, "Lo%d#", &n) == 1) {
+    if (n < 0 || n > 14) { out = "0"; return true; }
+    catalog = n; record = 0; out = "1";
+    return true;
+  }
+  if (!strcmp(c, "L!#")) { for (auto &l : library) l.clear(); for (auto &name : catalogName) name.clear(); return true; }
+  if (catalog < 0) { if (c[1] == 'R' || c[1] == 'I') { out = framed(","); return true; } out = "0"; return true; }
+
+  std::vector<Lx200LibraryRecord> &l = library[catalog];
+  if (!strcmp(c, "L$#")) { record = -1; out = catalogName[catalog].empty() ? "0" : "1"; return true; }
+  if (!strcmp(c, "LR#")) {
+    if (record == -1) { out = framed("$" + catalogName[catalog]); record = 0; return true; }
+    if (record >= (int)l.size()) { out = framed(","); return true; }
+    Lx200LibraryRecord &r = l[record++];
+    out = framed(r.name + "," + r.category + "," + r.ra + "," + r.dec);
+    return true;
+  }
+  if (!strcmp(c, "LI#") || !strcmp(c, "LIG#")) {
+    if (record < 0 || record >= (int)l.size()) { out = framed(","); return true; }
+    Lx200LibraryRecord &r = l[record];
+    if (c[2] == 'G') { parseHms(r.ra.c_str(), &targetRa); parseDms(r.dec.c_str(), &targetDec); }
+    out = framed(r.name + "," + r.category);
+    return true;
+  }
+  if (c[1] == 'W') {
+    std::string fields(c + 2, strlen(c + 2) - 1);
+    if (fields[0] == '$') { catalogName[catalog] = fields.substr(1); out = "1"; return true; }
+    size_t comma = fields.find(',');
+    Lx200LibraryRecord r = {fields.substr(0, comma), comma == std::string::npos ? "UNK" : fields.substr(comma + 1), formatHms(targetRa), formatDms(targetDec, true)};
+    if (record < 0) record = 0;
+    if (record < (int)l.size()) l[record] = r; else l.push_back(r);
+    record++;
+    out = "1";
+    return true;
+  }
+  if (!strcmp(c, "LD#")) { if (record >= 0 && record < (int)l.size()) l.erase(l.begin() + record); return true; }
+  if (!strcmp(c, "LL#")) { l.clear(); record = 0; return true; }
+  if (!strcmp(c, "LN#")) { if (record < (int)l.size() - 1) record++; return true; }
+  if (!strcmp(c, "LB#")) { if (record > 0) record--; return true; }
+  return false;
+}
+
+Lx200Sim lx200Sim;
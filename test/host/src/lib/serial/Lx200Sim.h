@@ -0,0 +1,112 @@
+// -----------------------------------------------------------------------------------
+// Simulated OnStepX controller, answers the LX200 and OnStep extended commands the plugins use
+#pragma once
+
+#include <Arduino.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// reply timing for the commands starting with a prefix, the longest matching prefix is used
+typedef struct Lx200Timing {
+  std::string prefix;
+  unsigned long latencyUs;      // time OnStep takes to process the command
+  unsigned long jitterUs;       // up to this much more at random
+  int dropPercent;              // chance the reply is lost (the command still runs)
+} Lx200Timing;
+
+// statistics kept for each command (the ':' and two letters after it)
+typedef struct Lx200CommandStats {
+  unsigned long count;
+  unsigned long dropped;
+  unsigned long unknown;
+} Lx200CommandStats;
+
+typedef struct Lx200LibraryRecord {
+  std::string name;
+  std::string category;
+  std::string ra;
+  std::string dec;
+} Lx200LibraryRecord;
+
+typedef struct Lx200Feature {
+  std::string name;
+  int purpose;                  // 0 if not present, 1 switch, 2 analog output, 3 dew heater, 4 intervalometer
+  int value1;
+  float value2, value3, value4;
+} Lx200Feature;
+
+class Lx200Sim {
+  public:
+    Lx200Sim();
+
+    // back to the default controller: a GEM tracking at the sidereal rate with one focuser, a rotator,
+    // four auxiliary features, a small library catalog and a PEC table
+    void reset();
+
+    // read a script, each line is one of:
+    //   <command> <reply>                     always give this reply, "-" for none (recorded replies)
+    //   timing <prefix|*> <latency ms> [<jitter ms> [<drop %>]]
+    //   set <name> <value>                    controller settings, see the README
+    // blank lines and lines starting with # are skipped, returns false (and why on stderr) if it can't be used
+    bool load(const char *path);
+
+    // give reply to command from now on, NULL or "-" for no reply
+    void setReply(const char *command, const char *reply);
+    void setTiming(const char *prefix, double latencyMs, double jitterMs = 0, int dropPercent = 0);
+
+    // run a command: reply is the text OnStep would send ('#' framed or not as OnStep does), empty if it
+    // gives none; processingUs is how long OnStep takes before the reply and dropped is set if it's lost
+    void command(const char *cmd, std::string &reply, unsigned long &processingUs, bool &dropped);
+
+    // per command counts, commands with no model and no scripted reply are counted as unknown
+    std::map<std::string, Lx200CommandStats> stats;
+    unsigned long commands = 0;
+
+  private:
+    explicit Lx200Sim(int);
+    bool reply(const char *cmd, std::string &out);
+    bool mountReply(const char *cmd, std::string &out);
+    bool focuserReply(const char *cmd, std::string &out);
+    bool rotatorReply(const char *cmd, std::string &out);
+    bool auxiliaryReply(const char *cmd, std::string &out);
+    bool libraryReply(const char *cmd, std::string &out);
+    bool setting(const std::string &name, const std::string &value);
+    const Lx200Timing &timing(const char *cmd);
+    std::string status();
+
+    std::map<std::string, std::string> scripted;
+    std::vector<Lx200Timing> timings;
+
+    // mount
+    std::string version = "10.26a";
+    double ra = 5.5, dec = 22.0, targetRa = 5.5, targetDec = 22.0;
+    double alt = 45.0, azm = 180.0;
+    double latitude = 40.0, longitude = 75.0;       // longitude west positive like OnStep
+    bool tracking = true, slewing = false, parked = false, atHome = false;
+    char mountType = 'E';                           // E GEM, K fork, A alt-azimuth
+    int pierSide = 1;
+    int guideRate = 6, pulseGuideRate = 2;
+    int error = 0;
+    double trackingRate = 60.16427;
+    std::vector<int> pec;
+
+    // focuser, rotator
+    int focusers = 1, focuserSelected = 1;
+    double focuserPosition = 12500.0, focuserTemperature = 9.5;
+    bool rotator = true;
+    double rotatorAngle = 90.0;
+
+    // auxiliary features and the library
+    Lx200Feature feature[8];
+    std::string catalogName[15];
+    std::vector<Lx200LibraryRecord> library[15];
+    int catalog = -1;
+    int record = 0;
+
+    // axis settings ($1 to $n) as "value,min,max,type,name"
+    std::vector<std::string> axisParameters[9];
+};
+
+extern Lx200Sim lx200Sim;
@@ -0,0 +1,62 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's local command channel
+#include "Serial_Local.h"
+#include "../convert/Convert.h"
+
+void SerialLocal::transmit(const char *data) {
+  // OnStep works through the commands one at a time, so each reply is ready after the one before it
+  const char *p = data;
+  while (*p) {
+    const char *end = p;
+    if (*p == (char)6) end = p + 1; else {
+      while (*end && *end != '#') end++;
+      if (*end == '#') end++;
+    }
+    std::string cmd(p, end - p);
+    p = end;
+
+    std::string reply;
+    unsigned long processingUs;
+    bool dropped;
+    lx200Sim.command(cmd.c_str(), reply, processingUs, dropped);
+
+    unsigned long long now = hostMicros();
+    if (busyUntilUs < now) busyUntilUs = now;
+    busyUntilUs += processingUs;
+    if (!reply.empty()) pending.push_back({reply, busyUntilUs, now});
+  }
+}
+
+int SerialLocal::receiveAvailable() {
+  int n = 0;
+  for (auto &r : pending) if (r.readyUs <= hostMicros()) n++; else break;
+  return n;
+}
+
+char *SerialLocal::receive() {
+  buffer[0] = 0;
+  if (receiveAvailable() == 0) return buffer;
+  SerialReply &r = pending.front();
+  sstrcpyex(buffer, r.text.c_str(), sizeof(buffer));
+  replyWaitUs += r.readyUs - r.sentUs;
+  replies++;
+  pending.pop_front();
+  return buffer;
+}
+
+int SerialLocal::available() {
+  int n = 0;
+  for (auto &r : pending) if (r.readyUs <= hostMicros()) n += r.text.length(); else break;
+  return n;
+}
+
+int SerialLocal::read() {
+  if (pending.empty() || pending.front().readyUs > hostMicros()) return -1;
+  SerialReply &r = pending.front();
+  int c = (unsigned char)r.text[0];
+  r.text.erase(0, 1);
+  if (r.text.empty()) pending.pop_front();
+  return c;
+}
+
+SerialLocal serialLocal;
@@ -0,0 +1,44 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's local command channel, connected to the simulated controller
+#pragma once
+
+#include "../../Common.h"
+#include "Lx200Sim.h"
+
+#include <deque>
+
+class SerialLocal {
+  public:
+    void begin(long baud = 9600) { (void)baud; }
+    void setTimeout(unsigned long ms) { timeoutMs = ms; }
+
+    // send one or more commands, each is answered by the simulator in order
+    void transmit(const char *data);
+
+    // whole replies ready by now (on the simulated clock), receive() takes the next one
+    int receiveAvailable();
+    char *receive();
+
+    // reply characters ready by now
+    int available();
+    int read();
+
+    // time the replies received so far took from transmit to ready, in microseconds
+    unsigned long long replyWaitUs = 0;
+    unsigned long replies = 0;
+
+  private:
+    typedef struct SerialReply {
+      std::string text;
+      unsigned long long readyUs;
+      unsigned long long sentUs;
+    } SerialReply;
+
+    std::deque<SerialReply> pending;
+    unsigned long long busyUntilUs = 0;
+    unsigned long timeoutMs = 1000;
+    char buffer[256];
+};
+
+extern SerialLocal serialLocal;
+#define SERIAL_LOCAL serialLocal
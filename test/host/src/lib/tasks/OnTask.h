@@ -0,0 +1,3 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's task scheduler, the bench calls the pollers itself
+#pragma once
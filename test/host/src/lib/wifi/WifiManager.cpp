@@ -0,0 +1,5 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's WiFi manager
+#include "WifiManager.h"
+
+HostWiFi WiFi;
@@ -0,0 +1,21 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's WiFi manager, only the radio status the pages and metrics show
+#pragma once
+
+#include "../../Common.h"
+
+class HostWiFi {
+  public:
+    bool isConnected() { return true; }
+    int RSSI() { return -52; }
+    String macAddress() { return "24:0A:C4:00:00:01"; }
+    uint8_t *macAddress(uint8_t *mac) { static const uint8_t address[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01}; memcpy(mac, address, 6); return mac; }
+    String softAPmacAddress() { return "24:0A:C4:00:00:02"; }
+    IPAddress localIP() { return IPAddress(192, 168, 0, 20); }
+    IPAddress gatewayIP() { return IPAddress(192, 168, 0, 1); }
+    IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+    IPAddress dnsIP() { return IPAddress(192, 168, 0, 1); }
+    const char *getHostname() { return "onstep"; }
+};
+
+extern HostWiFi WiFi;
@@ -0,0 +1,124 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's WiFi web server
+#include "WebServer.h"
+
+static String urlDecode(const std::string &s) {
+  std::string out;
+  for (size_t i = 0; i < s.length(); i++) {
+    if (s[i] == '+') out += ' '; else
+    if (s[i] == '%' && i + 2 < s.length()) { out += (char)strtol(s.substr(i + 1, 2).c_str(), NULL, 16); i += 2; } else
+    out += s[i];
+  }
+  return String(out);
+}
+
+void WebServer::on(const char *uri, THandlerFunction handler) {
+  routes.push_back({uri, HTTP_ANY, handler, nullptr});
+}
+
+void WebServer::on(const char *uri, HTTPMethod method, THandlerFunction handler, THandlerFunction uploadHandler) {
+  routes.push_back({uri, method, handler, uploadHandler});
+}
+
+String WebServer::arg(const char *name) {
+  for (auto &a : requestArgs) if (a.first == name) return a.second;
+  return String();
+}
+
+String WebServer::arg(int i) {
+  if (i < 0 || i >= (int)requestArgs.size()) return String();
+  return requestArgs[i].second;
+}
+
+String WebServer::argName(int i) {
+  if (i < 0 || i >= (int)requestArgs.size()) return String();
+  return requestArgs[i].first;
+}
+
+bool WebServer::hasArg(const char *name) {
+  for (auto &a : requestArgs) if (a.first == name) return true;
+  return false;
+}
+
+void WebServer::send(int code, const char *contentType, const String &content) {
+  response.code = code;
+  response.contentType = contentType;
+  if (content.length() > 0) sendContent(content);
+}
+
+void WebServer::sendContent(const String &content) {
+  sendContent(content.c_str(), content.length());
+}
+
+void WebServer::sendContent(const char *content, size_t length) {
+  if (length == 0) return;
+  response.bytes += length;
+  response.chunks++;
+  if (keepBody) response.body.append(content, length);
+}
+
+WebServer::WebRoute *WebServer::route(HTTPMethod method, const char *uri) {
+  for (auto &r : routes) if (r.uri == uri && (r.method == HTTP_ANY || r.method == method)) return &r;
+  return NULL;
+}
+
+void WebServer::begin(HTTPMethod method, const char *uri, const char *query) {
+  requestUri = uri;
+  requestMethod = method;
+  requestArgs.clear();
+  std::string q = query;
+  size_t start = 0;
+  while (start < q.length()) {
+    size_t end = q.find('&', start);
+    if (end == std::string::npos) end = q.length();
+    std::string pair = q.substr(start, end - start);
+    size_t equals = pair.find('=');
+    if (!pair.empty()) {
+      if (equals == std::string::npos) requestArgs.push_back({urlDecode(pair), String()});
+      else requestArgs.push_back({urlDecode(pair.substr(0, equals)), urlDecode(pair.substr(equals + 1))});
+    }
+    start = end + 1;
+  }
+  response.code = 0;
+  response.contentType = "";
+  response.bytes = 0;
+  response.chunks = 0;
+  response.body.clear();
+}
+
+WebResponse &WebServer::request(HTTPMethod method, const char *uri, const char *query) {
+  begin(method, uri, query);
+  WebRoute *r = route(method, uri);
+  if (r != NULL) r->handler(); else if (notFound) notFound();
+  return response;
+}
+
+WebResponse &WebServer::upload(const char *uri, const char *filename, const std::string &body) {
+  begin(HTTP_POST, uri, "");
+  WebRoute *r = route(HTTP_POST, uri);
+  if (r == NULL) { if (notFound) notFound(); return response; }
+
+  currentUpload.filename = filename;
+  currentUpload.name = "file";
+  currentUpload.type = "text/plain";
+  currentUpload.totalSize = 0;
+  currentUpload.currentSize = 0;
+  if (r->uploadHandler) {
+    currentUpload.status = UPLOAD_FILE_START;
+    r->uploadHandler();
+    for (size_t i = 0; i < body.length(); i += HTTP_UPLOAD_BUFLEN) {
+      currentUpload.status = UPLOAD_FILE_WRITE;
+      currentUpload.currentSize = std::min((size_t)HTTP_UPLOAD_BUFLEN, body.length() - i);
+      memcpy(currentUpload.buf, body.data() + i, currentUpload.currentSize);
+      currentUpload.totalSize += currentUpload.currentSize;
+      r->uploadHandler();
+    }
+    currentUpload.status = UPLOAD_FILE_END;
+    currentUpload.currentSize = 0;
+    r->uploadHandler();
+  }
+  r->handler();
+  return response;
+}
+
+WebServer www;
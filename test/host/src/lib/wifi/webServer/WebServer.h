@@ -0,0 +1,110 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's WiFi web server, requests are made by the bench and the response is captured
+#pragma once
+
+#include "../../../Common.h"
+#include "../WifiManager.h"
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define HTTP_UPLOAD_BUFLEN 1436
+
+typedef struct HTTPUpload {
+  HTTPUploadStatus status;
+  String filename;
+  String name;
+  String type;
+  size_t totalSize;
+  size_t currentSize;
+  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+} HTTPUpload;
+
+// what a handler sent back
+typedef struct WebResponse {
+  int code;
+  String contentType;
+  size_t bytes;                 // body bytes, as they would go over the network
+  unsigned long chunks;         // pieces the body was sent in
+  std::string body;
+} WebResponse;
+
+class WebClient {
+  public:
+    bool connected() { return false; }
+};
+
+class WebServer {
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    void begin() {}
+    void handleClient() {}
+    WebClient &client() { return webClient; }
+
+    void on(const char *uri, THandlerFunction handler);
+    void on(const char *uri, HTTPMethod method, THandlerFunction handler) { on(uri, method, handler, nullptr); }
+    void on(const char *uri, HTTPMethod method, THandlerFunction handler, THandlerFunction uploadHandler);
+    void onNotFound(THandlerFunction handler) { notFound = handler; }
+
+    // the request
+    String arg(const char *name);
+    String arg(const String &name) { return arg(name.c_str()); }
+    String arg(int i);
+    String argName(int i);
+    bool hasArg(const char *name);
+    bool hasArg(const String &name) { return hasArg(name.c_str()); }
+    int args() { return (int)requestArgs.size(); }
+    String uri() { return requestUri; }
+    HTTPMethod method() { return requestMethod; }
+    HTTPUpload &upload() { return currentUpload; }
+
+    // the response
+    void setContentLength(size_t length) { (void)length; }
+    void sendHeader(const char *name, const char *value, bool first = false) { (void)name; (void)value; (void)first; }
+    void send(int code, const char *contentType, const String &content);
+    void send(int code, const char *contentType, const char *content) { send(code, contentType, String(content)); }
+    void sendContent(const String &content);
+    void sendContent(const char *content, size_t length);
+    void sendContentAndClear(String &content) { sendContent(content); content = ""; }
+
+    // make a request as a browser would, the query string ("a=1&b=2", URL encoded) becomes the arguments,
+    // a registered handler is called (or the not found handler) and what it sent is returned
+    WebResponse &request(HTTPMethod method, const char *uri, const char *query = "");
+
+    // make a POST request with a body, passed to the upload handler in pieces of HTTP_UPLOAD_BUFLEN bytes
+    WebResponse &upload(const char *uri, const char *filename, const std::string &body);
+
+    // keep the body of responses in response.body (off by default, only the sizes are counted)
+    bool keepBody = false;
+    WebResponse response;
+
+  private:
+    typedef struct WebRoute {
+      std::string uri;
+      HTTPMethod method;
+      THandlerFunction handler;
+      THandlerFunction uploadHandler;
+    } WebRoute;
+
+    WebRoute *route(HTTPMethod method, const char *uri);
+    void begin(HTTPMethod method, const char *uri, const char *query);
+
+    std::vector<WebRoute> routes;
+    THandlerFunction notFound;
+    WebClient webClient;
+
+    String requestUri;
+    HTTPMethod requestMethod = HTTP_GET;
+    std::vector<std::pair<String, String>> requestArgs;
+    HTTPUpload currentUpload;
+};
+
+extern WebServer www;
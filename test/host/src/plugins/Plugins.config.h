@@ -0,0 +1,8 @@
+// -----------------------------------------------------------------------------------
+// Host stand-in for OnStepX's plugin configuration, the website is built on its own or with the metrics
+// plugin ("make METRICS=ON")
+#pragma once
+
+#ifdef HOST_METRICS
+  #include "metrics/MetricsPlugin.h"
+#endif
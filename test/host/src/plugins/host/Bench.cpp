@@ -0,0 +1,405 @@
+// -----------------------------------------------------------------------------------
+// Host bench for the website plugin, serves its pages from the simulated controller and reports the cost
+//
+//   bench [-v] [-n iterations] [-l limits] [-p uri] [script]
+//
+//   -v         show the plugin's debug messages
+//   -n         requests made to each handler (default 200)
+//   -l limits  fail (exit 1) if a request or the poller goes over the limits in this file, see limits.txt
+//   -p uri     print the response to one request (uri may include a "?query") and stop
+//   script     controller replies and timing to load into the simulator, see scripts/
+//
+// built with the metrics plugin ("make METRICS=ON") its pages are requested too, what they send and what
+// it pushes are checked and the bench fails (exit 1) if any of it is malformed
+#include "../website/Website.h"
+#include "../website/Common.h"
+#include "../website/pages/Pages.h"
+#include "../../lib/serial/Lx200Sim.h"
+#include "../Plugins.config.h"
+#ifdef HAS_METRICS_PLUGIN
+  #include <lwip/sockets.h>
+#endif
+
+#include <time.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// the network page isn't part of the host build
+void handleNetwork() { www.send(404, "text/plain", "not in the host build"); }
+
+typedef struct BenchRequest {
+  HTTPMethod method;
+  const char *uri;
+  const char *query;
+} BenchRequest;
+
+// the requests a browser makes with each page open, in the order it makes them
+static const BenchRequest requests[] = {
+  {HTTP_GET, "/index.htm", ""},
+  {HTTP_GET, "/index-ajax-get.txt", ""},
+  {HTTP_GET, "/index.txt", ""},
+  {HTTP_GET, "/mount.htm", ""},
+  {HTTP_GET, "/mount-ajax-get.txt", "lib_index=1"},
+  {HTTP_GET, "/mount-ajax.txt", ""},
+  {HTTP_GET, "/catalog.txt", ""},
+  {HTTP_GET, "/pec.txt", ""},
+  {HTTP_GET, "/rotator.htm", ""},
+  {HTTP_GET, "/rotator-ajax-get.txt", ""},
+  {HTTP_GET, "/rotator-ajax.txt", ""},
+  {HTTP_GET, "/focuser.htm", ""},
+  {HTTP_GET, "/focuser-ajax-get.txt", ""},
+  {HTTP_GET, "/focuser-ajax.txt", ""},
+  {HTTP_GET, "/auxiliary.htm", ""},
+  {HTTP_GET, "/auxiliary-ajax-get.txt", ""},
+  {HTTP_GET, "/auxiliary-ajax.txt", ""},
+  {HTTP_GET, "/api/v1/state", ""},
+  {HTTP_GET, "/api/v1/state", "format=cbor"},
+#ifdef HAS_METRICS_PLUGIN
+  {HTTP_GET, METRICS_PLUGIN_PATH, ""},
+  #if METRICS_HISTORY == ON
+    {HTTP_GET, METRICS_PLUGIN_PATH "/range", "series=heap_free"},
+  #endif
+#endif
+};
+
+// averages over the requests made to a handler, or for the poller its commands per second
+typedef struct BenchResult {
+  double wait;      // in ms
+  double commands;
+  double allocations;
+  double bytes;
+} BenchResult;
+
+// the most each may be, NAN where a column isn't checked
+static std::map<std::string, BenchResult> limits;
+static int limitsExceeded = 0;
+
+static double cpuMicros() {
+  struct timespec t;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+  return t.tv_sec*1000000.0 + t.tv_nsec/1000.0;
+}
+
+static void usage() {
+  fputs("usage: bench [-v] [-n iterations] [-l limits] [-p uri[?query]] [script]\n", stderr);
+  exit(2);
+}
+
+// one line per request, named as the bench prints it (up to the first space): wait ms, commands, allocs and
+// bytes, "-" for a column not checked; blank lines and lines starting with # are skipped
+static bool loadLimits(const char *fileName) {
+  std::ifstream file(fileName);
+  if (!file) { fprintf(stderr, "bench: can't open %s\n", fileName); return false; }
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    std::istringstream fields(line);
+    std::string name, column[4];
+    if (!(fields >> name) || name[0] == '#') continue;
+    if (!(fields >> column[0] >> column[1] >> column[2] >> column[3])) {
+      fprintf(stderr, "bench: %s line %d, expected a name and four limits\n", fileName, lineNumber);
+      return false;
+    }
+    double value[4];
+    for (int i = 0; i < 4; i++) value[i] = column[i] == "-" ? NAN : atof(column[i].c_str());
+    limits[name] = {value[0], value[1], value[2], value[3]};
+  }
+  return true;
+}
+
+// compare with the limits for this name, if any, and report what is over
+static void checkLimits(const char *name, const BenchResult &result) {
+  std::string key = name;
+  size_t space = key.find(' ');
+  if (space != std::string::npos) key.erase(space);
+  auto it = limits.find(key);
+  if (it == limits.end()) return;
+
+  const double measured[4] = {result.wait, result.commands, result.allocations, result.bytes};
+  const double limit[4] = {it->second.wait, it->second.commands, it->second.allocations, it->second.bytes};
+  const char *columns[4] = {"wait ms", "commands", "allocs", "bytes"};
+  for (int i = 0; i < 4; i++) {
+    if (isnan(limit[i]) || measured[i] <= limit[i]) continue;
+    fprintf(stderr, "bench: %s %s %0.2f over the limit of %0.2f\n", key.c_str(), columns[i], measured[i], limit[i]);
+    limitsExceeded++;
+  }
+}
+
+#ifdef HAS_METRICS_PLUGIN
+static int metricsErrors = 0;
+
+static void metricsError(const char *what, const std::string &line) {
+  fprintf(stderr, "bench: metrics, %s: %s\n", what, line.c_str());
+  metricsErrors++;
+}
+
+static bool isNumber(const std::string &s) {
+  char *end;
+  strtod(s.c_str(), &end);
+  return !s.empty() && *end == 0;
+}
+
+// the metrics plugin's background tasks, caught up with the simulated time since they last ran
+static void metricsTasks() {
+  metricsPlugin.collect();
+  #if METRICS_HISTORY == ON
+    static unsigned long sampled = 0;
+    while (millis() - sampled >= 1000) { sampled += 1000; metricsPlugin.sampleHistory(); }
+  #endif
+}
+
+// the text exposition format: each family's HELP and TYPE once, then its samples, each with a number
+static void checkScrape() {
+  static const std::regex sample("([a-zA-Z_:][a-zA-Z0-9_:]*)\\{([a-zA-Z_][a-zA-Z0-9_]*=\"[^\"\\\\]*\",?)*\\} (\\S+)");
+  www.keepBody = true;
+  WebResponse &r = www.request(HTTP_GET, METRICS_PLUGIN_PATH);
+  www.keepBody = false;
+  if (r.code != 200) metricsError("scrape failed", std::to_string(r.code));
+
+  std::istringstream lines(r.body);
+  std::string line, family;
+  std::set<std::string> families;
+  int samples = 0;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, 7, "# HELP ") == 0) {
+      family = line.substr(7, line.find(' ', 7) - 7);
+      if (!families.insert(family).second) metricsError("family repeated", line);
+      continue;
+    }
+    if (line.compare(0, 7, "# TYPE ") == 0) {
+      if (line.compare(7, family.length() + 1, family + " ") != 0) metricsError("TYPE isn't after its HELP", line);
+      continue;
+    }
+
+    std::smatch m;
+    if (!std::regex_match(line, m, sample)) { metricsError("sample malformed", line); continue; }
+    std::string name = m[1], suffix = name.compare(0, family.length(), family) == 0 ? name.substr(family.length()) : "?";
+    if (suffix != "" && suffix != "_bucket" && suffix != "_sum" && suffix != "_count") metricsError("sample isn't of the family before it", line);
+    if (!isNumber(m[3])) metricsError("value isn't a number", line);
+    samples++;
+  }
+  printf("\nmetrics scrape, %lu families, %d samples, %lu bytes\n", (unsigned long)families.size(), samples, (unsigned long)r.bytes);
+}
+
+// the history of the free heap at each resolution, the points in time order
+static void checkRange() {
+#if METRICS_HISTORY == ON
+  static const char *queries[] = {"series=heap_free", "series=heap_free&step=60", "series=heap_free&step=600&from=-3600"};
+  www.keepBody = true;
+  if (www.request(HTTP_GET, METRICS_PLUGIN_PATH "/range", "series=none").code != 404) metricsError("unknown series found", "none");
+  for (const char *query : queries) {
+    WebResponse &r = www.request(HTTP_GET, METRICS_PLUGIN_PATH "/range", query);
+    std::istringstream lines(r.body);
+    std::string line;
+    long points = 0, last = -1;
+    if (!std::getline(lines, line) || line.compare(0, 12, "# heap_free ") != 0) metricsError("range header", line);
+    if (!std::getline(lines, line) || line != "time,value") metricsError("range columns", line);
+    while (std::getline(lines, line)) {
+      size_t comma = line.find(',');
+      std::string time = line.substr(0, comma);
+      if (comma == std::string::npos || !isNumber(time) || !isNumber(line.substr(comma + 1))) { metricsError("range point malformed", line); continue; }
+      if (atol(time.c_str()) <= last) metricsError("range point out of order", line);
+      last = atol(time.c_str());
+      points++;
+    }
+    printf("metrics range %s, %ld points\n", query, points);
+  }
+  www.keepBody = false;
+#endif
+}
+
+// each datagram whole lines and no larger than allowed, each line a StatsD gauge or an InfluxDB point
+static void checkPush() {
+#if METRICS_PUSH != OFF
+  #if METRICS_PUSH == METRICS_PUSH_INFLUX
+    static const std::regex point("[a-zA-Z_:][a-zA-Z0-9_:]*(,[a-zA-Z_][a-zA-Z0-9_]*=([^,= \\\\]|\\\\.)+)* value=(\\S+?)i?");
+    const int valueMatch = 3;
+  #else
+    static const std::regex point("[a-zA-Z_:][a-zA-Z0-9_:]*:(\\S+?)\\|g(\\|#[a-zA-Z_][a-zA-Z0-9_]*:[^,|]+(,[a-zA-Z_][a-zA-Z0-9_]*:[^,|]+)*)?");
+    const int valueMatch = 1;
+  #endif
+  hostDatagrams.clear();
+  metricsPlugin.push();
+
+  int lines = 0;
+  for (const std::string &datagram : hostDatagrams) {
+    if (datagram.size() > METRICS_PUSH_DATAGRAM_SIZE) metricsError("datagram too large", std::to_string(datagram.size()));
+    if (datagram.empty() || datagram.back() != '\n') metricsError("datagram doesn't end a line", datagram);
+    std::istringstream text(datagram);
+    std::string line;
+    while (std::getline(text, line)) {
+      std::smatch m;
+      if (!std::regex_match(line, m, point)) metricsError("push line malformed", line); else
+      if (!isNumber(m[valueMatch])) metricsError("push value isn't a number", line);
+      lines++;
+    }
+  }
+  printf("metrics push, %lu datagrams, %d lines\n", (unsigned long)hostDatagrams.size(), lines);
+  if (lines == 0) metricsError("nothing pushed", "");
+#endif
+}
+#endif
+
+// the state poller with every page open, over a simulated minute
+static void benchPoller() {
+  const unsigned long long window = 60000000ULL;
+  unsigned long long start = hostMicros(), busy = 0;
+  unsigned long startCommands = lx200Sim.commands, polls = 0;
+  double cpu = 0.0;
+
+  while (hostMicros() - start < window) {
+    state.lastControllerPageLoadTime = state.lastMountPageLoadTime = state.lastAuxPageLoadTime = millis();
+    state.lastFocuserPageLoadTime = state.lastRotatorPageLoadTime = millis();
+
+    unsigned long long t0 = hostMicros();
+    double c0 = cpuMicros();
+    unsigned long commands = lx200Sim.commands;
+    state.poll();
+    cpu += cpuMicros() - c0;
+    if (lx200Sim.commands != commands) { busy += hostMicros() - t0; polls++; }
+
+    // the poll task's idle block
+    delay(WEB_SERVER_IDLE_POLL_MS);
+  }
+
+  unsigned long commands = lx200Sim.commands - startCommands;
+  printf("\nstate poller, every page open, %0.0f simulated seconds\n", window/1000000.0);
+  printf("  polls %lu, LX200 commands %lu (%0.1f/s), command channel busy %0.1f%%, CPU %0.1f us/poll\n",
+    polls, commands, commands/(window/1000000.0), busy*100.0/window, polls ? cpu/polls : 0.0);
+
+  checkLimits("poller", {(double)NAN, commands/(window/1000000.0), (double)NAN, (double)NAN});
+}
+
+static void printStats() {
+  std::vector<std::pair<std::string, Lx200CommandStats>> sorted(lx200Sim.stats.begin(), lx200Sim.stats.end());
+  std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, Lx200CommandStats> &a, const std::pair<std::string, Lx200CommandStats> &b) {
+    return a.second.count > b.second.count;
+  });
+
+  printf("\nLX200 commands, %lu total\n", lx200Sim.commands);
+  printf("  %-8s %10s %8s %8s\n", "command", "count", "dropped", "unknown");
+  for (auto &s : sorted) {
+    printf("  %-8s %10lu %8lu %8lu\n", s.first == "ACK" ? "<ACK>" : s.first.c_str(), s.second.count, s.second.dropped, s.second.unknown);
+  }
+}
+
+// make a request iterations times and print what it cost on average
+static void measure(const char *name, long iterations, std::function<WebResponse &()> request) {
+  double cpu = 0.0;
+  unsigned long long wait = 0;
+  unsigned long commands = 0, allocations = 0;
+  WebResponse last;
+
+  for (long i = 0; i < iterations; i++) {
+    // the poller runs between requests as it would between a browser's ajax updates
+    state.poll();
+    delay(AJAX_PAGE_UPDATE_RATE_MS);
+    #ifdef HAS_METRICS_PLUGIN
+      metricsTasks();
+    #endif
+
+    unsigned long c0 = lx200Sim.commands;
+    unsigned long long t0 = hostMicros();
+    double cpu0 = cpuMicros();
+    unsigned long a0 = hostAllocations();
+    WebResponse &response = request();
+    allocations += hostAllocations() - a0;
+    cpu += cpuMicros() - cpu0;
+    wait += hostMicros() - t0;
+    commands += lx200Sim.commands - c0;
+    last = response;
+  }
+
+  printf("  %-32s %5d %10.1f %10.2f %9.1f %9.1f %9lu %7lu\n", name, last.code, cpu/iterations,
+    wait/1000.0/iterations, (double)commands/iterations, (double)allocations/iterations, (unsigned long)last.bytes, last.chunks);
+
+  checkLimits(name, {wait/1000.0/iterations, (double)commands/iterations, (double)allocations/iterations, (double)last.bytes});
+}
+
+int main(int argc, char *argv[]) {
+  long iterations = 200;
+  const char *printUri = NULL;
+  const char *limitsFile = NULL;
+  const char *script = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-v")) hostVerbose = true; else
+    if (!strcmp(argv[i], "-n") && i + 1 < argc) { iterations = atol(argv[++i]); if (iterations < 1) usage(); } else
+    if (!strcmp(argv[i], "-l") && i + 1 < argc) limitsFile = argv[++i]; else
+    if (!strcmp(argv[i], "-p") && i + 1 < argc) printUri = argv[++i]; else
+    if (argv[i][0] == '-' || script != NULL) usage(); else script = argv[i];
+  }
+
+  if (script != NULL && !lx200Sim.load(script)) return 1;
+  if (limitsFile != NULL && !loadLimits(limitsFile)) return 1;
+
+  website.init();
+  #ifdef HAS_METRICS_PLUGIN
+    metricsPlugin.init();
+  #endif
+  if (!status.onStepFound) { fputs("bench: OnStep not found, check the script\n", stderr); return 1; }
+
+  if (printUri != NULL) {
+    std::string uri = printUri, query;
+    size_t q = uri.find('?');
+    if (q != std::string::npos) { query = uri.substr(q + 1); uri.erase(q); }
+    // the first request marks the page open, so the poller fetches what it shows before the one printed
+    www.request(HTTP_GET, uri.c_str(), query.c_str());
+    delay(STATE_POLLING_RATE_MS);
+    state.poll();
+    www.keepBody = true;
+    WebResponse &r = www.request(HTTP_GET, uri.c_str(), query.c_str());
+    fprintf(stderr, "%d %s, %lu bytes\n", r.code, r.contentType.c_str(), (unsigned long)r.bytes);
+    fwrite(r.body.data(), 1, r.body.length(), stdout);
+    return r.code == 200 ? 0 : 1;
+  }
+
+  printf("website host bench, %ld requests per handler%s%s\n", iterations, script ? ", script " : "", script ? script : "");
+  printf("  %-32s %5s %10s %10s %9s %9s %9s %7s\n", "request", "code", "CPU us", "wait ms", "commands", "allocs", "bytes", "chunks");
+
+  for (const BenchRequest &b : requests) {
+    std::string name = b.uri;
+    if (b.query[0]) { name += "?"; name += b.query; }
+    measure(name.c_str(), iterations, [&b]() -> WebResponse & { return www.request(b.method, b.uri, b.query); });
+  }
+
+  // the PEC table uploaded with every entry changed, alternating with the original so each upload writes them all
+  www.keepBody = true;
+  std::string original = www.request(HTTP_GET, "/pec.txt").body;
+  www.keepBody = false;
+  std::istringstream table(original);
+  std::string line, changed;
+  while (std::getline(table, line)) {
+    if (line.empty() || line[0] == '#') { changed += line + "\n"; continue; }
+    long value = atol(line.c_str());
+    changed += std::to_string(value < 127 ? value + 1 : value - 1) + "\n";
+  }
+  long uploads = 0;
+  measure("/pec-upload.txt (POST)", iterations, [&]() -> WebResponse & {
+    return www.upload("/pec-upload.txt", "pec.txt", uploads++ % 2 == 0 ? changed : original);
+  });
+
+  benchPoller();
+  #ifdef HAS_METRICS_PLUGIN
+    checkScrape();
+    checkRange();
+    checkPush();
+  #endif
+  printStats();
+
+  if (limitsExceeded > 0) { fprintf(stderr, "bench: %d over the limits in %s\n", limitsExceeded, limitsFile); return 1; }
+  #ifdef HAS_METRICS_PLUGIN
+    if (metricsErrors > 0) { fprintf(stderr, "bench: %d metrics errors\n", metricsErrors); return 1; }
+  #endif
+  return 0;
+}
@@ -31,6 +31,12 @@
 #ifndef DISPLAY_SERVO_MONITOR
 #define DISPLAY_SERVO_MONITOR         OFF //    OFF, ON to display the servo monitor (any axis.)                              Option
 #endif
+#ifndef DISPLAY_SERVO_SAMPLE_RATE
+#define DISPLAY_SERVO_SAMPLE_RATE      50 //     50, n. Where n=10 to 200 (in Hz) servo monitor background sampling rate.     Infreq
+#endif
+#ifndef DISPLAY_OBJECT_CATALOG
+#define DISPLAY_OBJECT_CATALOG        OFF //    OFF, ON for an object catalog held in flash (LittleFS) with search.           Option
+#endif
 #ifndef DISPLAY_RESET_CONTROLS
 #define DISPLAY_RESET_CONTROLS         ON //     ON, ON to allow reset of OnStep, FWU for STM32 firmware upload pin HIGH.     Option
 #endif
@@ -42,6 +48,11 @@
 #define DISPLAY_HIGH_PRECISION_COORDS OFF //    OFF, ON for high precision coordinate display on status page.                 Infreq
 #endif
 
+// COMMAND CHANNEL TESTING -------------------------------------------------------------------------------------------------------
+#ifndef CMD_SIMULATE
+#define CMD_SIMULATE                  OFF //    OFF, ON adds /cmd-sim.txt to inject reply latency, jitter, and lost replies.  Infreq
+#endif
+
 // DRIVE CONFIGURATION -------------------------------------------------------------------------------------------------------------
 #ifndef DRIVE_CONFIGURATION
 #define DRIVE_CONFIGURATION            ON //    ON, to display/modify mount, rotator, focuser settings                        Option
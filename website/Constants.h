@@ -16,6 +16,15 @@
 #define AJAX_PAGE_UPDATE_FAST_SHED_MS 5000    // time before return to normal update rate
 #define AJAX_PAGE_LAZY_GET_MS         1000    // wait time for lazy get
 
+// auxiliary page, slider writes are coalesced and sent at most this often
+#define AUX_WRITE_COALESCE_MS         100
+
+// web server task, time to block between polls when no client is connected
+#define WEB_SERVER_IDLE_POLL_MS       10
+
+// object catalog, most objects held (a fifth of this without PSRAM)
+#define OBJECT_CATALOG_MAX_OBJECTS    10000
+
 // The settings below are for initialization only, afterward they are stored and recalled from EEPROM and must
 // be changed in the web interface OR with a reset (for initialization again) as described in the Config.h comments
 #define TIMEOUT_WEB                  200
@@ -3,43 +3,83 @@
 #include "Website.h"
 #include "Common.h"
 #include "pages/Pages.h"
+#include "libApp/servo/ServoMonitor.h"
+#include "libApp/catalog/ObjectCatalog.h"
+#include "../Plugins.config.h"
+
+#ifdef HAS_METRICS_PLUGIN
+  MetricsPlugin::Family *latencyMetric = NULL;
+#endif
 
 TaskHandle_t _webSvrTask;
 void pollWebSvr(void * parameter) {
+  for(;;) website.poll();
+}
+
+TaskHandle_t _statePollTask;
+void pollStateTask(void * parameter) {
   for(;;) {
-    www.handleClient();
+    #ifdef HAS_METRICS_PLUGIN
+      MetricsPlugin::HeapScope heapScope(HEAP_TAG_WEBSITE);
+    #endif
     state.poll();
+    vTaskDelay(pdMS_TO_TICKS(WEB_SERVER_IDLE_POLL_MS));
   }
 }
 
 void Website::init() {
   VLF("MSG: Website Plugin");
 
-  VLF("MSG: Set webpage handlers");
-  www.on("/index.htm", handleRoot);
-  www.on("/index-ajax-get.txt", indexAjaxGet);
-  www.on("/index.txt", indexAjax);
-
-  www.on("/mount.htm", handleMount);
-  www.on("/mount-ajax-get.txt", mountAjaxGet);
-  www.on("/mount-ajax.txt", mountAjax);
-  www.on("/libraryHelp.htm", handleLibraryHelp);
-
-  www.on("/rotator.htm", handleRotator);
-  www.on("/rotator-ajax-get.txt", rotatorAjaxGet);
-  www.on("/rotator-ajax.txt", rotatorAjax);
+  onStep.init();
 
-  www.on("/focuser.htm", handleFocuser);
-  www.on("/focuser-ajax-get.txt", focuserAjaxGet);
-  www.on("/focuser-ajax.txt", focuserAjax);
+  #if DISPLAY_OBJECT_CATALOG == ON
+    objectCatalog.init();
+  #endif
 
-  www.on("/auxiliary.htm", handleAux);
-  www.on("/auxiliary-ajax-get.txt", auxAjaxGet);
-  www.on("/auxiliary-ajax.txt", auxAjax);
-
-  www.on("/net.htm", handleNetwork);
-
-  www.on("/", handleRoot);
+  VLF("MSG: Set webpage handlers");
+  on("/index.htm", handleRoot);
+  on("/index-ajax-get.txt", indexAjaxGet);
+  on("/index.txt", indexAjax);
+
+  on("/mount.htm", handleMount);
+  on("/mount-ajax-get.txt", mountAjaxGet);
+  on("/mount-ajax.txt", mountAjax);
+  on("/libraryHelp.htm", handleLibraryHelp);
+  on("/catalog.txt", libraryCatalogDownload);
+  on("/catalog-upload.txt", libraryCatalogUpload, libraryCatalogUploadData);
+  on("/pec.txt", pecDownload);
+  on("/pec-upload.txt", pecUpload, pecUploadData);
+  #if DISPLAY_OBJECT_CATALOG == ON
+    on("/objects.txt", objectsFind);
+    on("/objects-upload.txt", objectsUpload, objectsUploadData);
+  #endif
+
+  on("/rotator.htm", handleRotator);
+  on("/rotator-ajax-get.txt", rotatorAjaxGet);
+  on("/rotator-ajax.txt", rotatorAjax);
+
+  on("/focuser.htm", handleFocuser);
+  on("/focuser-ajax-get.txt", focuserAjaxGet);
+  on("/focuser-ajax.txt", focuserAjax);
+
+  on("/auxiliary.htm", handleAux);
+  on("/auxiliary-ajax-get.txt", auxAjaxGet);
+  on("/auxiliary-ajax.txt", auxAjax);
+
+  on("/net.htm", handleNetwork);
+
+  on("/api/v1/state", handleApiState);
+
+  #if DISPLAY_SERVO_MONITOR == ON
+    on("/servo.bin", servoAjaxBinary);
+    on("/servo.csv", servoCsv);
+  #endif
+
+  #if CMD_SIMULATE == ON
+    on("/cmd-sim.txt", handleCmdSim);
+  #endif
+
+  on("/", handleRoot);
   
   www.onNotFound(handleNotFound);
 
@@ -56,10 +96,131 @@ void Website::init() {
 
   state.init();
 
+  #ifdef HAS_METRICS_PLUGIN
+    state.initMetrics();
+
+    metricsPlugin.addFamily("website_task_load", "Website server task CPU load", "gauge", {"unit"}, 1,
+      [this](MetricsPlugin::Family &f) { f.label(0, 0, "percent"); f.set(0, taskLoad*100.0F); });
+    metricsPlugin.addFamily("website_requests", "Website page and ajax requests served", "counter", {}, 1,
+      [this](MetricsPlugin::Family &f) { f.setInteger(0, requests); });
+    metricsPlugin.addFamily("website_request_time", "Website time spent serving requests", "counter", {"unit"}, 1,
+      [this](MetricsPlugin::Family &f) { f.label(0, 0, "seconds"); f.set(0, requestTime); });
+
+    // handlers are all registered by now so their number is fixed
+    metricsPlugin.addFamily("website_handler_requests", "Website requests served by handler", "counter", {"uri"}, handlerCount,
+      [this](MetricsPlugin::Family &f) {
+        for (int i = 0; i < f.count(); i++) { f.label(i, 0, handlerStats[i].uri); f.setInteger(i, handlerStats[i].requests); }
+      });
+    static const double latencyBounds[WEBSITE_LATENCY_BUCKETS] = WEBSITE_LATENCY_BOUNDS;
+    latencyMetric = metricsPlugin.addHistogram("website_handler_latency_seconds", "Website request latency by handler", {"uri"},
+      handlerCount, latencyBounds, WEBSITE_LATENCY_BUCKETS);
+    if (latencyMetric != NULL) for (int i = 0; i < handlerCount; i++) latencyMetric->label(i, 0, handlerStats[i].uri);
+    metricsPlugin.addFamily("website_handler_time", "Website time spent serving requests by handler", "counter", {"uri", "unit"}, handlerCount,
+      [this](MetricsPlugin::Family &f) {
+        for (int i = 0; i < f.count(); i++) { f.label(i, 0, handlerStats[i].uri); f.label(i, 1, "seconds"); f.set(i, handlerStats[i].time); }
+      });
+    metricsPlugin.addFamily("website_handler_commands", "Website LX200 commands issued by handler", "counter", {"uri"}, handlerCount,
+      [this](MetricsPlugin::Family &f) {
+        for (int i = 0; i < f.count(); i++) { f.label(i, 0, handlerStats[i].uri); f.setInteger(i, handlerStats[i].commands); }
+      });
+    metricsPlugin.addFamily("website_handler_heap_peak", "Website largest free heap drop during a request by handler", "gauge", {"uri", "unit"}, handlerCount,
+      [this](MetricsPlugin::Family &f) {
+        for (int i = 0; i < f.count(); i++) { f.label(i, 0, handlerStats[i].uri); f.label(i, 1, "bytes"); f.set(i, handlerStats[i].heapPeak); }
+      });
+  #endif
+
   VLF("MSG: Setup, starting web server FreeRTOS task (priority 1)");
   xTaskCreatePinnedToCore(pollWebSvr,"WebSvrTask", 10000, NULL, 1, &_webSvrTask, 0);
 
+  // state polling waits on many command replies, it runs separately so page requests
+  // that render from the State snapshot are not held up behind it
+  VLF("MSG: Setup, starting state polling FreeRTOS task (priority 1)");
+  xTaskCreatePinnedToCore(pollStateTask,"StatePollTask", 8000, NULL, 1, &_statePollTask, 0);
+
+  #if DISPLAY_SERVO_MONITOR == ON
+    servoMonitor.init();
+  #endif
+
   VLF("MSG: Website Plugin ready");
 }
 
+void Website::on(const char *uri, void (*handler)()) {
+  WebsiteHandlerStats *stats = addHandlerStats(uri);
+  www.on(uri, [this, stats, handler]() { serve(stats, handler); });
+}
+
+void Website::on(const char *uri, void (*handler)(), void (*uploadHandler)()) {
+  WebsiteHandlerStats *stats = addHandlerStats(uri);
+  www.on(uri, HTTP_POST, [this, stats, handler]() { serve(stats, handler); }, [this, stats, uploadHandler]() { serve(stats, uploadHandler, true); });
+}
+
+WebsiteHandlerStats *Website::addHandlerStats(const char *uri) {
+  if (handlerCount >= WEBSITE_HANDLERS_MAX) { DLF("WRN: Website, handler stats table full"); return NULL; }
+  WebsiteHandlerStats *stats = &handlerStats[handlerCount++];
+  memset(stats, 0, sizeof(WebsiteHandlerStats));
+  stats->uri = uri;
+  return stats;
+}
+
+// handlers take the state lock themselves, only while they format state values (never across a command)
+void Website::serve(WebsiteHandlerStats *stats, void (*handler)(), bool upload) {
+  // only commands from this task are counted, the state poller's are not
+  onStep.setCountTask(xTaskGetCurrentTaskHandle());
+  unsigned long startCommands = onStep.taskCommands;
+  uint32_t startHeap = ESP.getFreeHeap();
+  uint32_t startMinHeap = ESP.getMinFreeHeap();
+  unsigned long startTime = micros();
+
+  handler();
+
+  unsigned long elapsed = micros() - startTime;
+  requestTime += elapsed/1000000.0;
+
+  // the time spent on an upload's pieces is added to its request's latency, only one request is served at a time
+  #ifdef HAS_METRICS_PLUGIN
+    unsigned long latency = elapsed + uploadTime;
+  #endif
+  if (upload) uploadTime += elapsed; else { uploadTime = 0; requests++; }
+
+  if (stats == NULL) return;
+  if (!upload) stats->requests++;
+  stats->time += elapsed/1000000.0;
+  stats->commands += onStep.taskCommands - startCommands;
+
+  // the low water mark only shows the peak when this request set a new one, otherwise the end value is used
+  uint32_t lowHeap = ESP.getFreeHeap();
+  uint32_t minHeap = ESP.getMinFreeHeap();
+  if (minHeap < startMinHeap && minHeap < lowHeap) lowHeap = minHeap;
+  long heapDrop = (long)startHeap - (long)lowHeap;
+  if (heapDrop > stats->heapPeak) stats->heapPeak = heapDrop;
+
+  #ifdef HAS_METRICS_PLUGIN
+    if (!upload && latencyMetric != NULL) latencyMetric->observe(stats - handlerStats, latency/1000000.0);
+  #endif
+}
+
+void Website::poll() {
+  #ifdef HAS_METRICS_PLUGIN
+    MetricsPlugin::HeapScope heapScope(HEAP_TAG_WEBSITE);
+  #endif
+  unsigned long startTime = micros();
+
+  www.handleClient();
+  auxFlush();
+  bool clientActive = www.client().connected();
+
+  // keep a running measure of the fraction of time this task is busy
+  busyTime += micros() - startTime;
+  unsigned long windowTime = micros() - loadWindowStart;
+  if (windowTime >= 1000000UL) {
+    taskLoad = (float)busyTime/windowTime;
+    busyTime = 0;
+    loadWindowStart = micros();
+  }
+
+  // with no client being served block until the next poll tick, new connections wait in the
+  // lwIP accept backlog meanwhile so this leaves core 0 to WiFi and the command channels
+  if (!clientActive) vTaskDelay(pdMS_TO_TICKS(WEB_SERVER_IDLE_POLL_MS)); else taskYIELD();
+}
+
 Website website;
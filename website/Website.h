@@ -5,6 +5,21 @@
     #error "Configuration (Config.h): The website plugin requires SERIAL_RADIO be set to WIFI_STATION or WIFI_ACCESS_POINT"
 #endif
 
+// most handlers that can be registered and instrumented
+#define WEBSITE_HANDLERS_MAX 48
+
+// request latency histogram bucket upper bounds in seconds, plus a last bucket for anything slower
+#define WEBSITE_LATENCY_BUCKETS 8
+#define WEBSITE_LATENCY_BOUNDS {0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0}
+
+typedef struct WebsiteHandlerStats {
+  const char *uri;
+  unsigned long requests;
+  double time;                                      // total time serving requests in seconds
+  unsigned long commands;                           // LX200 commands issued while serving requests
+  long heapPeak;                                    // largest drop in free heap seen during a request in bytes
+} WebsiteHandlerStats;
+
 class Website {
 public:
   // the initialization method must be present and named: void init();
@@ -12,7 +27,35 @@ public:
 
   void loop();
 
+  // handle web clients, called continuously by the web server task
+  void poll();
+
+  // fraction of time (0 to 1) the web server task was busy over the last second
+  float taskLoad = 0.0F;
+
+  // requests served and total time spent serving them (in seconds)
+  unsigned long requests = 0;
+  double requestTime = 0.0;
+
+  // per handler request counts, latency, commands issued and heap use
+  WebsiteHandlerStats handlerStats[WEBSITE_HANDLERS_MAX];
+  int handlerCount = 0;
+
 private:
+  // register a page handler with the web server, counting and timing the requests it serves
+  void on(const char *uri, void (*handler)());
+  // register a POST handler whose body is passed to uploadHandler in pieces as it arrives
+  void on(const char *uri, void (*handler)(), void (*uploadHandler)());
+
+  // get stats for a handler being registered, NULL if the table is full
+  WebsiteHandlerStats *addHandlerStats(const char *uri);
+
+  // call a handler, recording its stats; upload handler calls are counted with the request they belong to
+  void serve(WebsiteHandlerStats *stats, void (*handler)(), bool upload = false);
+
+  unsigned long busyTime = 0;
+  unsigned long uploadTime = 0;
+  unsigned long loadWindowStart = 0;
 
 };
 
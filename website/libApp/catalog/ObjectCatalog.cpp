@@ -0,0 +1,368 @@
+// -----------------------------------------------------------------------------------
+// Object catalog, held on flash (LittleFS) with name and declination band indexes
+#include "ObjectCatalog.h"
+
+#if DISPLAY_OBJECT_CATALOG == ON
+
+#include <LittleFS.h>
+
+// file layout: header, objects sorted by declination then RA, band start indexes, name index
+typedef struct ObjectCatalogHeader {
+  char magic[4];
+  uint16_t version;
+  uint16_t count;
+} ObjectCatalogHeader;
+
+const char *_objectCategory[] = {
+  "UNK", "OC", "GC", "PN", "DN", "SG", "EG", "IG", "KNT", "SNR", "GAL", "CN", "STR", "PLA", "CMT", "AST"
+};
+#define OBJECT_CATEGORY_COUNT 16
+
+// allocate in PSRAM when present
+void *objectCatalogAlloc(size_t size) {
+  void *p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+  if (p == NULL) p = malloc(size);
+  return p;
+}
+
+// the declination band (0 to 180) an object is in
+inline int objectBand(int32_t dec) {
+  int band = (int)floor(dec/360000.0) + 90;
+  if (band < 0) band = 0;
+  if (band > OBJECT_CATALOG_BANDS - 1) band = OBJECT_CATALOG_BANDS - 1;
+  return band;
+}
+
+// compare object names ignoring case and spaces, a prefix sorts before the names it starts
+int objectNameCompare(const char *a, int aLength, const char *b, int bLength) {
+  int i = 0, j = 0;
+  while (true) {
+    while (i < aLength && a[i] == ' ') i++;
+    while (j < bLength && b[j] == ' ') j++;
+    bool aEnd = i >= aLength || a[i] == 0;
+    bool bEnd = j >= bLength || b[j] == 0;
+    if (aEnd || bEnd) return (int)bEnd - (int)aEnd;
+    int d = toupper(a[i]) - toupper(b[j]);
+    if (d != 0) return d;
+    i++; j++;
+  }
+}
+
+bool objectNameStartsWith(const char *name, const char *prefix) {
+  int i = 0, j = 0;
+  while (true) {
+    while (i < 14 && name[i] == ' ') i++;
+    while (prefix[j] == ' ') j++;
+    if (prefix[j] == 0) return true;
+    if (i >= 14 || name[i] == 0 || toupper(name[i]) != toupper(prefix[j])) return false;
+    i++; j++;
+  }
+}
+
+CatalogObject *_sortObjects;
+
+int objectPositionSort(const void *a, const void *b) {
+  const CatalogObject *oa = (const CatalogObject*)a, *ob = (const CatalogObject*)b;
+  if (oa->dec != ob->dec) return oa->dec < ob->dec ? -1 : 1;
+  if (oa->ra != ob->ra) return oa->ra < ob->ra ? -1 : 1;
+  return 0;
+}
+
+int objectNameSort(const void *a, const void *b) {
+  return objectNameCompare(_sortObjects[*(const uint16_t*)a].name, 14, _sortObjects[*(const uint16_t*)b].name, 14);
+}
+
+void ObjectCatalog::init() {
+  // the partition may hold other files, so one that doesn't mount is reported rather than formatted
+  if (!LittleFS.begin(false)) { DLF("WRN: Object catalog, LittleFS mount failed (not formatted?)"); return; }
+
+  capacity = psramFound() ? OBJECT_CATALOG_MAX_OBJECTS : OBJECT_CATALOG_MAX_OBJECTS/5;
+  ready = true;
+
+  if (load()) { VF("MSG: Object catalog, loaded "); V(objectCount); VLF(" objects"); } else VLF("MSG: Object catalog, none loaded");
+}
+
+bool ObjectCatalog::load() {
+  File file = LittleFS.open(OBJECT_CATALOG_FILE, "r");
+  if (!file) return false;
+
+  ObjectCatalogHeader header;
+  if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      strncmp(header.magic, "OSXO", 4) != 0 || header.version != OBJECT_CATALOG_VERSION ||
+      header.count == 0 || header.count > capacity) { file.close(); return false; }
+
+  size_t listSize = header.count*sizeof(CatalogObject);
+  size_t namesSize = header.count*sizeof(uint16_t);
+  CatalogObject *list = (CatalogObject*)objectCatalogAlloc(listSize);
+  uint16_t *names = (uint16_t*)objectCatalogAlloc(namesSize);
+  uint16_t bands[OBJECT_CATALOG_BANDS + 1];
+
+  if (list == NULL || names == NULL ||
+      file.read((uint8_t*)list, listSize) != listSize ||
+      file.read((uint8_t*)bands, sizeof(bands)) != sizeof(bands) ||
+      file.read((uint8_t*)names, namesSize) != namesSize) {
+    free(list);
+    free(names);
+    file.close();
+    return false;
+  }
+  file.close();
+
+  free(objects);
+  free(nameIndex);
+  objects = list;
+  nameIndex = names;
+  memcpy(bandStart, bands, sizeof(bandStart));
+  objectCount = header.count;
+  return true;
+}
+
+int ObjectCatalog::find(const char *prefix, int *results, int max) {
+  if (objectCount == 0) return 0;
+
+  // binary search for the first name not less than the prefix
+  int prefixLength = strlen(prefix);
+  int lo = 0, hi = objectCount;
+  while (lo < hi) {
+    int mid = (lo + hi)/2;
+    if (objectNameCompare(objects[nameIndex[mid]].name, 14, prefix, prefixLength) < 0) lo = mid + 1; else hi = mid;
+  }
+
+  int found = 0;
+  for (int i = lo; i < objectCount && found < max; i++) {
+    if (!objectNameStartsWith(objects[nameIndex[i]].name, prefix)) break;
+    results[found++] = nameIndex[i];
+  }
+  return found;
+}
+
+int ObjectCatalog::nearest(double ra, double dec, float magnitudeLimit, int category) {
+  if (objectCount == 0 || isnan(ra) || isnan(dec)) return -1;
+
+  int magnitude = lroundf(magnitudeLimit*10.0F);
+  float ra1 = ra*(float)(M_PI/12.0);
+  float sinDec1 = sinf(dec*(float)(M_PI/180.0));
+  float cosDec1 = cosf(dec*(float)(M_PI/180.0));
+
+  int best = -1;
+  float bestDot = -2.0F;
+  float bestDistance = 360.0F;
+  int band0 = objectBand(lround(dec*360000.0));
+
+  // search outward a band at a time until no closer object is possible
+  for (int d = 0; d < OBJECT_CATALOG_BANDS; d++) {
+    if (best >= 0 && d - 1 > bestDistance) break;
+    for (int side = 0; side < (d == 0 ? 1 : 2); side++) {
+      int band = side == 0 ? band0 - d : band0 + d;
+      if (band < 0 || band >= OBJECT_CATALOG_BANDS) continue;
+
+      for (int i = bandStart[band]; i < bandStart[band + 1]; i++) {
+        const CatalogObject *o = &objects[i];
+        if (o->magnitude == OBJECT_MAGNITUDE_UNKNOWN || o->magnitude > magnitude) continue;
+        if (category >= 0 && o->category != category) continue;
+
+        float dec2 = o->dec*(float)(M_PI/(180.0*360000.0));
+        float ra2 = o->ra*(float)(M_PI/43200000.0);
+        float dot = sinDec1*sinf(dec2) + cosDec1*cosf(dec2)*cosf(ra1 - ra2);
+        if (dot > bestDot) {
+          bestDot = dot;
+          best = i;
+          bestDistance = acosf(bestDot > 1.0F ? 1.0F : bestDot)*(float)(180.0/M_PI);
+        }
+      }
+    }
+  }
+  return best;
+}
+
+const char *ObjectCatalog::categoryName(int category) {
+  if (category < 0 || category >= OBJECT_CATEGORY_COUNT) category = 0;
+  return _objectCategory[category];
+}
+
+int ObjectCatalog::categoryIndex(const char *name) {
+  for (int i = 0; i < OBJECT_CATEGORY_COUNT; i++) if (strcmp(name, _objectCategory[i]) == 0) return i;
+  return -1;
+}
+
+void ObjectCatalog::formatRa(const CatalogObject *object, char *ra) {
+  long s = ((object->ra + 500)/1000) % 86400;
+  sprintf(ra, "%02ld:%02ld:%02ld", s/3600, (s/60) % 60, s % 60);
+}
+
+void ObjectCatalog::formatDec(const CatalogObject *object, char *dec) {
+  long s = labs(lround(object->dec/100.0));
+  sprintf(dec, "%c%02ld*%02ld:%02ld", object->dec < 0 ? '-' : '+', s/3600, (s/60) % 60, s % 60);
+}
+
+bool ObjectCatalog::importBegin() {
+  importAbort();
+  importCount = 0;
+  importError = "";
+  if (!ready) { importError = L_OBJ_WRITE_FAIL; return false; }
+
+  // without PSRAM there isn't room for two catalogs, the one loaded is let go for the import and
+  // read back from flash if the import doesn't complete
+  if (!psramFound() && objects != NULL) {
+    free(objects);
+    free(nameIndex);
+    objects = NULL;
+    nameIndex = NULL;
+    objectCount = 0;
+    released = true;
+  }
+
+  importObjects = (CatalogObject*)objectCatalogAlloc(capacity*sizeof(CatalogObject));
+  if (importObjects == NULL) { importError = L_OBJ_NO_MEMORY; return false; }
+  return true;
+}
+
+// Object Name  |Cat|---RA---|---Dec---|Mag
+// cccccccccccccc,ccc,HH:MM:SS,sDD*MM:SS,n.n
+// the magnitude is optional, blank lines and lines starting with $ or # are skipped
+bool ObjectCatalog::importLine(const char *line) {
+  if (importObjects == NULL) return false;
+
+  while (*line == ' ') line++;
+  if (*line == 0 || *line == '$' || *line == '#') return true;
+
+  char field[5][16];
+  int fields = 0;
+  while (fields < 5) {
+    const char *end = strchr(line, ',');
+    int length = end == NULL ? strlen(line) : end - line;
+    while (length > 0 && line[0] == ' ') { line++; length--; }
+    while (length > 0 && line[length - 1] == ' ') length--;
+    if (length > 15) length = 15;
+    memcpy(field[fields], line, length);
+    field[fields][length] = 0;
+    fields++;
+    if (end == NULL) break;
+    line = end + 1;
+  }
+  if (fields < 4) { importError = L_CAT_BAD_FORM; return false; }
+
+  if (importCount >= capacity) { importError = L_OBJ_TOO_MANY; return false; }
+  CatalogObject *o = &importObjects[importCount];
+
+  int length = strlen(field[0]);
+  if (length < 1 || length > 14) { importError = L_CAT_UPLOAD_BAD_OBJECT_NAME; return false; }
+  memset(o->name, 0, sizeof(o->name));
+  memcpy(o->name, field[0], length);
+
+  int category = categoryIndex(field[1]);
+  if (category < 0) { importError = L_CAT_BAD_CATEGORY; return false; }
+  o->category = category;
+
+  double ra, dec;
+  if (!convert.hmsToDouble(&ra, field[2]) || ra < 0.0 || ra >= 24.0) { importError = L_CAT_BAD_RA; return false; }
+  if (!convert.dmsToDouble(&dec, field[3], true) || dec < -90.0 || dec > 90.0) { importError = L_CAT_BAD_DEC; return false; }
+  o->ra = lround(ra*3600000.0) % 86400000L;
+  o->dec = lround(dec*360000.0);
+
+  o->magnitude = OBJECT_MAGNITUDE_UNKNOWN;
+  if (fields > 4 && field[4][0] != 0) {
+    char *end;
+    double magnitude = strtod(field[4], &end);
+    if (end == field[4] || magnitude < -12.0 || magnitude > 12.6) { importError = L_CAT_BAD_FORM; return false; }
+    o->magnitude = lround(magnitude*10.0);
+  }
+
+  importCount++;
+  return true;
+}
+
+void ObjectCatalog::buildIndexes(CatalogObject *list, int count, uint16_t *bands, uint16_t *names) {
+  qsort(list, count, sizeof(CatalogObject), objectPositionSort);
+
+  int i = 0;
+  for (int band = 0; band < OBJECT_CATALOG_BANDS; band++) {
+    bands[band] = i;
+    while (i < count && objectBand(list[i].dec) == band) i++;
+  }
+  bands[OBJECT_CATALOG_BANDS] = count;
+
+  for (i = 0; i < count; i++) names[i] = i;
+  _sortObjects = list;
+  qsort(names, count, sizeof(uint16_t), objectNameSort);
+}
+
+bool ObjectCatalog::importEnd() {
+  if (importObjects == NULL) return false;
+
+  // the list was allocated to hold a full catalog, what the upload didn't use is given back before it's kept
+  if (importCount > 0 && importCount < capacity) {
+    CatalogObject *list = (CatalogObject*)realloc(importObjects, importCount*sizeof(CatalogObject));
+    if (list != NULL) importObjects = list;
+  }
+
+  uint16_t bands[OBJECT_CATALOG_BANDS + 1];
+  uint16_t *names = NULL;
+  if (importCount > 0) {
+    names = (uint16_t*)objectCatalogAlloc(importCount*sizeof(uint16_t));
+    if (names == NULL) { importError = L_OBJ_NO_MEMORY; importAbort(); return false; }
+    buildIndexes(importObjects, importCount, bands, names);
+  }
+
+  // an empty upload removes the catalog, otherwise it's written beside the old file which is replaced only once complete
+  if (importCount == 0) {
+    LittleFS.remove(OBJECT_CATALOG_FILE);
+  } else {
+    ObjectCatalogHeader header;
+    memcpy(header.magic, "OSXO", 4);
+    header.version = OBJECT_CATALOG_VERSION;
+    header.count = importCount;
+
+    size_t listSize = importCount*sizeof(CatalogObject);
+    size_t namesSize = importCount*sizeof(uint16_t);
+    File file = LittleFS.open(OBJECT_CATALOG_NEW_FILE, "w");
+    bool success = file &&
+      file.write((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+      file.write((uint8_t*)importObjects, listSize) == listSize &&
+      file.write((uint8_t*)bands, sizeof(bands)) == sizeof(bands) &&
+      file.write((uint8_t*)names, namesSize) == namesSize;
+    if (file) file.close();
+    if (success) {
+      LittleFS.remove(OBJECT_CATALOG_FILE);
+      success = LittleFS.rename(OBJECT_CATALOG_NEW_FILE, OBJECT_CATALOG_FILE);
+    }
+    if (!success) {
+      LittleFS.remove(OBJECT_CATALOG_NEW_FILE);
+      importError = L_OBJ_WRITE_FAIL;
+      free(names);
+      importAbort();
+      return false;
+    }
+  }
+
+  free(objects);
+  free(nameIndex);
+  objectCount = importCount;
+  if (objectCount > 0) {
+    objects = importObjects;
+    nameIndex = names;
+    memcpy(bandStart, bands, sizeof(bandStart));
+  } else {
+    free(importObjects);
+    objects = NULL;
+    nameIndex = NULL;
+  }
+  importObjects = NULL;
+  released = false;
+
+  VF("MSG: Object catalog, imported "); V(objectCount); VLF(" objects");
+  return true;
+}
+
+void ObjectCatalog::importAbort() {
+  free(importObjects);
+  importObjects = NULL;
+  if (released) {
+    released = false;
+    if (load()) { VF("MSG: Object catalog, reloaded "); V(objectCount); VLF(" objects"); }
+  }
+}
+
+ObjectCatalog objectCatalog;
+
+#endif
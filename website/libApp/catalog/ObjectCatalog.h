@@ -0,0 +1,78 @@
+// -----------------------------------------------------------------------------------
+// Object catalog, held on flash (LittleFS) with name and declination band indexes
+#pragma once
+
+#include "../../Common.h"
+
+#if DISPLAY_OBJECT_CATALOG == ON
+
+#define OBJECT_CATALOG_FILE        "/objects.bin"
+#define OBJECT_CATALOG_NEW_FILE    "/objects.new"
+#define OBJECT_CATALOG_VERSION     1
+#define OBJECT_CATALOG_BANDS       181      // one degree declination bands, -90 to +90
+#define OBJECT_MAGNITUDE_UNKNOWN   127
+
+typedef struct CatalogObject {
+  char name[14];        // zero terminated unless all 14 characters are used
+  uint8_t category;     // index into the category names (UNK, OC, GC, ...)
+  int8_t magnitude;     // in 0.1 magnitude units, OBJECT_MAGNITUDE_UNKNOWN if unknown
+  uint32_t ra;          // in milliseconds of time, 0 to 86399999
+  int32_t dec;          // in 0.01 arc-seconds, -32400000 to 32400000
+} CatalogObject;
+
+class ObjectCatalog {
+  public:
+    // mount the file system and load the catalog
+    void init();
+
+    // number of objects in the catalog
+    inline int count() { return objectCount; }
+
+    // get an object, i must be 0 to count() - 1
+    inline const CatalogObject *object(int i) { return &objects[i]; }
+
+    // find up to max objects whose name starts with prefix (ignoring case and spaces), in name order
+    // returns the number found
+    int find(const char *prefix, int *results, int max);
+
+    // find the object nearest ra (hours) and dec (degrees) that is at least as bright as magnitudeLimit,
+    // optionally only of one category (-1 for any), returns the object index or -1 if none
+    int nearest(double ra, double dec, float magnitudeLimit, int category = -1);
+
+    // get the name of a category or its index (-1 if unknown)
+    const char *categoryName(int category);
+    int categoryIndex(const char *name);
+
+    // format an object's coordinates for the :Sr and :Sd commands
+    void formatRa(const CatalogObject *object, char *ra);
+    void formatDec(const CatalogObject *object, char *dec);
+
+    // import a catalog given as text lines one at a time, the new catalog replaces the old one
+    // only when importEnd() succeeds; on failure the reason is in importError
+    // without PSRAM the old catalog isn't searchable during the import, it's reloaded if the import fails
+    bool importBegin();
+    bool importLine(const char *line);
+    bool importEnd();
+    void importAbort();
+    int importCount = 0;
+    const char *importError = "";
+
+  private:
+    void buildIndexes(CatalogObject *list, int count, uint16_t *bands, uint16_t *names);
+    bool load();
+
+    bool ready = false;
+    bool released = false;
+    int capacity = 0;
+
+    CatalogObject *objects = NULL;
+    int objectCount = 0;
+    uint16_t bandStart[OBJECT_CATALOG_BANDS + 1];
+    uint16_t *nameIndex = NULL;
+
+    CatalogObject *importObjects = NULL;
+};
+
+extern ObjectCatalog objectCatalog;
+
+#endif
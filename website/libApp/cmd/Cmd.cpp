@@ -4,16 +4,58 @@
 #include "Cmd.h"
 #include "../../locales/Locale.h"
 #include "../../../../libApp/commands/ProcessCmds.h"
+#include "../../../Plugins.config.h"
 
 int webTimeout = TIMEOUT_WEB;
 int cmdTimeout = TIMEOUT_CMD;
 
+#ifdef HAS_METRICS_PLUGIN
+  static int metricsChannel = -1;
+#endif
+
+void OnStepCmd::init() {
+  if (mutex == NULL) mutex = xSemaphoreCreateRecursiveMutex();
+  #ifdef HAS_METRICS_PLUGIN
+    if (metricsChannel < 0) metricsChannel = metricsPlugin.addCommandChannel("website");
+  #endif
+}
+
+void OnStepCmd::lock() {
+  if (mutex != NULL) xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+}
+
+void OnStepCmd::unlock() {
+  if (mutex != NULL) xSemaphoreGiveRecursive(mutex);
+}
+
 void OnStepCmd::serialRecvFlush() {
-  while (SERIAL_ONSTEP.available() > 0) SERIAL_ONSTEP.read();
+  if (mutex != NULL) xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  int discarded = 0;
+  while (SERIAL_ONSTEP.available() > 0) { SERIAL_ONSTEP.read(); discarded++; }
+  if (mutex != NULL) xSemaphoreGiveRecursive(mutex);
+  #ifdef HAS_METRICS_PLUGIN
+    metricsPlugin.commandDiscarded(metricsChannel, discarded);
+  #endif
 }
 
 // smart LX200 aware command and response (up to 80 chars) over serial
 bool OnStepCmd::processCommand(const char* cmd, char* response, long timeOutMs) {
+  if (countTask != NULL && xTaskGetCurrentTaskHandle() == countTask) taskCommands++;
+  if (cmd[0] == ':' && cmd[1] == 'S' && cmd[2] == 'X' && (cmd[3] == 'A' || cmd[3] == 'E')) axisWrites++;
+  if (mutex != NULL) xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  #ifdef HAS_METRICS_PLUGIN
+    // timed once the channel is held, so the latency is OnStep's and not the wait for another task's commands
+    unsigned long startTime = micros();
+  #endif
+  bool success = processCommandUnlocked(cmd, response, timeOutMs);
+  #ifdef HAS_METRICS_PLUGIN
+    metricsPlugin.commandDone(metricsChannel, cmd, micros() - startTime, !success);
+  #endif
+  if (mutex != NULL) xSemaphoreGiveRecursive(mutex);
+  return success;
+}
+
+bool OnStepCmd::processCommandUnlocked(const char* cmd, char* response, long timeOutMs) {
   SERIAL_ONSTEP.setTimeout(timeOutMs);
 
   // clear the read/write buffers
@@ -23,6 +65,11 @@ bool OnStepCmd::processCommand(const char* cmd, char* response, long timeOutMs)
   SERIAL_ONSTEP.transmit(cmd);
   delay(0);
 
+  #if CMD_SIMULATE == ON
+    if (simLatencyMs > 0 || simJitterMs > 0) delay(simLatencyMs + (simJitterMs > 0 ? esp_random() % (simJitterMs + 1) : 0));
+    bool simDrop = simDropPercent > 0 && (int)(esp_random() % 100) < simDropPercent;
+  #endif
+
   response[0] = 0;
   bool noResponse = false;
   bool shortResponse = false;
@@ -104,10 +151,19 @@ bool OnStepCmd::processCommand(const char* cmd, char* response, long timeOutMs)
     if (cmd[0] == ';') { noResponse = false; shortResponse = false; }
   }
 
+  #if CMD_SIMULATE == ON
+    if (simDrop && !noResponse) {
+      delay(timeOutMs);
+      serialRecvFlush();
+      simDropped++;
+      return false;
+    }
+  #endif
+
   unsigned long timeout = millis() + (unsigned long)timeOutMs;
   if (noResponse) {
     response[0] = 0;
-    delay(50);
+    if (!noWait) delay(50);
     return true;
   } else
   if (shortResponse) {
@@ -149,6 +205,16 @@ bool OnStepCmd::commandBlind(const char* command) {
   return processCommand(command, response, webTimeout);
 }
 
+bool OnStepCmd::commandBlindNoWait(const char* command) {
+  char response[80] = "";
+  lock();
+  noWait = true;
+  bool success = processCommand(command, response, webTimeout);
+  noWait = false;
+  unlock();
+  return success;
+}
+
 bool OnStepCmd::commandEcho(const char* command) {
   char response[80] = "";
   char c[40] = "";
@@ -8,8 +8,22 @@
 
 class OnStepCmd {
   public:
+    // create the lock that lets the web server and state polling tasks share the command channel
+    void init();
+
     void serialRecvFlush();
 
+    // count the commands issued by this task in taskCommands, so they can be attributed to page requests
+    inline void setCountTask(TaskHandle_t task) { countTask = task; }
+    volatile unsigned long taskCommands = 0;
+
+    // axis settings commands (:SXA, :SXE) sent, so settings kept by the pages know to reload
+    volatile unsigned long axisWrites = 0;
+
+    // hold the command channel across a series of commands (may be nested)
+    void lock();
+    void unlock();
+
     // low level smart LX200 aware command and response (up to 80 chars) over serial (includes any '#' frame char)
     bool processCommand(const char* cmd, char* response, long timeOutMs);
 
@@ -19,6 +33,10 @@ class OnStepCmd {
     // send command to OnStep, expects no reply
     bool commandBlind(const char* command);
 
+    // send command to OnStep, expects no reply and returns without the settling delay; OnStep takes commands
+    // in order so the next command with a reply is only answered once this one is done
+    bool commandBlindNoWait(const char* command);
+
     // send command to OnStep for debugging, expects a boolean reply
     bool commandEcho(const char* command);
 
@@ -31,7 +49,21 @@ class OnStepCmd {
     // turns OnStep command error number into descriptive string
     char* commandErrorToStr(int e);
 
+    #if CMD_SIMULATE == ON
+      // for benchmarks, added reply latency and up to simJitterMs more at random (in ms) and the percentage
+      // of replies lost (the command still runs but the caller waits out the timeout)
+      int simLatencyMs = 0;
+      int simJitterMs = 0;
+      int simDropPercent = 0;
+      unsigned long simDropped = 0;
+    #endif
+
   private:
+    bool processCommandUnlocked(const char* cmd, char* response, long timeOutMs);
+
+    SemaphoreHandle_t mutex = NULL;
+    TaskHandle_t countTask = NULL;
+    bool noWait = false;
 };
 
 // timeout period for the web
@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------------
+// Servo monitor, samples servo delta and power in the background
+#include "ServoMonitor.h"
+
+#if DISPLAY_SERVO_MONITOR == ON
+
+#include "../cmd/Cmd.h"
+#include "../status/State.h"
+
+TaskHandle_t _servoMonitorTask;
+void pollServoMonitor(void * parameter) {
+  TickType_t lastWake = xTaskGetTickCount();
+  TickType_t period = pdMS_TO_TICKS(1000/servoMonitor.rate);
+  if (period < 1) period = 1;
+  for(;;) {
+    servoMonitor.poll();
+    vTaskDelayUntil(&lastWake, period);
+  }
+}
+
+void ServoMonitor::init() {
+  size = SERVO_MONITOR_BUFFER_SAMPLES;
+  buffer = (ServoSample*)heap_caps_malloc(size*sizeof(ServoSample), MALLOC_CAP_SPIRAM);
+  if (buffer == NULL) {
+    size = SERVO_MONITOR_BUFFER_SAMPLES/4;
+    buffer = (ServoSample*)malloc(size*sizeof(ServoSample));
+  }
+  if (buffer == NULL) { DLF("WRN: Servo monitor, buffer allocation failed"); size = 0; return; }
+
+  VF("MSG: Servo monitor, starting sampler FreeRTOS task at "); V(rate); VF("Hz, buffer of "); V(size); VLF(" samples");
+  xTaskCreatePinnedToCore(pollServoMonitor, "ServoMonTask", 3000, NULL, 1, &_servoMonitorTask, 0);
+}
+
+void ServoMonitor::poll() {
+  int axis = this->axis;
+  if (axis != sampledAxis) { sampledAxis = axis; head = 0; }
+
+  // only sample while an axis is selected and the controller page is being viewed
+  if (axis < 1 || axis > 9 || millis() - state.lastControllerPageLoadTime > 2000) return;
+
+  char command[10], response[80];
+  snprintf(command, sizeof(command), ":GXS%d#", axis);
+  if (!onStep.command(command, response)) return;
+
+  char *powerStr = strchr(response, ',');
+  if (powerStr == NULL) return;
+  powerStr[0] = 0;
+  powerStr++;
+
+  ServoSample *sample = &buffer[head % size];
+  sample->time = millis();
+  sample->delta = atol(response);
+  sample->power = lround(atof(powerStr)*10.0);
+  sample->axis = axis;
+  head++;
+}
+
+int ServoMonitor::read(uint32_t *from, ServoSample *samples, int count) {
+  if (size == 0) return 0;
+
+  // keep clear of the samples about to be overwritten
+  uint32_t last = head;
+  uint32_t oldest = last > (uint32_t)size - 8 ? last - (size - 8) : 0;
+  if (*from < oldest || *from > last) *from = oldest;
+
+  int n = 0;
+  for (uint32_t i = *from; i < last && n < count; i++) samples[n++] = buffer[i % size];
+  return n;
+}
+
+ServoMonitor servoMonitor;
+
+#endif
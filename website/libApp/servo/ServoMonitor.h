@@ -0,0 +1,58 @@
+// -----------------------------------------------------------------------------------
+// Servo monitor, samples servo delta and power in the background
+#pragma once
+
+#include "../../Common.h"
+
+#if DISPLAY_SERVO_MONITOR == ON
+
+#if DISPLAY_SERVO_SAMPLE_RATE < 10 || DISPLAY_SERVO_SAMPLE_RATE > 200
+  #error "Configuration (Config.h): DISPLAY_SERVO_SAMPLE_RATE must be in the range 10 to 200 (Hz)"
+#endif
+
+// ring buffer size in samples, allocated in PSRAM when present (otherwise a quarter this size in the heap)
+#ifndef SERVO_MONITOR_BUFFER_SAMPLES
+#define SERVO_MONITOR_BUFFER_SAMPLES 8192
+#endif
+
+typedef struct ServoSample {
+  uint32_t time;   // in milliseconds
+  int32_t delta;   // in steps
+  int16_t power;   // in 0.1% units
+  uint8_t axis;    // 1 to 9
+} ServoSample;
+
+class ServoMonitor {
+  public:
+    void init();
+
+    // sample the servo, called continuously by the servo monitor task
+    void poll();
+
+    // axis to sample (1 to 9), 0 to stop sampling; the sampler clears the ring buffer when it sees the
+    // change so only its task writes to the ring, until then the samples held are of the axis before
+    inline void setAxis(int axis) { this->axis = axis; }
+    inline int getAxis() { return axis; }
+
+    // sequence number of the next sample to be recorded
+    inline uint32_t next() { return head; }
+
+    // copy up to count samples starting at sequence number from (or the oldest still held), returns the number copied
+    int read(uint32_t *from, ServoSample *samples, int count);
+
+    // number of samples the ring buffer holds
+    inline int capacity() { return size; }
+
+    const int rate = DISPLAY_SERVO_SAMPLE_RATE;
+
+  private:
+    ServoSample *buffer = NULL;
+    int size = 0;
+    volatile uint32_t head = 0;
+    volatile int axis = 0;
+    int sampledAxis = 0;
+};
+
+extern ServoMonitor servoMonitor;
+
+#endif
@@ -5,29 +5,46 @@
 #include "../cmd/Cmd.h"
 
 void pollState() { state.poll(); }
-void pollStateSlow() { state.pollSlow(); }
-void pollStateFast() { state.pollFast(); }
 
 void State::init()
 {
+  if (mutex == NULL) mutex = xSemaphoreCreateRecursiveMutex();
   status.update();
 }
 
+void State::lock() {
+  if (mutex != NULL) xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+}
+
+void State::unlock() {
+  if (mutex != NULL) xSemaphoreGiveRecursive(mutex);
+}
+
+// each part takes the lock only to write what it read, so a page request never waits on a command reply
 void State::poll()
 {
   if ((long)(millis() - lastPoll) < STATE_POLLING_RATE_MS) return;
   lastPoll = millis();
 
+  // while metrics scrapes are the only readers the state is updated at a slower rate
+  bool scraped = false;
+  if (lastScrapeTime != 0 && millis() - lastScrapeTime < STATE_SCRAPE_HOLD_MS &&
+      (long)(millis() - lastScrapeUpdate) >= STATE_SCRAPE_POLLING_RATE_MS) {
+    lastScrapeUpdate = millis();
+    scraped = true;
+  }
+
   status.update();
-  if (status.mountFound == SD_TRUE) updateMount();
-  if (status.focuserFound == SD_TRUE) updateFocuser();
-  if (status.auxiliaryFound == SD_TRUE) updateAuxiliary();
-  if (status.onStepFound) updateController();
+  if (status.mountFound == SD_TRUE) updateMount(scraped);
+  if (status.focuserFound == SD_TRUE) updateFocuser(scraped);
+  if (status.auxiliaryFound == SD_TRUE) updateAuxiliary(false, scraped);
+  if (status.onStepFound) updateController(scraped);
 
-  if (status.focuserFound == SD_TRUE && millis() - lastFocuserPageLoadTime < 2000) {
+  if (status.focuserFound == SD_TRUE && (scraped || millis() - lastFocuserPageLoadTime < 2000)) {
     char temp[80];
-    if (!onStep.command(":FG#", temp)) strcpy(temp, "?"); else strcat(temp, " microns"); delay(0);
-    strncpy(focuserPositionStr, temp, 20); focuserPositionStr[19] = 0; delay(0);
+    double position = NAN;
+    if (!onStep.command(":FG#", temp)) strcpy(temp, "?"); else { position = atof(temp); strcat(temp, " microns"); } delay(0);
+    lock(); focuserPosition = position; strncpy(focuserPositionStr, temp, 20); focuserPositionStr[19] = 0; unlock(); delay(0);
   }
 
   if (status.rotatorFound == SD_TRUE) updateRotator();
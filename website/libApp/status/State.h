@@ -33,12 +33,15 @@ typedef struct DriverStatusEx {
 #define STATE_POLLING_RATE_MS         500     // time between updates for most OnStep state information
 #endif
 
+#ifndef STATE_SCRAPE_POLLING_RATE_MS
+#define STATE_SCRAPE_POLLING_RATE_MS  10000   // time between updates while only metrics scrapes read the state
+#endif
+#define STATE_SCRAPE_HOLD_MS          300000  // scrapes keep the slower updates going this long after the last one
+
 class State {
   public:
     void init();
     void poll();
-    void pollSlow();
-    void pollFast();
 
     void updateController(bool now = false);
     void updateMount(bool now = false);
@@ -58,12 +61,32 @@ class State {
 
     void updateEncoders(bool now = false);
 
+    // the polling task writes the state and page handlers read it (and ask for updates), each holds this
+    // only while it writes or formats state values so they never see or make half written ones; it can be
+    // held recursively, the update*() functions take it themselves, and it's never held across a command
+    // (call update*() and send commands without it, onStep.command() can wait for a reply for a long time)
+    void lock();
+    void unlock();
+
+    // add the mount, focuser and auxiliary telemetry to the metrics plugin
+    void initMetrics();
+
     unsigned long lastControllerPageLoadTime = 0;
     unsigned long lastMountPageLoadTime = 0;
     unsigned long lastAuxPageLoadTime = 0;
     unsigned long lastFocuserPageLoadTime = 0;
     unsigned long lastRotatorPageLoadTime = 0;
 
+    // a metrics scrape only sets this, the mount, controller, focuser and auxiliary state are then updated
+    // every STATE_SCRAPE_POLLING_RATE_MS (unless a page has them updating faster) and the servo monitor isn't started
+    unsigned long lastScrapeTime = 0;
+
+    // when the mount, controller, focuser and auxiliary state were last updated, 0 if never
+    unsigned long lastMountUpdateTime = 0;
+    unsigned long lastControllerUpdateTime = 0;
+    unsigned long lastFocuserUpdateTime = 0;
+    unsigned long lastAuxUpdateTime = 0;
+
     char dateStr[10] = "?";
     char timeStr[10] = "?";
     char lastStr[10] = "?";
@@ -82,6 +105,15 @@ class State {
     char targetRaStr[20] = "?";
     char targetDecStr[20] = "?";
 
+    // numeric forms of the above for machine clients (hours and degrees, NAN if unknown)
+    double indexAzm = NAN;
+    double indexAlt = NAN;
+    double indexRa = NAN;
+    double indexDec = NAN;
+    double targetRa = NAN;
+    double targetDec = NAN;
+    double longitude = NAN;
+
     char angleAxis1Str[20] = "?";
     char angleAxis2Str[20] = "?";
     char encAngleAxis1Str[20] = "?";
@@ -101,6 +133,7 @@ class State {
     bool trackingLunar = false;
     bool trackingSolar = false;
     bool trackingKing = false;
+    double trackingRate = 0;
 
     float slewSpeedNominal = NAN;
     float slewSpeedCurrent = NAN;
@@ -120,6 +153,8 @@ class State {
     char focuserPositionStr[20] = "?";
     bool focuserSlewing = false;
     char focuserTemperatureStr[16] = "?";
+    double focuserPosition = NAN;       // in microns, NAN if unknown
+    float focuserTemperature = NAN;     // in degrees C, NAN if unknown
     char focuserBacklashStr[16] = "?";
     char focuserDeadbandStr[16] = "?";
     bool focuserTcfEnable = false;
@@ -152,9 +187,19 @@ class State {
     bool rotatorChecked = false;
 
     unsigned long lastPoll = 0;
+    unsigned long lastScrapeUpdate = 0;
+
+    SemaphoreHandle_t mutex = NULL;
 };
 
 void formatDegreesStr(char *s);
 void formatHoursStr(char *s);
 
 extern State state;
+
+// holds the state lock while in scope
+class StateLock {
+  public:
+    StateLock() { state.lock(); }
+    ~StateLock() { state.unlock(); }
+};
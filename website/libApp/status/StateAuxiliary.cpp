@@ -4,8 +4,10 @@
 #include "Status.h"
 #include "../../libApp/cmd/Cmd.h"
 
+// commands are sent without the state lock, it's only held while a reply is written into the state
 bool State::updateAuxiliary(bool all, bool now) {
   if (!now && millis() - lastAuxPageLoadTime > 2000) return true;
+  lastAuxUpdateTime = millis();
 
   bool valid;
 
@@ -26,6 +28,7 @@ bool State::updateAuxiliary(bool all, bool now) {
       if (!onStep.command(cmd, out) || strlen(out) == 0) valid = false; else valid = true;
 
       delay(0);
+      StateLock stateLock;
 
       if (!valid) {
         // reset and attempt re-discovery
@@ -9,28 +9,31 @@
   #include "../../../../lib/wifi/WifiManager.h"
 #endif
 
+// commands are sent without the state lock, it's only held while a reply is written into the state
 void State::updateController(bool now)
 {
   if (!now && millis() - lastControllerPageLoadTime > 2000) return;
+  lastControllerUpdateTime = millis();
 
   char temp[80], temp1[80];
 
   // Ambient conditions
   #if DISPLAY_WEATHER == ON
     if (!onStep.command(":GX9A#", temp)) strcpy(temp, "?"); else localeTemperature(temp);
-    strncpy(siteTemperatureStr, temp, 16); siteTemperatureStr[15] = 0; delay(0);
+    lock(); strncpy(siteTemperatureStr, temp, 16); siteTemperatureStr[15] = 0; unlock(); delay(0);
     if (!onStep.command(":GX9B#", temp)) strcpy(temp, "?"); else localePressure(temp);
-    strncpy(sitePressureStr, temp, 16); sitePressureStr[15] = 0; delay(0);
+    lock(); strncpy(sitePressureStr, temp, 16); sitePressureStr[15] = 0; unlock(); delay(0);
     if (!onStep.command(":GX9C#", temp)) strcpy(temp, "?"); else localeHumidity(temp);
-    strncpy(siteHumidityStr, temp, 16); siteHumidityStr[15] = 0; delay(0);
+    lock(); strncpy(siteHumidityStr, temp, 16); siteHumidityStr[15] = 0; unlock(); delay(0);
     if (!onStep.command(":GX9E#", temp)) strcpy(temp, "?"); else localeTemperature(temp);
-    strncpy(siteDewPointStr, temp, 16); siteDewPointStr[15] = 0; delay(0);
+    lock(); strncpy(siteDewPointStr, temp, 16); siteDewPointStr[15] = 0; unlock(); delay(0);
   #endif
 
   // Driver status
   int numAxes = 2;
   if (status.getVersionMajor() >= 10) numAxes = 9;
   for (int axis = 0; axis < numAxes; axis++) {
+    StateLock stateLock;
     if (driver[axis].valid) {
       strcpy(temp1, "");
       if (driver[axis].communicationFailure) strcat(temp1, L_COMMS_FAILURE ", ");
@@ -65,7 +68,7 @@ void State::updateController(bool now)
   // MCU Temperature
   #if DISPLAY_INTERNAL_TEMPERATURE == ON
     if (!onStep.command(":GX9F#", temp)) strcpy(temp, "?"); else localeTemperature(temp);
-    strncpy(controllerTemperatureStr, temp, 16); controllerTemperatureStr[15] = 0; delay(0);
+    lock(); strncpy(controllerTemperatureStr, temp, 16); controllerTemperatureStr[15] = 0; unlock(); delay(0);
   #endif
 
   // General Error
@@ -74,12 +77,12 @@ void State::updateController(bool now)
   status.getLastErrorMessage(temp1, sizeof(temp1));
   if (!status.onStepFound) strcat(temp, "?"); else strcat(temp, temp1);
   if (status.lastError != ERR_NONE) strcat(temp, "</font>"); 
-  strncpy(lastErrorStr, temp, 80); lastErrorStr[79] = 0; delay(0);
+  lock(); strncpy(lastErrorStr, temp, 80); lastErrorStr[79] = 0; unlock(); delay(0);
 
   // Loop time
   if (status.getVersionMajor() < 10) {
     if (!onStep.command(":GXFA#", temp)) strcpy(temp, "?%");
-    strncpy(workLoadStr, temp, 20); workLoadStr[19] = 0; delay(0);
+    lock(); strncpy(workLoadStr, temp, 20); workLoadStr[19] = 0; unlock(); delay(0);
   }
 
   // wifi signal strength
@@ -89,7 +92,7 @@ void State::updateController(bool now)
     if (signal_strength_qty > 100) signal_strength_qty = 100; 
     else if (signal_strength_qty < 0) signal_strength_qty = 0;
     snprintf(temp, sizeof(temp), "%lddBm (%ld%%)", signal_strength_dbm, signal_strength_qty);
-    strncpy(signalStrengthStr, temp, 20); signalStrengthStr[19] = 0; delay(0);
+    lock(); strncpy(signalStrengthStr, temp, 20); signalStrengthStr[19] = 0; unlock(); delay(0);
   #endif
 
   // update the axis status
@@ -106,7 +109,9 @@ void State::axisStatusUpdate() {
       char cmd[40];
       char reply[40];
       snprintf(cmd, sizeof(cmd), ":GXU%d#", axis + 1);
-      if (onStep.command(cmd, reply) && reply[0] != '0') {
+      bool valid = onStep.command(cmd, reply) && reply[0] != '0';
+      StateLock stateLock;
+      if (valid) {
         driverStatusFailedAttempts[axis] = 0;
         driver[axis].valid = true;
         driver[axis].communicationFailure = strstr(reply, "ST,OA,OB,GA,GB,OT,PW");
@@ -7,21 +7,27 @@
 #include "../../locales/Locale.h"
 #include "../../../../lib/convert/Convert.h"
 
+// commands are sent without the state lock, it's only held while a reply is written into the state
 void State::updateFocuser(bool now) {
   if (!now && millis() - lastFocuserPageLoadTime > 2000) return;
+  lastFocuserUpdateTime = millis();
 
   char temp[80];
 
   // identify active focuser
-  if (!onStep.command(":FA#", temp)) focuserSelected = 0; else focuserSelected = atoi(temp);  
+  int selected;
+  if (!onStep.command(":FA#", temp)) selected = 0; else selected = atoi(temp);  
   delay(0);
   
-  if (focuserSelected < 1 || focuserSelected > 6) {
+  if (selected < 1 || selected > 6) {
     // reset and attempt re-discovery
+    lock();
     focuserSelected = 0;
     strcpy(focuserPositionStr, "?");
     focuserSlewing = false;
     strcpy(focuserTemperatureStr, "?");
+    focuserPosition = NAN;
+    focuserTemperature = NAN;
     strcpy(focuserBacklashStr, "?");
     strcpy(focuserDeadbandStr, "?");
     focuserTcfEnable = false;
@@ -29,66 +35,67 @@ void State::updateFocuser(bool now) {
     focuserGotoRate = 3;
     strcpy(focuserSlewSpeedStr, "?");
     status.focuserFound = SD_UNKNOWN;
+    unlock();
     delay(0);
     return;
   }
+  focuserSelected = selected;
 
-  if (focuserSelected >= 1 && focuserSelected <= 6) {
+  // focuser/telescope temperature
+  float t = NAN;
+  if (!onStep.command(":Ft#", temp)) strcpy(temp, "?"); else { t = atof(temp); localeTemperature(temp); }
+  lock(); focuserTemperature = t; sstrcpyex(focuserTemperatureStr, temp, 16); unlock(); delay(0);
 
-    // focuser/telescope temperature
-    if (!onStep.command(":Ft#", temp)) strcpy(temp, "?"); else localeTemperature(temp);
-    sstrcpyex(focuserTemperatureStr, temp, 16); delay(0);
+  // focuser backlash
+  if (!onStep.command(":Fb#", temp)) strcpy(temp, "?");
+  lock(); sstrcpyex(focuserBacklashStr, temp, 16); unlock(); delay(0);
 
-    // focuser backlash
-    if (!onStep.command(":Fb#", temp)) strcpy(temp, "?");
-    sstrcpyex(focuserBacklashStr, temp, 16); delay(0);
+  // focuser deadband
+  if (!onStep.command(":Fd#", temp)) strcpy(temp, "?");
+  lock(); sstrcpyex(focuserDeadbandStr, temp, 16); unlock(); delay(0);
 
-    // focuser deadband
-    if (!onStep.command(":Fd#", temp)) strcpy(temp, "?");
-    sstrcpyex(focuserDeadbandStr, temp, 16); delay(0);
+  // focuser TCF enable
+  focuserTcfEnable = onStep.commandBool(":Fc#"); delay(0);
 
-    // focuser TCF enable
-    focuserTcfEnable = onStep.commandBool(":Fc#"); delay(0);
-
-    // focuser TCF
-    if (onStep.command(":FC#", temp))
-    {
-      char *conv_end;
-      double tcfCoef = strtod(temp, &conv_end);
-      if (&temp[0] != conv_end) {
-        dtostrf(tcfCoef, 1, 4, temp);
-      } else strcpy(temp, "?");
+  // focuser TCF
+  if (onStep.command(":FC#", temp))
+  {
+    char *conv_end;
+    double tcfCoef = strtod(temp, &conv_end);
+    if (&temp[0] != conv_end) {
+      dtostrf(tcfCoef, 1, 4, temp);
     } else strcpy(temp, "?");
-    sstrcpyex(focuserTcfCoefStr, temp, 16); delay(0);
+  } else strcpy(temp, "?");
+  lock(); sstrcpyex(focuserTcfCoefStr, temp, 16); unlock(); delay(0);
 
-    // focuser working slew rate
-    if (status.getVersionMajor() >= 10)
+  // focuser working slew rate
+  strcpy(temp, "?");
+  if (status.getVersionMajor() >= 10)
+  {
+    char reply[80];
+    if (onStep.command(":FW#", reply))
     {
-      if (onStep.command(":FW#", temp))
-      {
-        int s = atoi(temp);
-        if (s != 0) {
-          sprintF(focuserSlewSpeedStr, "%0.2fmm/s", s/1000.0F);
-        } else strcpy(focuserSlewSpeedStr, "?");
-      } else strcpy(focuserSlewSpeedStr, "?");
-    } else strcpy(focuserSlewSpeedStr, "?");
+      int s = atoi(reply);
+      if (s != 0) sprintF(temp, "%0.2fmm/s", s/1000.0F);
+    }
+  }
+  lock(); sstrcpyex(focuserSlewSpeedStr, temp, 16); unlock();
 
-    // focuser status
-    if (onStep.command(":FT#", temp))
-    {
-      focuserSlewing = (bool)strchr(temp, 'M');
-      switch (temp[strlen(temp) - 1] - '0') {
-        case 1: focuserGotoRate = 1; break;
-        case 2: focuserGotoRate = 2; break;
-        case 3: focuserGotoRate = 3; break;
-        case 4: focuserGotoRate = 4; break;
-        case 5: focuserGotoRate = 5; break;
-        default: focuserGotoRate = 0; break;
-      }
-    } else {
-      focuserSlewing = false;
-      focuserGotoRate = 3;
+  // focuser status
+  if (onStep.command(":FT#", temp))
+  {
+    focuserSlewing = (bool)strchr(temp, 'M');
+    switch (temp[strlen(temp) - 1] - '0') {
+      case 1: focuserGotoRate = 1; break;
+      case 2: focuserGotoRate = 2; break;
+      case 3: focuserGotoRate = 3; break;
+      case 4: focuserGotoRate = 4; break;
+      case 5: focuserGotoRate = 5; break;
+      default: focuserGotoRate = 0; break;
     }
-    delay(0);
- }
-}
\ No newline at end of file
+  } else {
+    focuserSlewing = false;
+    focuserGotoRate = 3;
+  }
+  delay(0);
+}
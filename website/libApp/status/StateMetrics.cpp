@@ -0,0 +1,236 @@
+// mount, focuser and auxiliary telemetry for the metrics plugin
+#include "State.h"
+
+#include "Status.h"
+#include "../servo/ServoMonitor.h"
+#include "../../../Plugins.config.h"
+
+#ifdef HAS_METRICS_PLUGIN
+
+static const char *axisNames[] = {"1", "2", "3", "4", "5", "6", "7", "8", "9"};
+
+typedef struct StateMetricFlag {
+  const char *name;
+  bool (*value)();
+} StateMetricFlag;
+
+const StateMetricFlag mountFlags[] = {
+  {"tracking",      [](){ return status.tracking; }},
+  {"goto",          [](){ return status.inGoto; }},
+  {"guiding",       [](){ return status.guiding; }},
+  {"pulse_guiding", [](){ return status.pulseGuiding; }},
+  {"parked",        [](){ return status.parked; }},
+  {"parking",       [](){ return status.parking; }},
+  {"park_failed",   [](){ return status.parkFail; }},
+  {"at_home",       [](){ return status.atHome; }},
+  {"homing",        [](){ return status.homing; }},
+  {"aligning",      [](){ return status.aligning; }},
+  {"pec_playing",   [](){ return status.pecPlaying; }},
+  {"pec_recording", [](){ return status.pecRecording; }},
+  {"axis_fault",    [](){ return status.axisFault; }},
+};
+#define MOUNT_FLAG_COUNT (sizeof(mountFlags)/sizeof(mountFlags[0]))
+
+const char *driverFlagNames[] = {
+  "standstill", "open_load_a", "open_load_b", "short_to_ground_a", "short_to_ground_b",
+  "over_temperature", "over_temperature_warning", "communication_failure", "fault"
+};
+#define DRIVER_FLAG_COUNT (sizeof(driverFlagNames)/sizeof(driverFlagNames[0]))
+
+#if DISPLAY_SERVO_MONITOR == ON
+  // samples older than this are left out, the servo monitor only samples while the controller page is open
+  #define SERVO_SAMPLE_MAX_AGE_MS 2000
+
+  // the latest sample of the axis the servo monitor is set to, returns the axis or 0 if none or it's too old
+  static int latestServoSample(ServoSample *sample) {
+    int axis = servoMonitor.getAxis();
+    uint32_t from = servoMonitor.next() - 1;
+    if (axis < 1 || axis > 9 || servoMonitor.next() == 0 || servoMonitor.read(&from, sample, 1) != 1) return 0;
+    if (sample->axis != axis || (uint32_t)millis() - sample->time > SERVO_SAMPLE_MAX_AGE_MS) return 0;
+    return axis;
+  }
+#endif
+
+// a part of the state last updated longer ago than this is left out, the first scrape after a while without
+// one or an open page has only the status flags until the state poller has been round
+#define STATE_MAX_AGE_MS (STATE_SCRAPE_POLLING_RATE_MS*2)
+
+static bool fresh(unsigned long updateTime) {
+  return updateTime != 0 && millis() - updateTime <= STATE_MAX_AGE_MS;
+}
+
+static const char *stateParts[] = {"mount", "controller", "focuser", "auxiliary"};
+
+// all values come from the state snapshot, a scrape sends no commands, instead it has the state poller update
+// the mount, controller, focuser and auxiliary state every STATE_SCRAPE_POLLING_RATE_MS (faster while a page
+// is open); the servo monitor isn't started by a scrape, its families are only present while the controller
+// page has it sampling
+void State::initMetrics() {
+  metricsPlugin.addFamily("state_age", "Time since the state snapshot was last updated", "gauge", {"part", "unit"}, 4,
+    [this](MetricsPlugin::Family &f) {
+      const unsigned long updateTimes[4] = {lastMountUpdateTime, lastControllerUpdateTime, lastFocuserUpdateTime, lastAuxUpdateTime};
+      int n = 0;
+      for (int i = 0; i < 4; i++) {
+        if (updateTimes[i] == 0) continue;
+        f.label(n, 0, stateParts[i]);
+        f.label(n, 1, "seconds");
+        f.set(n++, (millis() - updateTimes[i])/1000.0);
+      }
+      f.setCount(n);
+    });
+
+  metricsPlugin.addFamily("mount_status", "Mount status flags (1: set)", "gauge", {"flag"}, MOUNT_FLAG_COUNT,
+    [this](MetricsPlugin::Family &f) {
+      lastScrapeTime = millis();
+
+      f.setCount(status.mountFound == SD_TRUE ? MOUNT_FLAG_COUNT : 0);
+      for (unsigned int i = 0; i < MOUNT_FLAG_COUNT; i++) { f.label(i, 0, mountFlags[i].name); f.set(i, mountFlags[i].value() ? 1 : 0); }
+    });
+
+  metricsPlugin.addFamily("mount_tracking_rate", "Mount tracking rate (0 when not tracking)", "gauge", {"unit"}, 1,
+    [this](MetricsPlugin::Family &f) {
+      f.setCount(status.mountFound == SD_TRUE && fresh(lastMountUpdateTime) ? 1 : 0);
+      f.label(0, 0, "hz");
+      f.set(0, trackingRate);
+    });
+
+  metricsPlugin.addFamily("mount_position", "Mount position", "gauge", {"coordinate", "unit"}, 4,
+    [this](MetricsPlugin::Family &f) {
+      StateLock stateLock;
+      f.setCount(status.mountFound == SD_TRUE && fresh(lastMountUpdateTime) ? 4 : 0);
+      f.label(0, 0, "ra");  f.label(0, 1, "hours");   f.set(0, indexRa);
+      f.label(1, 0, "dec"); f.label(1, 1, "degrees"); f.set(1, indexDec);
+      f.label(2, 0, "azm"); f.label(2, 1, "degrees"); f.set(2, indexAzm);
+      f.label(3, 0, "alt"); f.label(3, 1, "degrees"); f.set(3, indexAlt);
+    });
+
+  metricsPlugin.addFamily("mount_target", "Mount target", "gauge", {"coordinate", "unit"}, 2,
+    [this](MetricsPlugin::Family &f) {
+      StateLock stateLock;
+      f.setCount(status.mountFound == SD_TRUE && fresh(lastMountUpdateTime) ? 2 : 0);
+      f.label(0, 0, "ra");  f.label(0, 1, "hours");   f.set(0, targetRa);
+      f.label(1, 0, "dec"); f.label(1, 1, "degrees"); f.set(1, targetDec);
+    });
+
+  metricsPlugin.addFamily("mount_pier_side", "Mount pier side (0: none, 1: east, 2: west, 10 to 12: flipping west to east, 20 to 22: flipping east to west)", "gauge", {}, 1,
+    [](MetricsPlugin::Family &f) {
+      f.setCount(status.mountFound == SD_TRUE ? 1 : 0);
+      f.set(0, status.pierSide);
+    });
+
+  metricsPlugin.addFamily("mount_slew_speed", "Mount current slew speed", "gauge", {"unit"}, 1,
+    [this](MetricsPlugin::Family &f) {
+      f.setCount(status.mountFound == SD_TRUE && fresh(lastMountUpdateTime) ? 1 : 0);
+      f.label(0, 0, "degrees_per_second");
+      f.set(0, slewSpeedCurrent);
+    });
+
+  // only axes whose driver reports status are included
+  metricsPlugin.addFamily("driver_status", "Stepper driver status flags (1: set)", "gauge", {"axis", "flag"}, 9*DRIVER_FLAG_COUNT,
+    [this](MetricsPlugin::Family &f) {
+      int n = 0;
+      for (int axis = 0; axis < 9 && fresh(lastControllerUpdateTime); axis++) {
+        if (!driver[axis].valid) continue;
+        const bool flags[DRIVER_FLAG_COUNT] = {
+          driver[axis].standstill,
+          driver[axis].outputA.openLoad,
+          driver[axis].outputB.openLoad,
+          driver[axis].outputA.shortToGround,
+          driver[axis].outputB.shortToGround,
+          driver[axis].overTemperature,
+          driver[axis].overTemperaturePreWarning,
+          driver[axis].communicationFailure,
+          driver[axis].fault
+        };
+        for (unsigned int i = 0; i < DRIVER_FLAG_COUNT; i++) {
+          f.label(n, 0, axisNames[axis]);
+          f.label(n, 1, driverFlagNames[i]);
+          f.set(n++, flags[i] ? 1 : 0);
+        }
+      }
+      f.setCount(n);
+    });
+
+  #if DISPLAY_SERVO_MONITOR == ON
+    metricsPlugin.addFamily("servo_delta", "Servo position error", "gauge", {"axis", "unit"}, 1,
+      [](MetricsPlugin::Family &f) {
+        ServoSample sample;
+        int axis = latestServoSample(&sample);
+        f.setCount(axis == 0 ? 0 : 1);
+        if (axis == 0) return;
+        f.label(0, 0, axisNames[axis - 1]);
+        f.label(0, 1, "steps");
+        f.set(0, sample.delta);
+      });
+    metricsPlugin.addFamily("servo_power", "Servo power", "gauge", {"axis", "unit"}, 1,
+      [](MetricsPlugin::Family &f) {
+        ServoSample sample;
+        int axis = latestServoSample(&sample);
+        f.setCount(axis == 0 ? 0 : 1);
+        if (axis == 0) return;
+        f.label(0, 0, axisNames[axis - 1]);
+        f.label(0, 1, "percent");
+        f.set(0, sample.power/10.0);
+      });
+  #endif
+
+  // the active focuser
+  metricsPlugin.addFamily("focuser_position", "Focuser position", "gauge", {"focuser", "unit"}, 1,
+    [this](MetricsPlugin::Family &f) {
+      if (status.focuserFound != SD_TRUE || !fresh(lastFocuserUpdateTime) || focuserSelected < 1 || focuserSelected > 6 || isnan(focuserPosition)) { f.setCount(0); return; }
+      f.setCount(1);
+      f.label(0, 0, axisNames[focuserSelected - 1]);
+      f.label(0, 1, "microns");
+      f.set(0, focuserPosition);
+    });
+  metricsPlugin.addFamily("focuser_temperature", "Focuser temperature", "gauge", {"focuser", "unit"}, 1,
+    [this](MetricsPlugin::Family &f) {
+      if (status.focuserFound != SD_TRUE || !fresh(lastFocuserUpdateTime) || focuserSelected < 1 || focuserSelected > 6 || isnan(focuserTemperature)) { f.setCount(0); return; }
+      f.setCount(1);
+      f.label(0, 0, axisNames[focuserSelected - 1]);
+      f.label(0, 1, "celsius");
+      f.set(0, focuserTemperature);
+    });
+
+  // history doesn't start the state poller, these record NaN unless a page or scrape already has it updating
+  metricsPlugin.addHistory("tracking_rate", [this](){
+    if (status.mountFound != SD_TRUE || !fresh(lastMountUpdateTime)) return (double)NAN;
+    return trackingRate;
+  });
+  metricsPlugin.addHistory("focuser_temperature", [this](){
+    if (status.focuserFound != SD_TRUE || !fresh(lastFocuserUpdateTime)) return (double)NAN;
+    return (double)focuserTemperature;
+  });
+  #if DISPLAY_SERVO_MONITOR == ON
+    metricsPlugin.addHistory("servo_delta", [](){
+      ServoSample sample;
+      return latestServoSample(&sample) == 0 ? (double)NAN : (double)sample.delta;
+    });
+  #endif
+
+  // only auxiliary features that measure voltage or current are included
+  metricsPlugin.addFamily("auxiliary_voltage", "Auxiliary feature output voltage", "gauge", {"feature", "unit"}, 8,
+    [this](MetricsPlugin::Family &f) {
+      int n = 0;
+      for (int i = 0; i < 8 && status.auxiliaryFound == SD_TRUE && fresh(lastAuxUpdateTime); i++) {
+        if (!status.feature[i].purpose || isnan(status.feature[i].voltage)) continue;
+        f.label(n, 0, status.feature[i].name);
+        f.label(n, 1, "volts");
+        f.set(n++, status.feature[i].voltage);
+      }
+      f.setCount(n);
+    });
+  metricsPlugin.addFamily("auxiliary_current", "Auxiliary feature output current", "gauge", {"feature", "unit"}, 8,
+    [this](MetricsPlugin::Family &f) {
+      int n = 0;
+      for (int i = 0; i < 8 && status.auxiliaryFound == SD_TRUE && fresh(lastAuxUpdateTime); i++) {
+        if (!status.feature[i].purpose || isnan(status.feature[i].current)) continue;
+        f.label(n, 0, status.feature[i].name);
+        f.label(n, 1, "amps");
+        f.set(n++, status.feature[i].current);
+      }
+      f.setCount(n);
+    });
+}
+
+#endif
@@ -7,91 +7,117 @@
 #include "../../locales/Locale.h"
 #include "../../../../lib/convert/Convert.h"
 
+// commands are sent without the state lock, it's only held while a reply is written into the state
 void State::updateMount(bool now)
 {
   if (!now && millis() - lastMountPageLoadTime > 2000) return;
+  lastMountUpdateTime = millis();
 
-  char temp[80];
+  char temp[80], temp1[80];
 
   // UTC Time and Date
   if (!onStep.command(":GX80#", temp)) strcpy(temp, "?");
-  sstrcpyex(timeStr, temp, 10);
-  if (strcmp(timeStr, "00:00:00") ||
-     (strlen(dateStr) == 0 && !strcmp(timeStr, "23:59:59"))) {
-    if (!onStep.command(":GX81#", temp)) strcpy(temp, "?");
-    if (temp[0] == '0') strcpy(&temp[0], &temp[1]);
-    sstrcpyex(dateStr, temp, 10);
+  bool getDate = strcmp(temp, "00:00:00") || (strlen(dateStr) == 0 && !strcmp(temp, "23:59:59"));
+  if (getDate) {
+    if (!onStep.command(":GX81#", temp1)) strcpy(temp1, "?");
+    if (temp1[0] == '0') strcpy(&temp1[0], &temp1[1]);
   }
+  lock();
+  sstrcpyex(timeStr, temp, 10);
+  if (getDate) sstrcpyex(dateStr, temp1, 10);
+  unlock();
   delay(0);
 
   // LST
   if (!onStep.command(":GS#", temp)) strcpy(temp, "?");
-  sstrcpyex(lastStr, temp, 10); delay(0);
+  lock(); sstrcpyex(lastStr, temp, 10); unlock(); delay(0);
 
   if (DISPLAY_HIGH_PRECISION_COORDS == ON && status.getVersionMajor() >= 10)
   {
     // Azm,Alt current
     if (!onStep.command(":GZH#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexAzmStr, temp, 14);
-    formatDegreesStr(indexAzmStr); delay(0);
+    lock(); sstrcpyex(indexAzmStr, temp, 14);
+    if (!convert.dmsToDouble(&indexAzm, temp, false)) indexAzm = NAN;
+    formatDegreesStr(indexAzmStr); unlock(); delay(0);
     if (!onStep.command(":GAH#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexAltStr, temp, 14);
-    formatDegreesStr(indexAltStr); delay(0);
+    lock(); sstrcpyex(indexAltStr, temp, 14);
+    if (!convert.dmsToDouble(&indexAlt, temp, true)) indexAlt = NAN;
+    formatDegreesStr(indexAltStr); unlock(); delay(0);
   } else {
     // Azm,Alt current
     if (!onStep.command(":GZ#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexAzmStr, temp, 14);
-    formatDegreesStr(indexAzmStr); delay(0);
+    lock(); sstrcpyex(indexAzmStr, temp, 14);
+    if (!convert.dmsToDouble(&indexAzm, temp, false)) indexAzm = NAN;
+    formatDegreesStr(indexAzmStr); unlock(); delay(0);
     if (!onStep.command(":GA#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexAltStr, temp, 14);
-    formatDegreesStr(indexAltStr); delay(0);
+    lock(); sstrcpyex(indexAltStr, temp, 14);
+    if (!convert.dmsToDouble(&indexAlt, temp, true)) indexAlt = NAN;
+    formatDegreesStr(indexAltStr); unlock(); delay(0);
   }
 
   #if DISPLAY_HIGH_PRECISION_COORDS == ON
     // RA,Dec current
     if (!onStep.command(":GRa#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexRaStr, temp, 14);
-    formatHoursStr(indexRaStr); delay(0);
+    lock(); sstrcpyex(indexRaStr, temp, 14);
+    if (!convert.hmsToDouble(&indexRa, temp)) indexRa = NAN;
+    formatHoursStr(indexRaStr); unlock(); delay(0);
     if (!onStep.command(":GDe#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexDecStr, temp, 14);
-    formatDegreesStr(indexDecStr); delay(0);
+    lock(); sstrcpyex(indexDecStr, temp, 14);
+    if (!convert.dmsToDouble(&indexDec, temp, true)) indexDec = NAN;
+    formatDegreesStr(indexDecStr); unlock(); delay(0);
 
     // RA,Dec target
     if (!onStep.command(":Gra#", temp)) strcpy(temp, "?");
-    sstrcpyex(targetRaStr, temp, 14);
-    formatHoursStr(targetRaStr); delay(0);
+    lock(); sstrcpyex(targetRaStr, temp, 14);
+    if (!convert.hmsToDouble(&targetRa, temp)) targetRa = NAN;
+    formatHoursStr(targetRaStr); unlock(); delay(0);
     if (!onStep.command(":Gde#", temp)) strcpy(temp, "?");
-    sstrcpyex(targetDecStr, temp, 14);
-    formatDegreesStr(targetDecStr); delay(0);
+    lock(); sstrcpyex(targetDecStr, temp, 14);
+    if (!convert.dmsToDouble(&targetDec, temp, true)) targetDec = NAN;
+    formatDegreesStr(targetDecStr); unlock(); delay(0);
   #else
     // RA,Dec Current
     if (!onStep.command(":GR#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexRaStr, temp, 14);
-    formatHoursStr(indexRaStr); delay(0);
+    lock(); sstrcpyex(indexRaStr, temp, 14);
+    if (!convert.hmsToDouble(&indexRa, temp)) indexRa = NAN;
+    formatHoursStr(indexRaStr); unlock(); delay(0);
     if (!onStep.command(":GD#", temp)) strcpy(temp, "?");
-    sstrcpyex(indexDecStr, temp, 14);
-    formatDegreesStr(indexDecStr); delay(0);
+    lock(); sstrcpyex(indexDecStr, temp, 14);
+    if (!convert.dmsToDouble(&indexDec, temp, true)) indexDec = NAN;
+    formatDegreesStr(indexDecStr); unlock(); delay(0);
 
     // RA,Dec Target
     if (!onStep.command(":Gr#", temp)) strcpy(temp, "?");
-    sstrcpyex(targetRaStr, temp, 14);
-    formatHoursStr(targetRaStr); delay(0);
+    lock(); sstrcpyex(targetRaStr, temp, 14);
+    if (!convert.hmsToDouble(&targetRa, temp)) targetRa = NAN;
+    formatHoursStr(targetRaStr); unlock(); delay(0);
     if (!onStep.command(":Gd#", temp)) strcpy(temp, "?");
-    sstrcpyex(targetDecStr, temp, 14);
-    formatDegreesStr(targetDecStr); delay(0);
+    lock(); sstrcpyex(targetDecStr, temp, 14);
+    if (!convert.dmsToDouble(&targetDec, temp, true)) targetDec = NAN;
+    formatDegreesStr(targetDecStr); unlock(); delay(0);
   #endif
 
   // Latitude
+  double lat = NAN;
   if (!onStep.command(status.getVersionMajor() > 3 ? ":GtH#" : ":Gt#", temp)) strcpy(temp, "?");
+  lock();
   sstrcpyex(latitudeStr, temp, 10);
   convert.dmsToDouble(&latitude, latitudeStr, true);
   formatDegreesStr(latitudeStr);
+  lat = latitude;
+  unlock();
   delay(0);
 
   // Longitude
   if (!onStep.command(status.getVersionMajor() > 3 ? ":GgH#" : ":Gg#", temp)) strcpy(temp, "?");
+  lock();
   sstrcpyex(longitudeStr, temp, 11);
+  // sDDD*MM[:SS] has three degree digits, so the sign is taken off and the rest parsed as unsigned
+  if ((longitudeStr[0] == '+' || longitudeStr[0] == '-') && convert.dmsToDouble(&longitude, &longitudeStr[1], false)) {
+    if (longitudeStr[0] == '-') longitude = -longitude;
+  } else longitude = NAN;
   formatDegreesStr(longitudeStr);
+  unlock();
   delay(0);
 
   // Pier side
@@ -101,15 +127,15 @@ void State::updateMount(bool now)
   if (status.pierSide == PierSideEast) strcpy(temp, L_EAST); else
   if (status.pierSide == PierSideNone) strcpy(temp, L_NONE); else strcpy(temp, L_UNKNOWN);
   if (!status.onStepFound) strcpy(temp, "?");
-  sstrcpyex(pierSideStr, temp, 10);
+  lock(); sstrcpyex(pierSideStr, temp, 10); unlock();
 
   // Preferred pier side
   if (status.mountType != MT_ALTAZM || (status.getVersionMajor() >= 10 && status.meridianFlips)) {
-    preferredPierSideChar = '?';
-    char temp[80];
+    char side = '?';
     if (onStep.command(":GX96#", temp)) {
-      if (temp[0] == 'E' || temp[0] == 'W' || temp[0] == 'B' || temp[0] == 'A') preferredPierSideChar = temp[0];
+      if (temp[0] == 'E' || temp[0] == 'W' || temp[0] == 'B' || temp[0] == 'A') side = temp[0];
     }
+    preferredPierSideChar = side;
   }
 
   // Meridian flip
@@ -118,16 +144,17 @@ void State::updateMount(bool now)
     if (status.autoMeridianFlips) strcat(temp, ", " L_AUTO);
   } else strcpy(temp, "Off");
   if (!status.onStepFound) strcpy(temp, "?");
-  sstrcpyex(meridianFlipStr, temp, 10);
+  lock(); sstrcpyex(meridianFlipStr, temp, 10); unlock();
 
   // Polar align
-  strcpy(alignLrStr, "?");
-  strcpy(alignUdStr, "?");
-  if (!isnan(latitude) && fabs(latitude) <= 89) {
+  strcpy(temp, "?");
+  strcpy(temp1, "?");
+  if (!isnan(lat) && fabs(lat) <= 89) {
     long ud = LONG_MIN;
-    if (onStep.command(":GX02#", temp)) { ud = strtol(&temp[0], NULL, 10); if (latitude < 0) ud = -ud; }
+    if (onStep.command(":GX02#", temp)) { ud = strtol(&temp[0], NULL, 10); if (lat < 0) ud = -ud; }
     long lr = LONG_MIN;
-    if (onStep.command(":GX03#", temp)) { lr = strtol(&temp[0], NULL, 10); lr = lr/cos(latitude/57.295); }
+    if (onStep.command(":GX03#", temp)) { lr = strtol(&temp[0], NULL, 10); lr = lr/cos(lat/57.295); }
+    strcpy(temp, "?");
 
     if (ud != LONG_MIN && lr != LONG_MIN) {
       char units = '"';
@@ -139,12 +166,11 @@ void State::updateMount(bool now)
       if (ud >= 0) strcpy(ud_s, upTri); else strcpy(ud_s, downTri);
 
       snprintf_P(temp, sizeof(temp), "%s %ld%c", lr_s, labs(lr), units);
-      sstrcpyex(alignLrStr, temp, 16);
-
-      snprintf_P(temp, sizeof(temp), "%s %ld%c", ud_s, labs(ud), units);
-      sstrcpyex(alignUdStr, temp, 16); delay(0);
+      snprintf_P(temp1, sizeof(temp1), "%s %ld%c", ud_s, labs(ud), units);
+      delay(0);
     }
   }
+  lock(); sstrcpyex(alignLrStr, temp, 16); sstrcpyex(alignUdStr, temp1, 16); unlock();
 
   // Align progress
   if (status.aligning && status.alignThisStar >= 0 && status.alignLastStar >= 0) {
@@ -152,7 +178,7 @@ void State::updateMount(bool now)
   } else {
     if (status.alignThisStar > status.alignLastStar) strcpy(temp, L_COMPLETE); else strcpy(temp, L_INACTIVE);
   }
-  sstrcpyex(alignProgress, temp, 32);
+  lock(); sstrcpyex(alignProgress, temp, 32); unlock();
 
   // Park
   if (status.parked) strcpy(temp, L_PARKED); else strcpy(temp, L_NOT_PARKED);
@@ -160,7 +186,7 @@ void State::updateMount(bool now)
   if (status.parkFail) strcpy(temp, L_PARK_FAILED);
   if (status.atHome) strcat(temp, " (" L_AT_HOME ")");
   if (!status.onStepFound) strcpy(temp, "?");
-  sstrcpyex(parkStr, temp, 40); delay(0);
+  lock(); sstrcpyex(parkStr, temp, 40); unlock(); delay(0);
 
   // Tracking
   double r = 0;
@@ -172,10 +198,6 @@ void State::updateMount(bool now)
     delay(0);
   } else strcpy(temp, L_INACTIVE);
   if (!status.onStepFound) strcpy(temp, "?");
-  trackingSidereal = fabs(r - 60.164) < 0.001;
-  trackingLunar = fabs(r - 57.900) < 0.001; 
-  trackingSolar = fabs(r - 60.000) < 0.001;
-  trackingKing  = fabs(r - 60.136) < 0.001;
 
   if (status.ppsSync) strcat(temp, "~");
 
@@ -184,14 +206,21 @@ void State::updateMount(bool now)
   if (status.rateCompensation == RC_FULL_RA) strcat(temp, " FC"); else
   if (status.rateCompensation == RC_FULL_BOTH) strcat(temp, " FCD");
 
+  lock();
+  trackingRate = r;
+  trackingSidereal = fabs(r - 60.164) < 0.001;
+  trackingLunar = fabs(r - 57.900) < 0.001; 
+  trackingSolar = fabs(r - 60.000) < 0.001;
+  trackingKing  = fabs(r - 60.136) < 0.001;
   sstrcpyex(trackStr, temp, 40);
+  unlock();
 
   // Slew speed
   if (isnan(slewSpeedNominal))
   {
-    if (!onStep.command(":GX93#", temp)) strcpy(temp, "?"); else { slewSpeedNominal = atof(temp); } delay(0);
+    if (onStep.command(":GX93#", temp)) slewSpeedNominal = atof(temp); delay(0);
   }
-  if (!onStep.command(":GX92#", temp)) strcpy(temp, "?"); else { slewSpeedCurrent = atof(temp); } delay(0);
+  if (onStep.command(":GX92#", temp)) slewSpeedCurrent = atof(temp); delay(0);
   if (!onStep.command(":GX97#", temp)) strcpy(temp, "?"); else { strcat(temp, "&deg;/s"); } delay(0);
-  sstrcpyex(slewSpeedStr, temp, 16);
+  lock(); sstrcpyex(slewSpeedStr, temp, 16); unlock();
 }
@@ -6,6 +6,7 @@
 #include "../../locales/Locale.h"
 #include "../../../../lib/convert/Convert.h"
 
+// commands are sent without the state lock, it's only held while a reply is written into the state
 void State::updateRotator(bool now) {
   if (!now && millis() - lastRotatorPageLoadTime > 2000) return;
 
@@ -29,6 +30,7 @@ void State::updateRotator(bool now) {
       delay(0);
     } else {
       // reset and attempt re-discovery
+      lock();
       strcpy(rotatorPositionStr, "?");
       rotatorSlewing = false;
       rotatorDerotate = false;
@@ -36,6 +38,7 @@ void State::updateRotator(bool now) {
       rotatorGotoRate = 3;
       strcpy(rotateSlewSpeedStr, "?");
       status.rotatorFound = SD_UNKNOWN;
+      unlock();
       delay(0);
       return;
     }
@@ -48,17 +51,17 @@ void State::updateRotator(bool now) {
       strcat(temp, &temp1[5]);
       strcat(temp, "&#39;");
     } else strcpy(temp, "?");
-    sstrcpyex(rotatorPositionStr, temp, 20); delay(0);
+    lock(); sstrcpyex(rotatorPositionStr, temp, 20); unlock(); delay(0);
 
     // rotator working slew rate
+    strcpy(temp, "?");
     if (status.getVersionMajor() >= 10) {
-      if (onStep.command(":rW#", temp)) {
-        double s = atof(temp);
-        if (s != 0.0) {
-          sprintF(rotateSlewSpeedStr, "%0.1f&deg;/s", s);
-        } else strcpy(rotateSlewSpeedStr, "?");
-      } else strcpy(rotateSlewSpeedStr, "?");
-    } else strcpy(rotateSlewSpeedStr, "?");
+      if (onStep.command(":rW#", temp1)) {
+        double s = atof(temp1);
+        if (s != 0.0) sprintF(temp, "%0.1f&deg;/s", s);
+      }
+    }
+    lock(); sstrcpyex(rotateSlewSpeedStr, temp, 20); unlock();
 
   }
-}
\ No newline at end of file
+}
@@ -12,7 +12,9 @@
 #include "../cmd/Cmd.h"
 
 #include "Status.h"
+#include "State.h"
 
+// commands are sent without the state lock, it's only held while a reply is written
 bool Status::update()
 {
   char result[80] = "";
@@ -30,6 +32,7 @@ bool Status::update()
       onStepFound = false;
       return false;
     } delay(0);
+    state.lock();
     strcpy(id, "OnStep");
     strcpy(ver, result);
     if (strlen(result) > 0) {
@@ -51,14 +54,15 @@ bool Status::update()
       ver_patch = 0;
       onStepFound = false;
       strcpy(configName, "");
-    } else {
-      onStepFound = true;
-      if (onStep.command(":GVC#", result)) {
-        strncpy(configName, result, 40);
-        for (int i = 0; i < 39; i++) {
-          if (configName[i] == 0) break;
-          if (configName[i] == '_') configName[i] = ' ';
-        }
+    } else onStepFound = true;
+    state.unlock();
+
+    if (onStepFound && onStep.command(":GVC#", result)) {
+      StateLock stateLock;
+      strncpy(configName, result, 40);
+      for (int i = 0; i < 39; i++) {
+        if (configName[i] == 0) break;
+        if (configName[i] == '_') configName[i] = ' ';
       }
     }
   }
@@ -72,6 +76,7 @@ bool Status::update()
     if (mountFound == SD_TRUE) {
       if (onStep.command(":GU#", result)) {
         delay(0);
+        state.lock();
         tracking = false;
         inGoto = false;
         if (!strstr(result, "N")) inGoto = true; else tracking = !strstr(result, "n");
@@ -124,6 +129,7 @@ bool Status::update()
         if (e < ERR_NONE) lastError = ERR_UNSPECIFIED;
         if (e > ERR_NV_INIT) lastError = ERR_UNSPECIFIED;
         lastError = (Errors)(e);
+        state.unlock();
 
         // get meridian status
         if (onStep.command(":GX94#", result) && result[0] != 0) {
@@ -133,11 +139,13 @@ bool Status::update()
 
           // align status
           if (onStep.command(":A?#", result) && strlen(result) == 3) {
+            StateLock stateLock;
             if (result[0] >= '0' && result[0] <= '9') alignMaxStars = result[0] - '0';
             if (result[1] >= '0' && result[1] <= '9') alignThisStar = result[1] - '0';
             if (result[2] >= '0' && result[2] <= '9') alignLastStar = result[2] - '0';
             if (alignThisStar != 0 && alignThisStar <= alignLastStar) aligning = true; else aligning = false;
           } else {
+            StateLock stateLock;
             alignMaxStars = 0;
             alignThisStar = 0;
             alignLastStar = 0;
@@ -229,8 +237,10 @@ bool Status::auxiliaryScan() {
         if (!valid) { for (uint8_t j = 0; j < 8; j++) feature[j].purpose = 0; auxiliaryFound = SD_FALSE; return false; }
 
         if (strlen(name_str) > 10) name_str[11] = 0;
+        state.lock();
         strcpy(feature[i].name, name_str);
         if (purpose_str) feature[i].purpose = atoi(purpose_str);
+        state.unlock();
 
         VF("MSG: Auxiliary Feature, found "); V(name_str);
         switch (feature[i].purpose) {
@@ -242,6 +242,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "línies escrites"
 #define L_CAT_UPLOAD_SELECT_FAIL "Error en carregar, no s'ha pogut seleccionar el catàleg."
 #define L_CAT_UPLOAD_NO_CAT "Error en carregar, no s'ha seleccionat cap catàleg."
+#define L_OBJECTS "Objectes"
+#define L_OBJ_COUNT "objectes"
+#define L_OBJ_NEAREST "Estrella més propera"
+#define L_OBJ_NONE "No hi ha cap catàleg d'objectes carregat."
+#define L_OBJ_TOO_MANY "Error en carregar, massa objectes a la línia# "
+#define L_OBJ_WRITE_FAIL "Error en carregar, no s'ha pogut escriure a la memòria flash."
+#define L_OBJ_NO_MEMORY "Error en carregar, memòria insuficient."
+#define L_OBJ_SET_TARGET "Fixa l'objectiu"
 #define L_CAT_CLEAR "Esborrar catàleg"
 #define L_CAT_CLEAR_LIB "Esborrar biblioteca"
 
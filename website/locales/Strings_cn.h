@@ -243,6 +243,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "写的行"
 #define L_CAT_UPLOAD_SELECT_FAIL "上传失败,无法选择目录."
 #define L_CAT_UPLOAD_NO_CAT "上传失败,未选择目录."
+#define L_OBJECTS "天体"
+#define L_OBJ_COUNT "个天体"
+#define L_OBJ_NEAREST "最近的恒星"
+#define L_OBJ_NONE "未加载天体目录."
+#define L_OBJ_TOO_MANY "上传失败,天体太多,行# "
+#define L_OBJ_WRITE_FAIL "上传失败,写入闪存出错."
+#define L_OBJ_NO_MEMORY "上传失败,内存不足."
+#define L_OBJ_SET_TARGET "设为目标"
 #define L_CAT_CLEAR "清除目录"
 #define L_CAT_CLEAR_LIB "清除图书馆"
 
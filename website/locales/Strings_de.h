@@ -252,6 +252,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "Zeilen geschrieben"
 #define L_CAT_UPLOAD_SELECT_FAIL "Der Upload ist fehlgeschlagen, der Katalog konnte nicht ausgew&auml;hlt werden."
 #define L_CAT_UPLOAD_NO_CAT "Upload fehlgeschlagen, kein Katalog ausgewÃ¤hlt."
+#define L_OBJECTS "Objekte"
+#define L_OBJ_COUNT "Objekte"
+#define L_OBJ_NEAREST "N&auml;chster Stern"
+#define L_OBJ_NONE "Kein Objektkatalog geladen."
+#define L_OBJ_TOO_MANY "Upload fehlgeschlagen, zu viele Objekte in Zeile# "
+#define L_OBJ_WRITE_FAIL "Upload fehlgeschlagen, Fehler beim Schreiben in den Flash."
+#define L_OBJ_NO_MEMORY "Upload fehlgeschlagen, nicht genug Speicher."
+#define L_OBJ_SET_TARGET "Als Ziel setzen"
 #define L_CAT_CLEAR "Katalog löschen"
 #define L_CAT_CLEAR_LIB "Bibliothek löschen"
 
@@ -242,6 +242,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "lines written"
 #define L_CAT_UPLOAD_SELECT_FAIL "Upload failed, unable to select catalog."
 #define L_CAT_UPLOAD_NO_CAT "Upload failed, no catalog selected."
+#define L_OBJECTS "Objects"
+#define L_OBJ_COUNT "objects"
+#define L_OBJ_NEAREST "Nearest Star"
+#define L_OBJ_NONE "No object catalog loaded."
+#define L_OBJ_TOO_MANY "Upload failed, too many objects at line# "
+#define L_OBJ_WRITE_FAIL "Upload failed, writing to flash."
+#define L_OBJ_NO_MEMORY "Upload failed, out of memory."
+#define L_OBJ_SET_TARGET "Set Target"
 #define L_CAT_CLEAR "Clear Catalog"
 #define L_CAT_CLEAR_LIB "Clear Library"
 
@@ -242,6 +242,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "líneas escritas"
 #define L_CAT_UPLOAD_SELECT_FAIL "Falló la carga, no se pudo seleccionar el catálogo."
 #define L_CAT_UPLOAD_NO_CAT "Falló la carga, no se seleccionó ningún catálogo."
+#define L_OBJECTS "Objetos"
+#define L_OBJ_COUNT "objetos"
+#define L_OBJ_NEAREST "Estrella más cercana"
+#define L_OBJ_NONE "No hay ningún catálogo de objetos cargado."
+#define L_OBJ_TOO_MANY "Carga fallida, demasiados objetos en la línea# "
+#define L_OBJ_WRITE_FAIL "Carga fallida, error al escribir en la memoria flash."
+#define L_OBJ_NO_MEMORY "Carga fallida, memoria insuficiente."
+#define L_OBJ_SET_TARGET "Fijar objetivo"
 #define L_CAT_CLEAR "Borrar catálogo"
 #define L_CAT_CLEAR_LIB "Borrar biblioteca"
 
@@ -242,6 +242,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "lignes ecrites"
 #define L_CAT_UPLOAD_SELECT_FAIL "Echec du televersement, impossible de selectionner le catalogue."
 #define L_CAT_UPLOAD_NO_CAT "Echec du televersement, aucun catalogue selectionne."
+#define L_OBJECTS "Objets"
+#define L_OBJ_COUNT "objets"
+#define L_OBJ_NEAREST "Etoile la plus proche"
+#define L_OBJ_NONE "Aucun catalogue d'objets charge."
+#define L_OBJ_TOO_MANY "Echec du televersement, trop d'objets a la ligne# "
+#define L_OBJ_WRITE_FAIL "Echec du televersement, erreur d'ecriture en flash."
+#define L_OBJ_NO_MEMORY "Echec du televersement, memoire insuffisante."
+#define L_OBJ_SET_TARGET "Definir la cible"
 #define L_CAT_CLEAR "Effacer le catalogue"
 #define L_CAT_CLEAR_LIB "Effacer la bibliotheque"
 
@@ -242,6 +242,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "righe scritte"
 #define L_CAT_UPLOAD_SELECT_FAIL "Caricamento fallito, impossibile selezionare il catalogo."
 #define L_CAT_UPLOAD_NO_CAT "Caricamento fallito, nessun catalogo selezionato."
+#define L_OBJECTS "Oggetti"
+#define L_OBJ_COUNT "oggetti"
+#define L_OBJ_NEAREST "Stella più vicina"
+#define L_OBJ_NONE "Nessun catalogo di oggetti caricato."
+#define L_OBJ_TOO_MANY "Caricamento fallito, troppi oggetti alla riga# "
+#define L_OBJ_WRITE_FAIL "Caricamento fallito, errore di scrittura nella flash."
+#define L_OBJ_NO_MEMORY "Caricamento fallito, memoria insufficiente."
+#define L_OBJ_SET_TARGET "Imposta target"
 #define L_CAT_CLEAR "Cancella catalogo"
 #define L_CAT_CLEAR_LIB "Cancella libreria"
 
@@ -242,6 +242,14 @@
 #define L_CAT_UPLOAD_LINES_WRITTEN "行書き込み完了"
 #define L_CAT_UPLOAD_SELECT_FAIL "アップロード失敗、カタログを選択できません。"
 #define L_CAT_UPLOAD_NO_CAT "アップロード失敗、カタログが選択されていません。"
+#define L_OBJECTS "天体"
+#define L_OBJ_COUNT "天体"
+#define L_OBJ_NEAREST "最も近い恒星"
+#define L_OBJ_NONE "天体カタログが読み込まれていません。"
+#define L_OBJ_TOO_MANY "アップロード失敗、天体が多すぎます 行番号# "
+#define L_OBJ_WRITE_FAIL "アップロード失敗、フラッシュへの書き込みエラーです。"
+#define L_OBJ_NO_MEMORY "アップロード失敗、メモリが不足しています。"
+#define L_OBJ_SET_TARGET "目標に設定"
 #define L_CAT_CLEAR "カタログ消去"
 #define L_CAT_CLEAR_LIB "ライブラリ消去"
 
@@ -0,0 +1,22 @@
+// -----------------------------------------------------------------------------------
+// Command channel simulation settings, for latency and throughput benchmarks
+
+#include "Pages.common.h"
+
+#if CMD_SIMULATE == ON
+
+// set with latency=, jitter= (both in ms) and drop= (percent), replies with the settings in effect
+void handleCmdSim() {
+  if (www.hasArg("latency")) onStep.simLatencyMs = constrain(www.arg("latency").toInt(), 0, 5000);
+  if (www.hasArg("jitter")) onStep.simJitterMs = constrain(www.arg("jitter").toInt(), 0, 5000);
+  if (www.hasArg("drop")) onStep.simDropPercent = constrain(www.arg("drop").toInt(), 0, 100);
+
+  char temp[120];
+  snprintf(temp, sizeof(temp), "latency|%d\njitter|%d\ndrop|%d\ndropped|%lu\n",
+           onStep.simLatencyMs, onStep.simJitterMs, onStep.simDropPercent, onStep.simDropped);
+
+  www.sendHeader("Cache-Control", "no-cache");
+  www.send(200, "text/plain", temp);
+}
+
+#endif
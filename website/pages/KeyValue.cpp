@@ -2,18 +2,27 @@
 #include <Arduino.h>
 #include "KeyValue.h"
 
-String keyValueString(String key, String value1, String value2, String value3, String value4) {
-  return key + "|" + value1 + value2 + value3 + value4 + "\n";
+void keyValueString(String &data, const char *key, const char *value1, const char *value2, const char *value3, const char *value4) {
+  data.concat(key);
+  data.concat('|');
+  data.concat(value1);
+  if (value2[0]) data.concat(value2);
+  if (value3[0]) data.concat(value3);
+  if (value4[0]) data.concat(value4);
+  data.concat('\n');
 }
 
-String keyValueToggleBoolSelected(String keyOn, String keyOff, bool selectState) {
-  return keyOn + "|" + (selectState ? "selected\n" : "unselected\n") + keyOff + "|" + (selectState ? "unselected\n" : "selected\n");
+void keyValueToggleBoolSelected(String &data, const char *keyOn, const char *keyOff, bool selectState) {
+  keyValueBoolSelected(data, keyOn, selectState);
+  keyValueBoolSelected(data, keyOff, !selectState);
 }
 
-String keyValueBoolSelected(String key, bool selectState) {
-  return key + "|" + (selectState ? "selected\n" : "unselected\n");
+void keyValueBoolSelected(String &data, const char *key, bool selectState) {
+  data.concat(key);
+  data.concat(selectState ? "|selected\n" : "|unselected\n");
 }
 
-String keyValueBoolEnabled(String key, bool state) {
-  return key + "|" + (state ? "enabled\n" : "disabled\n");
+void keyValueBoolEnabled(String &data, const char *key, bool state) {
+  data.concat(key);
+  data.concat(state ? "|enabled\n" : "|disabled\n");
 }
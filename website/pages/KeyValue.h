@@ -1,7 +1,9 @@
 // key/value handling
 #pragma once
 
-String keyValueString(String key, String value1, String value2 = "", String value3 = "", String value4 = "");
-String keyValueToggleBoolSelected(String keyOn, String keyOff, bool selectState);
-String keyValueBoolSelected(String key, bool selectState);
-String keyValueBoolEnabled(String key, bool state);
+// these append "key|value\n" lines directly to the response buffer (no temporary Strings are created)
+// keys and values may be RAM or PROGMEM (directly addressable on the ESP32) strings
+void keyValueString(String &data, const char *key, const char *value1, const char *value2 = "", const char *value3 = "", const char *value4 = "");
+void keyValueToggleBoolSelected(String &data, const char *keyOn, const char *keyOff, bool selectState);
+void keyValueBoolSelected(String &data, const char *key, bool selectState);
+void keyValueBoolEnabled(String &data, const char *key, bool state);
@@ -10,6 +10,19 @@ void handleMount();
 void mountAjaxGet();
 void mountAjax();
 void handleLibraryHelp();
+void libraryCatalogDownload();
+void libraryCatalogUpload();
+void libraryCatalogUploadData();
+
+void pecDownload();
+void pecUpload();
+void pecUploadData();
+
+#if DISPLAY_OBJECT_CATALOG == ON
+  void objectsFind();
+  void objectsUpload();
+  void objectsUploadData();
+#endif
 
 void handleRotator();
 void rotatorAjaxGet();
@@ -22,7 +35,19 @@ void focuserAjax();
 void handleAux();
 void auxAjaxGet();
 void auxAjax();
+void auxFlush();
 
 void handleNetwork();
 
+void handleApiState();
+
+#if DISPLAY_SERVO_MONITOR == ON
+  void servoAjaxBinary();
+  void servoCsv();
+#endif
+
+#if CMD_SIMULATE == ON
+  void handleCmdSim();
+#endif
+
 void handleNotFound();
@@ -0,0 +1,162 @@
+// -----------------------------------------------------------------------------------
+// Machine readable state for automation clients, JSON or CBOR
+// GET /api/v1/state[?fields=ra,dec,tracking][&format=cbor]
+// angles are in degrees, right ascension in hours, unknown values are null
+// longitude is as OnStep gives it, positive west of Greenwich (the opposite of the usual convention)
+
+#include "../Pages.common.h"
+
+enum ApiFieldType {AFT_BOOL, AFT_INT, AFT_NUMBER};
+
+typedef struct ApiField {
+  const char *name;
+  ApiFieldType type;
+  double (*value)();
+} ApiField;
+
+const ApiField apiFields[] = {
+  {"ra",             AFT_NUMBER, [](){ return state.indexRa; }},
+  {"dec",            AFT_NUMBER, [](){ return state.indexDec; }},
+  {"azm",            AFT_NUMBER, [](){ return state.indexAzm; }},
+  {"alt",            AFT_NUMBER, [](){ return state.indexAlt; }},
+  {"target_ra",      AFT_NUMBER, [](){ return state.targetRa; }},
+  {"target_dec",     AFT_NUMBER, [](){ return state.targetDec; }},
+  {"latitude",       AFT_NUMBER, [](){ return state.latitude; }},
+  {"longitude",      AFT_NUMBER, [](){ return state.longitude; }},
+  {"pier_side",      AFT_INT,    [](){ return (double)status.pierSide; }},
+  {"mount_type",     AFT_INT,    [](){ return (double)status.mountType; }},
+  {"tracking",       AFT_BOOL,   [](){ return (double)status.tracking; }},
+  {"tracking_rate",  AFT_NUMBER, [](){ return state.trackingRate; }},
+  {"goto",           AFT_BOOL,   [](){ return (double)status.inGoto; }},
+  {"slew_speed",     AFT_NUMBER, [](){ return (double)state.slewSpeedCurrent; }},
+  {"guiding",        AFT_BOOL,   [](){ return (double)status.guiding; }},
+  {"pulse_guiding",  AFT_BOOL,   [](){ return (double)status.pulseGuiding; }},
+  {"guide_rate",     AFT_INT,    [](){ return (double)status.guideRate; }},
+  {"parked",         AFT_BOOL,   [](){ return (double)status.parked; }},
+  {"parking",        AFT_BOOL,   [](){ return (double)status.parking; }},
+  {"park_failed",    AFT_BOOL,   [](){ return (double)status.parkFail; }},
+  {"at_home",        AFT_BOOL,   [](){ return (double)status.atHome; }},
+  {"homing",         AFT_BOOL,   [](){ return (double)status.homing; }},
+  {"aligning",       AFT_BOOL,   [](){ return (double)status.aligning; }},
+  {"pec_playing",    AFT_BOOL,   [](){ return (double)status.pecPlaying; }},
+  {"pec_recording",  AFT_BOOL,   [](){ return (double)status.pecRecording; }},
+  {"axis_fault",     AFT_BOOL,   [](){ return (double)status.axisFault; }},
+  {"last_error",     AFT_INT,    [](){ return (double)status.lastError; }},
+};
+#define API_FIELD_COUNT (sizeof(apiFields)/sizeof(apiFields[0]))
+
+// true if name is in the comma separated list of fields, an empty list selects all fields
+bool apiFieldSelected(const char *fields, const char *name) {
+  if (fields[0] == 0) return true;
+  size_t length = strlen(name);
+  const char *field = fields;
+  while (field != NULL) {
+    if (strncmp(field, name, length) == 0 && (field[length] == ',' || field[length] == 0)) return true;
+    field = strchr(field, ',');
+    if (field != NULL) field++;
+  }
+  return false;
+}
+
+void apiStateJson(const char *fields) {
+  char temp[32];
+  String data = "{";
+
+  // the values are read together so they come from the same state
+  state.lock();
+  bool first = true;
+  for (unsigned int i = 0; i < API_FIELD_COUNT; i++) {
+    if (!apiFieldSelected(fields, apiFields[i].name)) continue;
+    if (!first) data.concat(','); first = false;
+
+    data.concat('"'); data.concat(apiFields[i].name); data.concat("\":");
+
+    double value = apiFields[i].value();
+    if (isnan(value)) data.concat("null"); else
+    switch (apiFields[i].type) {
+      case AFT_BOOL: data.concat(value != 0 ? "true" : "false"); break;
+      case AFT_INT: snprintf(temp, sizeof(temp), "%ld", lround(value)); data.concat(temp); break;
+      case AFT_NUMBER: snprintf(temp, sizeof(temp), "%.8g", value); data.concat(temp); break;
+    }
+  }
+  state.unlock();
+  data.concat('}');
+
+  www.send(200, "application/json", data);
+}
+
+// minimal CBOR (RFC 8949) encoder writing into a fixed buffer
+class CborWriter {
+  public:
+    CborWriter(uint8_t *buffer, size_t size) { this->buffer = buffer; this->size = size; }
+
+    void head(uint8_t major, uint32_t n) {
+      major <<= 5;
+      if (n < 24) put(major | n); else
+      if (n <= 0xFF) { put(major | 24); put(n); } else
+      if (n <= 0xFFFF) { put(major | 25); put(n >> 8); put(n); } else
+      { put(major | 26); put(n >> 24); put(n >> 16); put(n >> 8); put(n); }
+    }
+    void text(const char *s) { size_t l = strlen(s); head(3, l); for (size_t i = 0; i < l; i++) put(s[i]); }
+    void boolean(bool b) { put(b ? 0xF5 : 0xF4); }
+    void null() { put(0xF6); }
+    void integer(long n) { if (n >= 0) head(0, n); else head(1, -1 - n); }
+    void number(double f) {
+      uint64_t bits;
+      memcpy(&bits, &f, sizeof(bits));
+      put(0xFB);
+      for (int i = 7; i >= 0; i--) put(bits >> (i*8));
+    }
+
+    size_t length() { return overflow ? 0 : count; }
+
+  private:
+    void put(uint8_t b) { if (count < size) buffer[count++] = b; else overflow = true; }
+
+    uint8_t *buffer;
+    size_t size;
+    size_t count = 0;
+    bool overflow = false;
+};
+
+void apiStateCbor(const char *fields) {
+  uint8_t buffer[640];
+  CborWriter cbor(buffer, sizeof(buffer));
+
+  int selected = 0;
+  for (unsigned int i = 0; i < API_FIELD_COUNT; i++) if (apiFieldSelected(fields, apiFields[i].name)) selected++;
+  cbor.head(5, selected);
+
+  state.lock();
+  for (unsigned int i = 0; i < API_FIELD_COUNT; i++) {
+    if (!apiFieldSelected(fields, apiFields[i].name)) continue;
+    cbor.text(apiFields[i].name);
+
+    double value = apiFields[i].value();
+    if (isnan(value)) cbor.null(); else
+    switch (apiFields[i].type) {
+      case AFT_BOOL: cbor.boolean(value != 0); break;
+      case AFT_INT: cbor.integer(lround(value)); break;
+      case AFT_NUMBER: cbor.number(value); break;
+    }
+  }
+  state.unlock();
+
+  size_t length = cbor.length();
+  if (length == 0) { www.send(500, "text/plain", "CBOR buffer overflow"); return; }
+
+  www.setContentLength(length);
+  www.send(200, "application/cbor", "");
+  www.sendContent((const char*)buffer, length);
+}
+
+void handleApiState() {
+  // keep the mount state current while a client polls, only the first request after a pause waits on an update
+  if (status.mountFound == SD_TRUE && millis() - state.lastMountPageLoadTime > 2000) state.updateMount(true);
+  state.lastMountPageLoadTime = millis();
+
+  String fields = www.arg("fields");
+
+  www.sendHeader("Cache-Control", "no-cache");
+  if (www.arg("format").equals("cbor")) apiStateCbor(fields.c_str()); else apiStateJson(fields.c_str());
+}
@@ -10,8 +10,18 @@
 extern void handleNotFound();
 void processAuxGet();
 
+// slider settings are held here and written by auxFlush(), a newer value for the same feature
+// setting replaces one not yet written so a drag costs a command per cadence not per step
+char auxPending[8][4][20];
+unsigned long auxLastFlush = 0;
+
+void auxQueue(char feature, int value, const char *command) {
+  strncpy(auxPending[feature - '1'][value - 1], command, 19);
+  auxPending[feature - '1'][value - 1][19] = 0;
+}
+
 void handleAux() {
-  char temp[240] = "";
+  char temp[480] = "";
   char temp1[80] = "";
 
   state.updateAuxiliary(false, true);
@@ -73,7 +83,9 @@ void handleAux() {
       if (state.featurePurpose() <= 0) continue;
 
       char title[40];
+      state.lock();
       strcpy(title, state.featureName());
+      state.unlock();
       strcat(title, " ");
       switch (state.featurePurpose()) {
         case SWITCH: strcat(title, "Switch"); break;
@@ -118,7 +130,7 @@ void handleAux() {
         data.concat(F("<div style='float: left; width: 8em; height: 2em; line-height: 2em'>"));
         data.concat(F("</div><div style='float: left; width: 14em; height: 2em; line-height: 2em'>"));
         data.concat(FPSTR(html_auxAnalog));
-        snprintf(temp, sizeof(temp), "%d' onchange=\"sz('x%dv1',this.value)\">", state.featureValue1(), i + 1);
+        snprintf(temp, sizeof(temp), "%d' oninput=\"sl('x%dv1',this.value)\">", state.featureValue1(), i + 1);
         data.concat(temp);
         data.concat(F("</div><div style='float: left; width: 4em; height: 2em; line-height: 2em'>"));
         snprintf(temp, sizeof(temp), "<span id='x%dv1'>%d</span>%%", i + 1, (int)lround((state.featureValue1()/255.0)*100.0));
@@ -147,7 +159,7 @@ void handleAux() {
         data.concat(L_DP_ZERO);
         data.concat(F("</div><div style='float: left; width: 14em; height: 2em; line-height: 2em'>"));
         data.concat(FPSTR(html_auxHeater));
-        snprintf(temp, sizeof(temp), "%d' onchange=\"sz('x%dv2',this.value)\">", (int)lround(celsiusToNativeRelative(state.featureValue2())*DEW_HEATER_CONTROL_SCALE), i + 1);
+        snprintf(temp, sizeof(temp), "%d' oninput=\"sl('x%dv2',this.value)\">", (int)lround(celsiusToNativeRelative(state.featureValue2())*DEW_HEATER_CONTROL_SCALE), i + 1);
         data.concat(temp);
         data.concat(F("</div><div style='float: left; width: 4em; height: 2em; line-height: 2em'>"));
         dtostrf(celsiusToNativeRelative(state.featureValue2()), 3, 1, temp1);
@@ -159,7 +171,7 @@ void handleAux() {
         data.concat(L_DP_SPAN);
         data.concat(F("</div><div style='float: left; width: 14em; height: 2em; line-height: 2em'>"));
         data.concat(FPSTR(html_auxHeater));
-        snprintf(temp, sizeof(temp), "%d' onchange=\"sz('x%dv3',this.value)\">", (int)lround(celsiusToNativeRelative(state.featureValue3())*DEW_HEATER_CONTROL_SCALE), i + 1);
+        snprintf(temp, sizeof(temp), "%d' oninput=\"sl('x%dv3',this.value)\">", (int)lround(celsiusToNativeRelative(state.featureValue3())*DEW_HEATER_CONTROL_SCALE), i + 1);
         data.concat(temp);
         data.concat(F("</div><div style='float: left; width: 4em; height: 2em; line-height: 2em'>"));
         dtostrf(celsiusToNativeRelative(state.featureValue3()), 3, 1, temp1);
@@ -189,7 +201,7 @@ void handleAux() {
         data.concat(L_CAMERA_COUNT);
         data.concat(F("</div><div style='float: left; width: 14em; height: 2em; line-height: 2em'>"));
         data.concat(FPSTR(html_auxCount));
-        snprintf(temp, sizeof(temp), "%d' onchange=\"sz('x%dv4',this.value)\">",(int)state.featureValue4(),i+1);
+        snprintf(temp, sizeof(temp), "%d' oninput=\"sl('x%dv4',this.value)\">",(int)state.featureValue4(),i+1);
         data.concat(temp);
         data.concat(F("</div><div style='float: left; width: 4em; height: 2em; line-height: 2em'>"));
         dtostrf(state.featureValue4(),0,0,temp1);
@@ -201,7 +213,7 @@ void handleAux() {
         data.concat(L_CAMERA_EXPOSURE);
         data.concat(F("</div><div style='float: left; width: 14em; height: 2em; line-height: 2em'>"));
         data.concat(FPSTR(html_auxExposure));
-        snprintf(temp, sizeof(temp), "%d' onchange=\"sz('x%dv2',this.value)\">",(int)timeToByte(state.featureValue2()),i+1);
+        snprintf(temp, sizeof(temp), "%d' oninput=\"sl('x%dv2',this.value)\">",(int)timeToByte(state.featureValue2()),i+1);
         data.concat(temp);
         data.concat(F("</div><div style='float: left; width: 4em; height: 2em; line-height: 2em'>"));
         float v; int d;
@@ -215,7 +227,7 @@ void handleAux() {
         data.concat(L_CAMERA_DELAY);
         data.concat(F("</div><div style='float: left; width: 14em; height: 2em; line-height: 2em'>"));
         data.concat(FPSTR(html_auxDelay));
-        snprintf(temp, sizeof(temp), "%d' onchange=\"sz('x%dv3',this.value)\">",(int)timeToByte(state.featureValue3()),i+1);
+        snprintf(temp, sizeof(temp), "%d' oninput=\"sl('x%dv3',this.value)\">",(int)timeToByte(state.featureValue3()),i+1);
         data.concat(temp);
         data.concat(F("</div><div style='float: left; width: 4em; height: 2em; line-height: 2em'>"));
         v=state.featureValue3(); if (v < 10.0) d=2; else if (v < 30.0) d=1; else d=0;
@@ -260,6 +272,7 @@ void auxAjax() {
 
   // update auxiliary feature values
   if (status.auxiliaryFound == SD_TRUE) {
+    state.lock();
 
     for (int i = 0; i < 8; i++) {
       state.selectFeature(i);
@@ -334,6 +347,8 @@ void auxAjax() {
         snprintf(temp, sizeof(temp), "x%dv4|%d\n",i+1,(int)state.featureValue4()); data.concat(temp);
       }
     }
+
+    state.unlock();
   }
 
   www.sendContentAndClear(data);
@@ -355,7 +370,7 @@ void processAuxGet() {
     v = www.arg(temp);
     if (!v.equals(EmptyStr)) {
       snprintf(temp, sizeof(temp), ":SXX%c,V%s#", c, v.c_str());
-      onStep.commandBool(temp);
+      if (state.featurePurpose() == ANALOG_OUTPUT) auxQueue(c, 1, temp); else onStep.commandBool(temp);
     }
 
     if (state.featurePurpose() == DEW_HEATER) {
@@ -364,14 +379,14 @@ void processAuxGet() {
       if (!v.equals(EmptyStr)) {
         dtostrf(nativeToCelsiusRelative(v.toFloat()/DEW_HEATER_CONTROL_SCALE), 0, 1, temp1);
         snprintf(temp, sizeof(temp), ":SXX%c,Z%s#", c, temp1);
-        onStep.commandBool(temp);
+        auxQueue(c, 2, temp);
       }
       snprintf(temp, sizeof(temp), "x%cv3", c);
       v = www.arg(temp);
       if (!v.equals(EmptyStr)) {
         dtostrf(nativeToCelsiusRelative(v.toFloat()/DEW_HEATER_CONTROL_SCALE), 0, 1, temp1);
         snprintf(temp, sizeof(temp), ":SXX%c,S%s#", c, temp1);
-        onStep.commandBool(temp);
+        auxQueue(c, 3, temp);
       }
     } else
 
@@ -381,22 +396,36 @@ void processAuxGet() {
       if (!v.equals(EmptyStr)) {
         dtostrf(byteToTime(v.toInt()), 0, 3, temp1);
         snprintf(temp, sizeof(temp), ":SXX%c,E%s#", c, temp1);
-        onStep.commandBool(temp);
+        auxQueue(c, 2, temp);
       }
       snprintf(temp, sizeof(temp), "x%cv3", c); v = www.arg(temp);
       if (!v.equals(EmptyStr)) {
         dtostrf(byteToTime(v.toInt()), 0, 2, temp1);
         snprintf(temp, sizeof(temp), ":SXX%c,D%s#", c, temp1);
-        onStep.commandBool(temp);
+        auxQueue(c, 3, temp);
       }
       snprintf(temp, sizeof(temp), "x%cv4", c); v = www.arg(temp);
       if (!v.equals(EmptyStr)) {
         dtostrf(v.toFloat(), 0, 0, temp1);
         snprintf(temp, sizeof(temp), ":SXX%c,C%s#", c, temp1);
-        onStep.commandBool(temp);
+        auxQueue(c, 4, temp);
       }
     }
   }
 
   state.lastAuxPageLoadTime = millis();
 }
+
+void auxFlush() {
+  if ((long)(millis() - auxLastFlush) < AUX_WRITE_COALESCE_MS) return;
+  auxLastFlush = millis();
+
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 4; j++) {
+      if (auxPending[i][j][0] != 0) {
+        onStep.commandBool(auxPending[i][j]);
+        auxPending[i][j][0] = 0;
+      }
+    }
+  }
+}
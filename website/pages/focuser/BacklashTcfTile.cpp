@@ -13,6 +13,7 @@ void focuserBacklashTcfTile(String &data)
   snprintf_P(temp, sizeof(temp), html_tile_text_beg, "22em", "13em", "Backlash and TCF");
   data.concat(temp);
 
+  state.lock();
   data.concat(F("<div style='float: right; text-align: right;' id='f_temp' class='c'>"));
   snprintf_P(temp, sizeof(temp), L_TEMPERATURE " %s", state.focuserTemperatureStr);
   data.concat(temp);
@@ -26,9 +27,10 @@ void focuserBacklashTcfTile(String &data)
 
   snprintf_P(temp, sizeof(temp), html_tcfDeadbandValue, state.focuserDeadbandStr);
   data.concat(temp);
+  snprintf_P(temp, sizeof(temp), html_tcfCoefValue, state.focuserTcfCoefStr);
+  state.unlock();
   www.sendContentAndClear(data);
 
-  snprintf_P(temp, sizeof(temp), html_tcfCoefValue, state.focuserTcfCoefStr);
   data.concat(temp);
 
   data.concat(F("<hr>"));
@@ -44,6 +46,7 @@ void focuserBacklashTcfTile(String &data)
     data.concat(temp);
 
     // Backlash
+    state.lock();
     snprintf_P(temp, sizeof(temp), html_backlash, state.focuserBacklashStr);
     data.concat(temp);
 
@@ -54,10 +57,12 @@ void focuserBacklashTcfTile(String &data)
     // TCF Deadband
     snprintf_P(temp, sizeof(temp), html_tcfDeadband, state.focuserDeadbandStr);
     data.concat(temp);
-    www.sendContentAndClear(data);
 
     // TCF Coef
     snprintf_P(temp, sizeof(temp), html_tcfCoef, state.focuserTcfCoefStr);
+    state.unlock();
+    www.sendContentAndClear(data);
+
     data.concat(temp);
     data.concat(F("<button type='submit'>" L_UPLOAD "</button>\n"));
 
@@ -76,12 +81,14 @@ void focuserBacklashTcfTileAjax(String &data)
 {
   char temp[32];
 
+  state.lock();
   snprintf(temp, sizeof(temp), L_TEMPERATURE " %s", state.focuserTemperatureStr);
-  data.concat(keyValueString("f_temp", temp));
-  data.concat(keyValueString("f_bl", state.focuserBacklashStr, " step(s)"));
-  data.concat(keyValueString("f_tcf_en", state.focuserTcfEnable ? "true" : "false"));
-  data.concat(keyValueString("f_tcf_db", state.focuserDeadbandStr, " step(s)"));
-  data.concat(keyValueString("f_tcf_coef", state.focuserTcfCoefStr));
+  keyValueString(data, "f_temp", temp);
+  keyValueString(data, "f_bl", state.focuserBacklashStr, " step(s)");
+  keyValueString(data, "f_tcf_en", state.focuserTcfEnable ? "true" : "false");
+  keyValueString(data, "f_tcf_db", state.focuserDeadbandStr, " step(s)");
+  keyValueString(data, "f_tcf_coef", state.focuserTcfCoefStr);
+  state.unlock();
 
   www.sendContentAndClear(data);
 }
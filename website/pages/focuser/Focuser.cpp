@@ -10,7 +10,7 @@ extern void handleNotFound();
 void processFocuserGet();
 
 void handleFocuser() {
-  char temp[240] = "";
+  char temp[480] = "";
 
   state.updateFocuser(true);
   if (status.focuserFound != SD_TRUE) { handleNotFound(); return; }
@@ -50,18 +50,18 @@ void focuserSelectTileAjax(String &data)
   char temp[80];
 
   if (state.focuserSelected == 0)
-    data.concat(keyValueString("foc_sel", L_INACTIVE));
+    keyValueString(data, "foc_sel", L_INACTIVE);
   else
   {
     snprintf(temp, sizeof(temp), L_FOCUSER "%d " L_SELECTED, state.focuserSelected);
-    data.concat(keyValueString("foc_sel", temp));
+    keyValueString(data, "foc_sel", temp);
   }
-  data.concat(keyValueBoolSelected("foc1_sel", state.focuserSelected == 1));
-  data.concat(keyValueBoolSelected("foc2_sel", state.focuserSelected == 2));
-  data.concat(keyValueBoolSelected("foc3_sel", state.focuserSelected == 3));
-  data.concat(keyValueBoolSelected("foc4_sel", state.focuserSelected == 4));
-  data.concat(keyValueBoolSelected("foc5_sel", state.focuserSelected == 5));
-  data.concat(keyValueBoolSelected("foc6_sel", state.focuserSelected == 6));
+  keyValueBoolSelected(data, "foc1_sel", state.focuserSelected == 1);
+  keyValueBoolSelected(data, "foc2_sel", state.focuserSelected == 2);
+  keyValueBoolSelected(data, "foc3_sel", state.focuserSelected == 3);
+  keyValueBoolSelected(data, "foc4_sel", state.focuserSelected == 4);
+  keyValueBoolSelected(data, "foc5_sel", state.focuserSelected == 5);
+  keyValueBoolSelected(data, "foc6_sel", state.focuserSelected == 6);
   www.sendContentAndClear(data);
 }
 
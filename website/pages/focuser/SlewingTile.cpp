@@ -12,12 +12,14 @@ void focuserSlewingTile(String &data)
 
   snprintf_P(temp, sizeof(temp), html_tile_beg, "22em", "13em", L_SLEWING);
   data.concat(temp);
+  state.lock();
   data.concat(F("<div style='float: right; text-align: right;' id='foc_sta' class='c'>"));
   if (state.focuserSlewing) data.concat(L_ACTIVE); else data.concat(L_INACTIVE);
   data.concat(F("</div><br /><hr>"));
 
   data.concat(L_CURRENT ": <span id='focuserpos' class='c'>");
   data.concat(state.focuserPositionStr);
+  state.unlock();
   data.concat(F("</span><br /><br />"));
 
   data.concat(FPSTR(html_focPosition));
@@ -33,7 +35,9 @@ void focuserSlewingTile(String &data)
     snprintf_P(temp, sizeof(temp), html_collapsable_beg, L_CONTROLS "...");
     data.concat(temp);
 
+    state.lock();
     snprintf_P(temp, sizeof(temp), html_focuserSlewSpeed, state.focuserSlewSpeedStr);
+    state.unlock();
     data.concat(temp);
     data.concat(FPSTR(html_focuserGotoSelect));
 
@@ -47,16 +51,17 @@ void focuserSlewingTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void focuserSlewingTileAjax(String &data)
 {
-  data.concat(keyValueString("foc_sta", state.focuserSlewing ? L_ACTIVE : L_INACTIVE));
-  data.concat(keyValueString("focuserpos", state.focuserPositionStr));
-  data.concat(keyValueString("foc_rate", state.focuserSlewSpeedStr));
-
-  String s;
-  s = keyValueBoolSelected("foc_rate_vs", state.focuserGotoRate == 1); data.concat(s);
-  s = keyValueBoolSelected("foc_rate_s", state.focuserGotoRate == 2); data.concat(s);
-  s = keyValueBoolSelected("foc_rate_n", state.focuserGotoRate == 3 ); data.concat(s);
-  s = keyValueBoolSelected("foc_rate_f", state.focuserGotoRate == 4); data.concat(s);
-  s = keyValueBoolSelected("foc_rate_vf", state.focuserGotoRate == 5); data.concat(s);
+  state.lock();
+  keyValueString(data, "foc_sta", state.focuserSlewing ? L_ACTIVE : L_INACTIVE);
+  keyValueString(data, "focuserpos", state.focuserPositionStr);
+  keyValueString(data, "foc_rate", state.focuserSlewSpeedStr);
+
+  keyValueBoolSelected(data, "foc_rate_vs", state.focuserGotoRate == 1);
+  keyValueBoolSelected(data, "foc_rate_s", state.focuserGotoRate == 2);
+  keyValueBoolSelected(data, "foc_rate_n", state.focuserGotoRate == 3 );
+  keyValueBoolSelected(data, "foc_rate_f", state.focuserGotoRate == 4);
+  keyValueBoolSelected(data, "foc_rate_vf", state.focuserGotoRate == 5);
+  state.unlock();
 
   www.sendContentAndClear(data);
 }
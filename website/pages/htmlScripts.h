@@ -3,20 +3,32 @@
 #include "Pages.common.h"
 
 // Javascript for Ajax return
+// only one request is in flight at a time, values set meanwhile are queued and sent together in the
+// next request (up to the first repeated key) so a burst of controls costs one connection not many
 const char html_script_ajax_get[] PROGMEM =
 "<script>\n"
-"function s(key,v1) {"
+"var sq=[],sb=false;\n"
+"function s(key,v1) { sq.push([key,v1]); if (!sb) sn(); }\n"
+"function sn() {"
+  "var q='',k=[];"
+  "while (sq.length>0 && k.indexOf(sq[0][0])<0) { var p=sq.shift(); k.push(p[0]); q+=p[0]+'='+encodeURIComponent(p[1])+'&'; }"
+  "sb=(q!='');"
+  "if (!sb) return;"
   "var xhttp = new XMLHttpRequest();"
-  "xhttp.open('GET','%s?'+key+'='+encodeURIComponent(v1)+'&x='+new Date().getTime(), true);"
+  "xhttp.onloadend=sn;"
+  "xhttp.open('GET','%s?'+q+'x='+new Date().getTime(), true);"
   "xhttp.send();"
 "}</script>\n";
 
+// sl() is for sliders, a value still waiting to be sent is replaced rather than queued behind so
+// dragging sends the latest value once per round trip
 const char html_script_ajax_shortcuts[] PROGMEM =
 "<script>\n"
 "function g(v1){s('dr',v1);}"
 "function gf(v1){s('dr',v1);autoFastRun();}"
 "function sf(key,v1){s(key,v1);autoFastRun();}"
 "let lzh; function sz(key,v1){clearTimeout(lzh);lzh=setTimeout(s," STR(AJAX_PAGE_LAZY_GET_MS) ",key,v1);}\n"
+"function sl(key,v1){for(var i=0;i<sq.length;i++){if(sq[i][0]==key){sq[i][1]=v1;return;}}s(key,v1);}\n"
 "</script>\n";
 
 // Javascript for Date/Time return
@@ -64,6 +76,7 @@ const char html_script_ajax[] PROGMEM =
 "var auto2Tick=0;\n"
 "var auto2Rate=" STR(AJAX_PAGE_UPDATE_RATE_MS) "/10;\n"
 "var auto1=setInterval(autoRun,10);\n"
+"var ajaxBusy=false;\n"
 "function autoFastRun() {\n"
   "auto2Rate=" STR(AJAX_PAGE_UPDATE_RATE_FAST_MS) "/10\n"
   "auto2Tick=" STR(AJAX_PAGE_UPDATE_FAST_SHED_MS) "/10;\n"
@@ -73,10 +86,13 @@ const char html_script_ajax[] PROGMEM =
   "var i;\n"
   "if (auto2Tick>=0) auto2Tick--;\n"
   "if (auto2Tick==0) auto2Rate=" STR(AJAX_PAGE_UPDATE_RATE_MS) "/10;\n"
-  "if (auto1Tick%auto2Rate==0) {\n"
+  "if (auto1Tick%auto2Rate==0 && !ajaxBusy) {\n"
     "nocache='?nocache='+Math.random()*1000000;\n"
+    "if (typeof ajaxView==='function') nocache+='&'+ajaxView();\n"
     "var request = new XMLHttpRequest();\n"
     "request.onreadystatechange = pageReady(ajaxPage);\n"
+    "request.onloadend = function() { ajaxBusy=false; };\n"
+    "ajaxBusy=true;\n"
     "request.open('GET',ajaxPage.toLowerCase()+nocache,true); request.send(null);\n"
   "}\n"
 "}\n"
@@ -17,10 +17,12 @@ void ambientTile(String &data)
   data.concat(F("<br /><hr>"));
 
   // Ambient conditions
+  state.lock();
   snprintf_P(temp, sizeof(temp), html_indexTPHD, L_AMBIENT_TEMPERATURE ":", 't', state.siteTemperatureStr); data.concat(temp);
   snprintf_P(temp, sizeof(temp), html_indexTPHD, L_PRESSURE ":", 'p', state.sitePressureStr); data.concat(temp);
   snprintf_P(temp, sizeof(temp), html_indexTPHD, L_HUMIDITY ":", 'h', state.siteHumidityStr); data.concat(temp);
   snprintf_P(temp, sizeof(temp), html_indexTPHD, L_DEW_POINT ":", 'd', state.siteDewPointStr); data.concat(temp);
+  state.unlock();
   www.sendContentAndClear(data);
 
   data.concat(F("<hr>"));
@@ -33,10 +35,12 @@ void ambientTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void ambientTileAjax(String &data)
 {
+  state.lock();
   data.concat(F("tphd_t|")); data.concat(state.siteTemperatureStr); data.concat("\n");
   data.concat(F("tphd_p|")); data.concat(state.sitePressureStr); data.concat("\n");
   data.concat(F("tphd_h|")); data.concat(state.siteHumidityStr); data.concat("\n");
   data.concat(F("tphd_d|")); data.concat(state.siteDewPointStr); data.concat("\n");
+  state.unlock();
 
   www.sendContentAndClear(data);
 }
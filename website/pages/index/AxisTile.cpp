@@ -7,13 +7,22 @@
 
 bool decodeParameter(char* s, double *value, long *min, long *max, int *type, char *name);
 
+#if DRIVE_CONFIGURATION == ON
+  // axis parameter descriptors are read from OnStep once and kept, saving a few hundred
+  // command round trips on every index page load; they are reloaded after any axis setting is
+  // sent by the website (other than the edits below) and after AXIS_PARAMETERS_MAX_AGE
+  AxisParameters _axisParameters[9];
+
+  AxisParameters *axisParameters(int axis);
+  void axisParametersFormatValue(AxisParameter *parameter, char *valueStr);
+#endif
+
 // create the related webpage tile
 bool axisTile(int axis, String &data)
 {
   bool success = false;
   char temp[256] = "";
   char temp1[80] = "";
-  double value;
   long min, max;
   int type;
   char name[40];
@@ -33,7 +42,9 @@ bool axisTile(int axis, String &data)
   snprintf_P(temp, sizeof(temp), html_tile_text_beg, "22em", "11em", temp1);
   data.concat(temp);
   data.concat(F("<br /><hr>"));
+  state.lock();
   if (state.driverStatusStr[axis][0] == '?') strcpy(temp1, L_UNKNOWN); else strcpy(temp1, state.driverStatusStr[axis]);
+  state.unlock();
   snprintf_P(temp, sizeof(temp), html_indexDriverStatus, axis, temp1);
   data.concat(temp);
 
@@ -50,136 +61,129 @@ bool axisTile(int axis, String &data)
       data.concat(temp);
       www.sendContentAndClear(data);
 
-      // get axis parameter count
-      snprintf(temp, sizeof(temp), ":GXA%d,0#", axis + 1);
-      if (onStep.command(temp, temp1)) {
-        int parameterCount = atoi(temp1);
+      AxisParameters *parameters = axisParameters(axis);
+      if (parameters != NULL) {
 
         // show controls
-        for (int parameterNumber = 1; parameterNumber <= parameterCount; parameterNumber++) {
-          snprintf(temp, sizeof(temp), ":GXA%d,%d#", axis + 1, parameterNumber);
-          if (onStep.command(temp, temp1)) {
-            decodeParameter(temp1, &value, &min, &max, &type, name);
-
-            // name lookup, for locale specific strings
-            if (name[0] == '$') {
-              int i = atoi(&name[1]);
-              if (i >= 1 && i <= AXPN_COUNT) {
-                switch (i) {
-                  case 1: strcpy_P(name, html_axpn_1); break;
-                  case 2: strcpy_P(name, html_axpn_2); break;
-                  case 3: strcpy_P(name, html_axpn_3); break;
-                  case 4: strcpy_P(name, html_axpn_4); break;
-                  case 5: strcpy_P(name, html_axpn_5); break;
-                  case 6: strcpy_P(name, html_axpn_6); break;
-                  case 7: strcpy_P(name, html_axpn_7); break;
-                  case 8: strcpy_P(name, html_axpn_8); break;
-                  case 9: strcpy_P(name, html_axpn_9); break;
-                  case 10: strcpy_P(name, html_axpn_10); break;
-                  case 11: strcpy_P(name, html_axpn_11); break;
-                  case 12: strcpy_P(name, html_axpn_12); break;
-                  case 13: strcpy_P(name, html_axpn_13); break;
-                  case 14: strcpy_P(name, html_axpn_14); break;
-                  case 15: strcpy_P(name, html_axpn_15); break;
-                  case 16: strcpy_P(name, html_axpn_16); break;
-                  case 17: strcpy_P(name, html_axpn_17); break;
-                  case 18: strcpy_P(name, html_axpn_18); break;
-                  case 19: strcpy_P(name, html_axpn_19); break;
-                  case 20: strcpy_P(name, html_axpn_20); break;
-                  case 21: strcpy_P(name, html_axpn_21); break;
-                  case 22: strcpy_P(name, html_axpn_22); break;
-                  case 23: strcpy_P(name, html_axpn_23); break;
-                  case 24: strcpy_P(name, html_axpn_24); break;
-                  case 25: strcpy_P(name, html_axpn_25); break;
-                  case 26: strcpy_P(name, html_axpn_26); break;
-                }
+        for (int parameterNumber = 1; parameterNumber <= parameters->count; parameterNumber++) {
+          AxisParameter *parameter = &parameters->parameter[parameterNumber - 1];
+          min = parameter->min;
+          max = parameter->max;
+          type = parameter->type;
+          strcpy(name, parameter->name);
+
+          // name lookup, for locale specific strings
+          if (name[0] == '$') {
+            int i = atoi(&name[1]);
+            if (i >= 1 && i <= AXPN_COUNT) {
+              switch (i) {
+                case 1: strcpy_P(name, html_axpn_1); break;
+                case 2: strcpy_P(name, html_axpn_2); break;
+                case 3: strcpy_P(name, html_axpn_3); break;
+                case 4: strcpy_P(name, html_axpn_4); break;
+                case 5: strcpy_P(name, html_axpn_5); break;
+                case 6: strcpy_P(name, html_axpn_6); break;
+                case 7: strcpy_P(name, html_axpn_7); break;
+                case 8: strcpy_P(name, html_axpn_8); break;
+                case 9: strcpy_P(name, html_axpn_9); break;
+                case 10: strcpy_P(name, html_axpn_10); break;
+                case 11: strcpy_P(name, html_axpn_11); break;
+                case 12: strcpy_P(name, html_axpn_12); break;
+                case 13: strcpy_P(name, html_axpn_13); break;
+                case 14: strcpy_P(name, html_axpn_14); break;
+                case 15: strcpy_P(name, html_axpn_15); break;
+                case 16: strcpy_P(name, html_axpn_16); break;
+                case 17: strcpy_P(name, html_axpn_17); break;
+                case 18: strcpy_P(name, html_axpn_18); break;
+                case 19: strcpy_P(name, html_axpn_19); break;
+                case 20: strcpy_P(name, html_axpn_20); break;
+                case 21: strcpy_P(name, html_axpn_21); break;
+                case 22: strcpy_P(name, html_axpn_22); break;
+                case 23: strcpy_P(name, html_axpn_23); break;
+                case 24: strcpy_P(name, html_axpn_24); break;
+                case 25: strcpy_P(name, html_axpn_25); break;
+                case 26: strcpy_P(name, html_axpn_26); break;
               }
+            }
 
-              // if element 7 (reverse) is present, which it always is, show the Motor/Driver identification string
-              if (i == 7) {
-                data.concat("<br />" L_ADV_MOTOR ": ");
-                snprintf(temp, sizeof(temp), ":GXA%d,M#", axis + 1);
-                if (onStep.command(temp, temp1)) {
-                  data.concat(temp1);
-                } else {
-                  data.concat("?");
-                }
-                data.concat("<br />");
-              }
+            // if element 7 (reverse) is present, which it always is, show the Motor/Driver identification string
+            if (i == 7) {
+              data.concat("<br />" L_ADV_MOTOR ": ");
+              data.concat(parameters->motor);
+              data.concat("<br />");
             }
+          }
 
-            if (type == 2 || type == 4 || type == 6) strcat(name, " (<i>i</i>)");
-
-            long valueInt = lround(value);
-            char valueStr[24];
-            dtostrf(value, 1, 3, valueStr);
-            convert.stripNumericStr(valueStr, true);
-
-            switch (type) {
-              // AXP_BOOLEAN, AXP_BOOLEAN_IMMEDIATE
-              case 1: case 2: {
-                snprintf_P(temp, sizeof(temp), html_configAxisSelectStart, axis + 1, parameterNumber);
-                data.concat(temp);
-                int selection[4] = {-1, -2, 0, 1};
-                const char *selectionName[5] = {L_OFF, L_ON, L_OFF, L_ON};
-                for (int i = 0; i < 4; i++) {
-                  if (selection[i] >= min && selection[i] <= max) {
-                    snprintf_P(temp, sizeof(temp), valueInt == selection[i] ? html_configAxisSelectOptionSelected : html_configAxisSelectOption, selection[i], selectionName[i]);
-                    data.concat(temp);
-                    www.sendContentAndClear(data);
-                  }
+          if (type == 2 || type == 4 || type == 6) strcat(name, " (<i>i</i>)");
+
+          long valueInt = lround(parameter->value);
+          char valueStr[24];
+          axisParametersFormatValue(parameter, valueStr);
+
+          switch (type) {
+            // AXP_BOOLEAN, AXP_BOOLEAN_IMMEDIATE
+            case 1: case 2: {
+              snprintf_P(temp, sizeof(temp), html_configAxisSelectStart, axis + 1, parameterNumber);
+              data.concat(temp);
+              int selection[4] = {-1, -2, 0, 1};
+              const char *selectionName[5] = {L_OFF, L_ON, L_OFF, L_ON};
+              for (int i = 0; i < 4; i++) {
+                if (selection[i] >= min && selection[i] <= max) {
+                  snprintf_P(temp, sizeof(temp), valueInt == selection[i] ? html_configAxisSelectOptionSelected : html_configAxisSelectOption, selection[i], selectionName[i]);
+                  data.concat(temp);
+                  www.sendContentAndClear(data);
                 }
-                snprintf_P(temp, sizeof(temp), html_configAxisSelectEnd, name);
-                data.concat(temp);
-              } break;
-
-              // AXP_INTEGER, AXP_INTEGER_IMMEDIATE
-              case 3: case 4:
-                snprintf_P(temp, sizeof(temp), html_configAxisInt, valueInt, axis + 1, parameterNumber, min, max, name);
-                data.concat(temp);
-              break;
-
-              // AXP_FLOAT, AXP_FLOAT_IMMEDIATE
-              case 5: case 6:
-                snprintf_P(temp, sizeof(temp), html_configAxisFloat, valueStr, axis + 1, parameterNumber, min, max, name);
-                data.concat(temp);
-              break;
-
-              // AXP_POW2
-              case 9: {
-                snprintf_P(temp, sizeof(temp), html_configAxisSelectStart, axis + 1, parameterNumber);
-                data.concat(temp);
-                int selection[9] = {1, 2, 4, 8, 16, 32, 64, 128, 256};
-                const char *selectionName[9] = {"1", "2", "4", "8", "16", "32", "64", "128", "256"};
-                for (int i = 0; i < 9; i++) {
-                  if (selection[i] >= min && selection[i] <= max) {
-                    snprintf_P(temp, sizeof(temp), valueInt == selection[i] ? html_configAxisSelectOptionSelected : html_configAxisSelectOption, selection[i], selectionName[i]);
-                    data.concat(temp);
-                    www.sendContentAndClear(data);
-                  }
+              }
+              snprintf_P(temp, sizeof(temp), html_configAxisSelectEnd, name);
+              data.concat(temp);
+            } break;
+
+            // AXP_INTEGER, AXP_INTEGER_IMMEDIATE
+            case 3: case 4:
+              snprintf_P(temp, sizeof(temp), html_configAxisInt, valueInt, axis + 1, parameterNumber, min, max, name);
+              data.concat(temp);
+            break;
+
+            // AXP_FLOAT, AXP_FLOAT_IMMEDIATE
+            case 5: case 6:
+              snprintf_P(temp, sizeof(temp), html_configAxisFloat, valueStr, axis + 1, parameterNumber, min, max, name);
+              data.concat(temp);
+            break;
+
+            // AXP_POW2
+            case 9: {
+              snprintf_P(temp, sizeof(temp), html_configAxisSelectStart, axis + 1, parameterNumber);
+              data.concat(temp);
+              int selection[9] = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+              const char *selectionName[9] = {"1", "2", "4", "8", "16", "32", "64", "128", "256"};
+              for (int i = 0; i < 9; i++) {
+                if (selection[i] >= min && selection[i] <= max) {
+                  snprintf_P(temp, sizeof(temp), valueInt == selection[i] ? html_configAxisSelectOptionSelected : html_configAxisSelectOption, selection[i], selectionName[i]);
+                  data.concat(temp);
+                  www.sendContentAndClear(data);
                 }
-                snprintf_P(temp, sizeof(temp), html_configAxisSelectEnd, name);
-                data.concat(temp);
-              } break;
-
-              // AXP_DECAY
-              case 10: {
-                snprintf_P(temp, sizeof(temp), html_configAxisSelectStart, axis + 1, parameterNumber);
-                data.concat(temp);
-                int selection[5] = {1, 2, 3, 4, 5};
-                const char *selectionName[5] = {L_ADV_DECAY_MIXED, L_ADV_DECAY_FAST, L_ADV_DECAY_SLOW, L_ADV_DECAY_SPREADCYCLE, L_ADV_DECAY_STEALTHCHOP};
-                for (int i = 0; i < 5; i++) {
-                  if (selection[i] >= min && selection[i] <= max) {
-                    snprintf_P(temp, sizeof(temp), valueInt == selection[i] ? html_configAxisSelectOptionSelected : html_configAxisSelectOption, selection[i], selectionName[i]);
-                    data.concat(temp);
-                    www.sendContentAndClear(data);
-                  }
+              }
+              snprintf_P(temp, sizeof(temp), html_configAxisSelectEnd, name);
+              data.concat(temp);
+            } break;
+
+            // AXP_DECAY
+            case 10: {
+              snprintf_P(temp, sizeof(temp), html_configAxisSelectStart, axis + 1, parameterNumber);
+              data.concat(temp);
+              int selection[5] = {1, 2, 3, 4, 5};
+              const char *selectionName[5] = {L_ADV_DECAY_MIXED, L_ADV_DECAY_FAST, L_ADV_DECAY_SLOW, L_ADV_DECAY_SPREADCYCLE, L_ADV_DECAY_STEALTHCHOP};
+              for (int i = 0; i < 5; i++) {
+                if (selection[i] >= min && selection[i] <= max) {
+                  snprintf_P(temp, sizeof(temp), valueInt == selection[i] ? html_configAxisSelectOptionSelected : html_configAxisSelectOption, selection[i], selectionName[i]);
+                  data.concat(temp);
+                  www.sendContentAndClear(data);
                 }
-                snprintf_P(temp, sizeof(temp), html_configAxisSelectEnd, name);
-                data.concat(temp);
-              } break;
-              
-            }
+              }
+              snprintf_P(temp, sizeof(temp), html_configAxisSelectEnd, name);
+              data.concat(temp);
+            } break;
+            
           }
         }
 
@@ -216,8 +220,10 @@ void axisTileAjax(int axis, String &data)
   char temp[80], temp1[80];
 
   snprintf(temp, sizeof(temp), "dvr_stat%d", axis);
+  state.lock();
   if (state.driverStatusStr[axis][0] == '?') strcpy(temp1, L_UNKNOWN); else strcpy(temp1, state.driverStatusStr[axis]);
-  data.concat(keyValueString(temp, temp1));
+  state.unlock();
+  keyValueString(data, temp, temp1);
 
   www.sendContentAndClear(data);
 }
@@ -233,16 +239,21 @@ void axisTileGet()
 
   #if DRIVE_CONFIGURATION == ON
  
+    // advanced configuration toggled, the parameters available may change
+    if (!www.arg("advanced").equals(EmptyStr)) axisParametersInvalidate(-1);
+
     String ssr = www.arg("revert");
     if (!ssr.equals(EmptyStr)) {
       int axis = ssr.toInt();
       if (axis == 0) {
         strcpy(command, ":SXEM,0#");
         onStep.commandBool(command);
+        axisParametersInvalidate(-1);
       } else
       if (axis >= 1 && axis <= 9) {
         snprintf(command, sizeof(command), ":SXA%d,R#",axis);
         onStep.commandBool(command);
+        axisParametersInvalidate(axis - 1);
       }
       return;
     }
@@ -258,21 +269,94 @@ void axisTileGet()
     }
     if (axisNumber == 0) return;
 
-    // get axis parameter count
-    snprintf(command, sizeof(command), ":GXA%d,0#", axisNumber);
-    if (!onStep.command(command, response)) return;
-    int parameterCount = atoi(response);
+    AxisParameters *parameters = axisParameters(axisNumber - 1);
+    if (parameters == NULL) return;
+    unsigned long axisWrites = onStep.axisWrites;
+
+    // send only the edited axis parameters to OnStepX, then read back the values it settled on
+    char valueStr[24];
+    for (int parameterNumber = 1; parameterNumber <= parameters->count; parameterNumber++) {
+      AxisParameter *parameter = &parameters->parameter[parameterNumber - 1];
 
-    // send axis parameters to OnStepX
-    for (int parameterNumber = 1; parameterNumber <= parameterCount; parameterNumber++) {
       snprintf(argStr, sizeof(argStr), "a%dp%dvalue", axisNumber, parameterNumber);
       String parameterValue = www.arg(argStr);
+      if (parameterValue.equals(EmptyStr)) continue;
+
+      axisParametersFormatValue(parameter, valueStr);
+      if (parameterValue.equals(valueStr)) continue;
+
       snprintf(command, sizeof(command), ":SXA%d,%d,%s#", axisNumber, parameterNumber, parameterValue.c_str());
       onStep.commandBool(command);
+
+      snprintf(command, sizeof(command), ":GXA%d,%d#", axisNumber, parameterNumber);
+      if (!onStep.command(command, response) ||
+          !decodeParameter(response, &parameter->value, &parameter->min, &parameter->max, &parameter->type, parameter->name)) {
+        parameters->valid = false;
+      }
     }
+
+    // the writes since were these, already read back, so descriptors that were current still are
+    for (int i = 0; i < 9; i++) if (_axisParameters[i].axisWrites == axisWrites) _axisParameters[i].axisWrites = onStep.axisWrites;
   #endif
 }
 
+#if DRIVE_CONFIGURATION == ON
+  // get the parameter descriptors for this axis (0 to 8), reading them from OnStep if not already known
+  AxisParameters *axisParameters(int axis)
+  {
+    AxisParameters *parameters = &_axisParameters[axis];
+    if (parameters->valid && parameters->axisWrites == onStep.axisWrites &&
+        (long)(millis() - parameters->loadTime) < AXIS_PARAMETERS_MAX_AGE) return parameters;
+    parameters->valid = false;
+    unsigned long axisWrites = onStep.axisWrites;
+
+    char command[20], response[80];
+
+    // get axis parameter count
+    snprintf(command, sizeof(command), ":GXA%d,0#", axis + 1);
+    if (!onStep.command(command, response)) return NULL;
+    int parameterCount = atoi(response);
+    if (parameterCount < 0 || parameterCount > AXIS_PARAMETER_COUNT_MAX) return NULL;
+
+    strcpy(parameters->motor, "?");
+    for (int parameterNumber = 1; parameterNumber <= parameterCount; parameterNumber++) {
+      AxisParameter *parameter = &parameters->parameter[parameterNumber - 1];
+
+      snprintf(command, sizeof(command), ":GXA%d,%d#", axis + 1, parameterNumber);
+      if (!onStep.command(command, response)) return NULL;
+
+      // a parameter that can't be decoded is kept as an unknown type, which isn't shown
+      if (!decodeParameter(response, &parameter->value, &parameter->min, &parameter->max, &parameter->type, parameter->name)) parameter->type = 0;
+
+      // element 7 (reverse) is always present, also get the Motor/Driver identification string
+      if (!strcmp(parameter->name, "$7")) {
+        snprintf(command, sizeof(command), ":GXA%d,M#", axis + 1);
+        if (onStep.command(command, response)) sstrcpyex(parameters->motor, response, sizeof(parameters->motor));
+      }
+    }
+
+    parameters->count = parameterCount;
+    parameters->loadTime = millis();
+    parameters->axisWrites = axisWrites;
+    parameters->valid = true;
+    return parameters;
+  }
+
+  // format the parameter value the same way it is shown (and later returned) in the form
+  void axisParametersFormatValue(AxisParameter *parameter, char *valueStr)
+  {
+    if (parameter->type == 5 || parameter->type == 6) {
+      dtostrf(parameter->value, 1, 3, valueStr);
+      convert.stripNumericStr(valueStr, true);
+    } else sprintf(valueStr, "%ld", lround(parameter->value));
+  }
+
+  void axisParametersInvalidate(int axis)
+  {
+    for (int i = 0; i < 9; i++) if (axis < 0 || axis == i) _axisParameters[i].valid = false;
+  }
+#endif
+
 bool decodeParameter(char* s, double *value, long *min, long *max, int *type, char *name) {
   char *ws = s;
   char *conv_end;
@@ -10,6 +10,33 @@ extern bool axisTile(int axis, String &data);
 extern void axisTileAjax(int axis, String &data);
 extern void axisTileGet();
 
+#if DRIVE_CONFIGURATION == ON
+  #define AXIS_PARAMETER_COUNT_MAX 32
+
+  // descriptors are reloaded when this old (in ms), to pick up settings changed over another command channel
+  #define AXIS_PARAMETERS_MAX_AGE 60000
+
+  typedef struct AxisParameter {
+    double value;
+    long min;
+    long max;
+    int type;
+    char name[20];
+  } AxisParameter;
+
+  typedef struct AxisParameters {
+    bool valid;
+    unsigned long loadTime;     // millis() when read from OnStep
+    unsigned long axisWrites;   // onStep.axisWrites when read, any axis setting sent since means reloading
+    int count;
+    char motor[40];
+    AxisParameter parameter[AXIS_PARAMETER_COUNT_MAX];
+  } AxisParameters;
+
+  // forget the cached parameter descriptors for an axis (0 to 8), or all axes if -1
+  extern void axisParametersInvalidate(int axis);
+#endif
+
 const char html_indexDriverStatus[] PROGMEM = L_DRIVER " " L_STATUS ": <span id='dvr_stat%d' class='c'>%s</span><br />";
 
 const char html_configAdvanced[] PROGMEM =
@@ -9,7 +9,7 @@ void processIndexGet();
 
 void handleRoot()
 {
-  char temp[240] = "";
+  char temp[480] = "";
 
   state.updateController(true);
 
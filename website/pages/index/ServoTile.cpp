@@ -6,6 +6,10 @@
 
 #include "../KeyValue.h"
 #include "../Pages.common.h"
+#include "../../libApp/servo/ServoMonitor.h"
+
+// most samples returned by one servo.bin or servo.csv request
+#define SERVO_STREAM_SAMPLES_MAX 512
 
 int _servo_axis = 0;
 
@@ -15,16 +19,13 @@ void servoTile(String &data)
   char temp[800] = "";
 
   // javascript to keep servo canvas updated
-  strcpy_P(temp, html_servoScript1);
-  data.concat(temp);
+  data.concat(FPSTR(html_servoScript1));
   www.sendContentAndClear(data);
 
-  strcpy_P(temp, html_servoScript2);
-  data.concat(temp);
+  data.concat(FPSTR(html_servoScript2));
   www.sendContentAndClear(data);
 
-  strcpy_P(temp, html_servoScript3);
-  data.concat(temp);
+  data.concat(FPSTR(html_servoScript3));
   www.sendContentAndClear(data);
 
   // servo monitor tile start
@@ -59,61 +60,67 @@ void servoTile(String &data)
 
 double _stepsPerMeasure[9] = {-1,-1,-1,-1,-1,-1,-1,-1,-1};
 
+// get steps per measure for this axis, 0 if unknown
+double servoStepsPerMeasure(int axis)
+{
+  if (axis < 1 || axis > 9) return 0.0;
+
+  if (_stepsPerMeasure[axis - 1] < 0) {
+    _stepsPerMeasure[axis - 1] = 0.0;
+    char command[10], result[120];
+    snprintf(command, sizeof(command), ":GXA%d,1#", axis);
+    if (!onStep.command(command, result)) strcpy(result, "0");
+    char *conv_end;
+    double stepsPerMeasure = strtod(result, &conv_end);
+    if (&result[0] != conv_end) {
+      _stepsPerMeasure[axis - 1] = stepsPerMeasure;
+    }
+  }
+  return _stepsPerMeasure[axis - 1];
+}
+
 // use Ajax key/value pairs to pass related data to the web client in the background
+// delta and power are the newest sample the servo monitor recorded, so no command is sent here
 void servoTileAjax(String &data)
 {
-  char temp[120] = "", command[10];
+  char temp[120] = "";
 
   if (_servo_axis == 0) strcpy(temp, "svoA|?\n"); else snprintf(temp, sizeof(temp), "svoA|%d\n", _servo_axis); data.concat(temp);
 
-  snprintf(command, sizeof(command), ":GXS%d#", _servo_axis);
-  if (_servo_axis >= 1 && _servo_axis <= 9 && onStep.command(command, temp)) {
-
-    // make sure we have steps per measure for this axis
-    if (_stepsPerMeasure[_servo_axis - 1] < 0) {
-      _stepsPerMeasure[_servo_axis - 1] = 0.0;
-      char result[120];
-      snprintf(command, sizeof(command), ":GXA%d,1#", _servo_axis);
-      if (!onStep.command(command, result)) strcpy(result, "0");
-      char *conv_end;
-      double stepsPerMeasure = strtod(result, &conv_end);
-      if (&temp[0] != conv_end) {
-        _stepsPerMeasure[_servo_axis - 1] = stepsPerMeasure;
-      }
+  ServoSample sample;
+  uint32_t from = servoMonitor.next() - 1;
+  if (_servo_axis >= 1 && _servo_axis <= 9 && servoMonitor.next() > 0 && servoMonitor.read(&from, &sample, 1) == 1 &&
+      sample.axis == _servo_axis && (uint32_t)millis() - sample.time <= 2000) {
+
+    double stepsPerMeasure = servoStepsPerMeasure(_servo_axis);
+
+    sprintF(temp, "%1.1f", sample.power/10.0);
+    data.concat(F("svoP|")); data.concat(temp); data.concat("\n");
+
+    // convert to 1/10 arc-second units (if possible)
+    long delta;
+    if (stepsPerMeasure != 0.0 && _servo_axis <= 3) {
+      delta = round((sample.delta/stepsPerMeasure)*3600.0*10.0);
+      data.concat(F("units|asec\n"));
+      sprintF(temp,"%1.1f", delta/10.0);
+    } else {
+      delta = sample.delta;
+      data.concat(F("units|stps\n"));
+      snprintf(temp, sizeof(temp), "%ld", delta);
     }
 
-    char *temp1 = strchr(temp, ',');
-    if (temp1 != NULL) {
-      temp1[0] = 0;
-      temp1++;
-
-      data.concat(F("svoP|")); data.concat(temp1); data.concat("\n");
-
-      // convert to 1/10 arc-second units (if possible)
-      long delta;
-      if (_stepsPerMeasure[_servo_axis - 1] != 0.0 && _servo_axis >= 1 && _servo_axis <= 3) {
-        delta = round((atoi(temp)/_stepsPerMeasure[_servo_axis - 1])*3600.0*10.0);
-        data.concat(F("units|asec\n"));
-        sprintF(temp,"%1.1f", delta/10.0);
-      } else {
-        delta = round(atoi(temp));
-        data.concat(F("units|stps\n"));
-        snprintf(temp, sizeof(temp), "%ld", delta);
-      }
-
-      data.concat(F("svoD|")); data.concat(temp); data.concat("\n");
-    } else { data.concat(F("svoD|?\n")); data.concat(F("svoP|?\n")); }
-  } else { data.concat(F("svoD|?\n")); data.concat(F("svoP|?\n")); _servo_axis = 0; }
-
-  data.concat(keyValueBoolEnabled("svax1", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax2", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax3", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax4", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax5", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax6", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax7", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax8", _servo_axis == 0));
-  data.concat(keyValueBoolEnabled("svax9", _servo_axis == 0));
+    data.concat(F("svoD|")); data.concat(temp); data.concat("\n");
+  } else { data.concat(F("svoD|?\n")); data.concat(F("svoP|?\n")); }
+
+  keyValueBoolEnabled(data, "svax1", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax2", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax3", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax4", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax5", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax6", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax7", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax8", _servo_axis == 0);
+  keyValueBoolEnabled(data, "svax9", _servo_axis == 0);
 
   www.sendContentAndClear(data);
 }
@@ -127,7 +134,7 @@ void servoTileGet()
   v = www.arg("svax");
   if (!v.equals(EmptyStr)) {
     int axis = v.toInt();
-    if (axis >= 0 && axis <= 9) _servo_axis = axis;
+    if (axis >= 0 && axis <= 9) { _servo_axis = axis; servoMonitor.setAxis(axis); }
   }
 
   // intercept advanced configuration toggle on and trigger spm reload
@@ -139,4 +146,85 @@ void servoTileGet()
 
 }
 
+// scale from steps to display units (arc-seconds for axes 1 to 3 when known, otherwise steps)
+float servoScale(int axis)
+{
+  double stepsPerMeasure = servoStepsPerMeasure(axis);
+  if (stepsPerMeasure != 0.0 && axis >= 1 && axis <= 3) return 3600.0/stepsPerMeasure; else return 1.0;
+}
+
+// binary stream of the servo samples recorded since sequence number "from"
+// little-endian header: uint32 first sequence number, uint16 count, uint16 sample rate (Hz), float32 scale
+// followed by count records: int32 delta (steps), int16 power (0.1% units)
+void servoAjaxBinary()
+{
+  uint8_t buffer[12 + SERVO_STREAM_SAMPLES_MAX*6];
+  ServoSample samples[32];
+
+  uint32_t first = strtoul(www.arg("from").c_str(), NULL, 10);
+  uint32_t seq = first;
+  uint16_t count = 0;
+  while (count < SERVO_STREAM_SAMPLES_MAX) {
+    int n = servoMonitor.read(&seq, samples, min(32, SERVO_STREAM_SAMPLES_MAX - count));
+    if (n == 0) break;
+    if (count == 0) first = seq;
+    for (int i = 0; i < n; i++) {
+      memcpy(&buffer[12 + count*6], &samples[i].delta, 4);
+      memcpy(&buffer[12 + count*6 + 4], &samples[i].power, 2);
+      count++;
+    }
+    seq += n;
+  }
+  if (count == 0) first = servoMonitor.next();
+
+  uint16_t rate = servoMonitor.rate;
+  float scale = servoScale(servoMonitor.getAxis());
+  memcpy(&buffer[0], &first, 4);
+  memcpy(&buffer[4], &count, 2);
+  memcpy(&buffer[6], &rate, 2);
+  memcpy(&buffer[8], &scale, 4);
+
+  size_t length = 12 + count*6;
+  www.sendHeader("Cache-Control", "no-cache");
+  www.setContentLength(length);
+  www.send(200, "application/octet-stream", "");
+  www.sendContent((const char*)buffer, length);
+
+  state.lastControllerPageLoadTime = millis();
+}
+
+// the servo samples held in the ring buffer as CSV, for offline analysis
+void servoCsv()
+{
+  String data;
+  char temp[80];
+  ServoSample samples[32];
+
+  www.sendHeader("Cache-Control", "no-cache");
+  www.sendHeader("Content-Disposition", "attachment; filename=servo.csv");
+  www.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  www.send(200, "text/csv", String());
+
+  float scale = servoScale(servoMonitor.getAxis());
+  snprintf(temp, sizeof(temp), "sequence,time_ms,delta_steps,delta_%s,power_pct\n", scale == 1.0F ? "steps" : "asec");
+  data.concat(temp);
+
+  uint32_t seq = 0;
+  int n;
+  while ((n = servoMonitor.read(&seq, samples, 32)) > 0) {
+    for (int i = 0; i < n; i++) {
+      snprintf(temp, sizeof(temp), "%lu,%lu,%ld,", (unsigned long)(seq + i), (unsigned long)samples[i].time, (long)samples[i].delta);
+      data.concat(temp);
+      sprintF(temp, "%1.2f", samples[i].delta*scale);
+      data.concat(temp);
+      sprintF(temp, ",%1.1f\n", samples[i].power/10.0);
+      data.concat(temp);
+    }
+    www.sendContentAndClear(data);
+    seq += n;
+  }
+
+  www.sendContent("");
+}
+
 #endif
@@ -25,6 +25,7 @@ void statusTile(String &data)
     }
   }
 
+  state.lock();
   snprintf_P(temp, sizeof(temp), html_indexGeneralError, state.lastErrorStr);
   data.concat(temp);
 
@@ -43,6 +44,7 @@ void statusTile(String &data)
     snprintf_P(temp, sizeof(temp), html_indexSignalStrength, state.signalStrengthStr);
     data.concat(temp);
   #endif
+  state.unlock();
 
   data.concat(F("<hr>"));
   www.sendContentAndClear(data);
@@ -107,6 +109,7 @@ void statusTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void statusTileAjax(String &data)
 {
+  state.lock();
   #if DISPLAY_INTERNAL_TEMPERATURE == ON
     data.concat(F("tphd_m|"));
     data.concat(state.controllerTemperatureStr);
@@ -129,6 +132,7 @@ void statusTileAjax(String &data)
     data.concat(state.signalStrengthStr);
     data.concat("\n");
   #endif
+  state.unlock();
 
   www.sendContentAndClear(data);
 }
@@ -13,6 +13,7 @@ void alignTile(String &data)
   snprintf_P(temp, sizeof(temp), html_tile_beg, "22em", "15em", L_ALIGN);
   data.concat(temp);
 
+  state.lock();
   data.concat(F("<div style='float: right; text-align: right;' id='align_progress' class='c'>"));
   data.concat(state.alignProgress);
   data.concat(F("</div><br /><hr>"));
@@ -22,6 +23,7 @@ void alignTile(String &data)
 
   snprintf_P(temp, sizeof(temp), html_alignCorrection, state.alignLrStr, state.alignUdStr, poleName);
   data.concat(temp);
+  state.unlock();
   www.sendContentAndClear(data);
 
   byte sc[3];
@@ -87,14 +89,16 @@ void alignTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void alignTileAjax(String &data)
 {
-  data.concat(keyValueString("align_progress", state.alignProgress));
-  data.concat(keyValueString("align_lr", state.alignLrStr));
-  data.concat(keyValueString("align_ud", state.alignUdStr));
-  data.concat(keyValueBoolEnabled("alg1", !status.tracking && !status.parked && status.atHome));
-  data.concat(keyValueBoolEnabled("alg2", !status.tracking && !status.parked && status.atHome));
-  data.concat(keyValueBoolEnabled("alg3", !status.tracking && !status.parked && status.atHome));
-  data.concat(keyValueBoolEnabled("alga", status.tracking && status.aligning));
-  data.concat(keyValueBoolEnabled("rpa", status.tracking && !status.aligning));
+  state.lock();
+  keyValueString(data, "align_progress", state.alignProgress);
+  keyValueString(data, "align_lr", state.alignLrStr);
+  keyValueString(data, "align_ud", state.alignUdStr);
+  state.unlock();
+  keyValueBoolEnabled(data, "alg1", !status.tracking && !status.parked && status.atHome);
+  keyValueBoolEnabled(data, "alg2", !status.tracking && !status.parked && status.atHome);
+  keyValueBoolEnabled(data, "alg3", !status.tracking && !status.parked && status.atHome);
+  keyValueBoolEnabled(data, "alga", status.tracking && status.aligning);
+  keyValueBoolEnabled(data, "rpa", status.tracking && !status.aligning);
   www.sendContentAndClear(data);
 }
 
@@ -1,6 +1,7 @@
 // -----------------------------------------------------------------------------------
 // Goto tile
 #include "GotoTile.h"
+#include "Mount.h"
 
 #include "../KeyValue.h"
 #include "../Pages.common.h"
@@ -42,6 +43,7 @@ void gotoTile(String &data)
   snprintf_P(temp, sizeof(temp), html_tile_beg, "22em", "15em", "Goto");
   data.concat(temp);
 
+  state.lock();
   data.concat(F("<div style='float: right; text-align: right;' id='gto_status' class='c'>"));
   snprintf(temp, sizeof(temp), "%s || %c", status.inGoto ? L_SLEWING : L_INACTIVE, state.pierSideStr[0]);
   data.concat(temp);
@@ -52,6 +54,7 @@ void gotoTile(String &data)
   data.concat(temp);
   snprintf_P(temp, sizeof(temp), html_mountPositionAxis2, state.indexAltStr, state.indexDecStr, state.targetDecStr);
   data.concat(temp);
+  state.unlock();
 
   www.sendContentAndClear(data);
 
@@ -67,7 +70,9 @@ void gotoTile(String &data)
   data.concat(temp);
 
   // Slew speed
+  state.lock();
   snprintf_P(temp, sizeof(temp), html_slewSpeed, state.slewSpeedStr);
+  state.unlock();
   data.concat(temp);
   data.concat(FPSTR(html_slewSpeedSelect));
 
@@ -116,43 +121,47 @@ void gotoTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void gotoTileAjax(String &data)
 {
+  state.lock();
 
   char pss[2] = "N";
   pss[0] = state.pierSideStr[0];
 
-  data.concat(keyValueString("gto_status", status.inGoto ? L_SLEWING : L_INACTIVE, " || ", pss));
+  keyValueString(data, "gto_status", status.inGoto ? L_SLEWING : L_INACTIVE, " || ", pss);
 
-  data.concat(keyValueString("gto_t1", state.targetRaStr));
-  data.concat(keyValueString("gto_t2", state.targetDecStr));
-  data.concat(keyValueString("gto_i1", state.indexRaStr));
-  data.concat(keyValueString("gto_i2", state.indexDecStr));
-  data.concat(keyValueString("gto_az1", state.indexAzmStr));
-  data.concat(keyValueString("gto_az2", state.indexAltStr));
+  keyValueString(data, "gto_t1", state.targetRaStr);
+  keyValueString(data, "gto_t2", state.targetDecStr);
+  keyValueString(data, "gto_i1", state.indexRaStr);
+  keyValueString(data, "gto_i2", state.indexDecStr);
+  keyValueString(data, "gto_az1", state.indexAzmStr);
+  keyValueString(data, "gto_az2", state.indexAltStr);
 
-  data.concat(keyValueBoolEnabled("gto_active", status.inGoto));
+  keyValueBoolEnabled(data, "gto_active", status.inGoto);
 
-  data.concat(keyValueToggleBoolSelected("gto_bzr_on", "gto_bzr_off", status.buzzerEnabled));
+  // the rest are controls, only when they're open
+  if (!mountTileVisible("goto", true)) { state.unlock(); www.sendContentAndClear(data); return; }
+
+  keyValueToggleBoolSelected(data, "gto_bzr_on", "gto_bzr_off", status.buzzerEnabled);
 
   if (status.mountType == MT_GEM || (status.getVersionMajor() >= 10 && status.meridianFlips))
   {
-    data.concat(keyValueBoolEnabled("gto_mfa_on", true));
-    data.concat(keyValueBoolEnabled("gto_mfa_off", true));
-    data.concat(keyValueToggleBoolSelected("gto_mfa_on", "gto_mfa_off", status.autoMeridianFlips));
-    data.concat(keyValueToggleBoolSelected("gto_mfp_on", "gto_mfp_off", status.pauseAtHome));
+    keyValueBoolEnabled(data, "gto_mfa_on", true);
+    keyValueBoolEnabled(data, "gto_mfa_off", true);
+    keyValueToggleBoolSelected(data, "gto_mfa_on", "gto_mfa_off", status.autoMeridianFlips);
+    keyValueToggleBoolSelected(data, "gto_mfp_on", "gto_mfp_off", status.pauseAtHome);
   } else {
-    data.concat(keyValueBoolEnabled("gto_mfa_on", false));
-    data.concat(keyValueBoolEnabled("gto_mfa_off", false));
+    keyValueBoolEnabled(data, "gto_mfa_on", false);
+    keyValueBoolEnabled(data, "gto_mfa_off", false);
   }
 
   if (status.mountType != MT_ALTAZM || (status.getVersionMajor() >= 10 && status.meridianFlips))
   {
-    data.concat(keyValueBoolSelected("gto_pps_east", state.preferredPierSideChar == 'E'));
-    data.concat(keyValueBoolSelected("gto_pps_west", state.preferredPierSideChar == 'W'));
-    data.concat(keyValueBoolSelected("gto_pps_best", state.preferredPierSideChar == 'B'));
-    data.concat(keyValueBoolSelected("gto_pps_auto", state.preferredPierSideChar == 'A'));
+    keyValueBoolSelected(data, "gto_pps_east", state.preferredPierSideChar == 'E');
+    keyValueBoolSelected(data, "gto_pps_west", state.preferredPierSideChar == 'W');
+    keyValueBoolSelected(data, "gto_pps_best", state.preferredPierSideChar == 'B');
+    keyValueBoolSelected(data, "gto_pps_auto", state.preferredPierSideChar == 'A');
   }
 
-  data.concat(keyValueString("gto_rate", state.slewSpeedStr));
+  keyValueString(data, "gto_rate", state.slewSpeedStr);
 
   if (!isnan(state.slewSpeedNominal) && !isnan(state.slewSpeedCurrent))
   {
@@ -165,11 +174,9 @@ void gotoTileAjax(String &data)
     else if (rateRatio > 0.875F) { rate_en[2] = true; }
     else if (rateRatio > 0.625F) { rate_en[3] = true; }
     else rate_en[4] = true;
-    for (int i = 0; i < 5; i++) {
-      String s = keyValueBoolSelected(rate_key[i], rate_en[i]);
-      data.concat(s);
-    }
+    for (int i = 0; i < 5; i++) keyValueBoolSelected(data, rate_key[i], rate_en[i]);
   }
+  state.unlock();
 
   www.sendContentAndClear(data);
 }
@@ -45,20 +45,20 @@ void guideTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void guideTileAjax(String &data)
 {
-  data.concat(keyValueString("guide_sta", status.guiding ? L_SLEWING : L_INACTIVE));
-
-  data.concat(keyValueString("guide_rate", GuideRatesStr[status.guideRate]));
-
-  data.concat(keyValueBoolSelected("guide_r0", status.guideRatePulse == 0 || status.guideRate == 0));
-  data.concat(keyValueBoolSelected("guide_r1", status.guideRatePulse == 1 || status.guideRate == 1));
-  data.concat(keyValueBoolSelected("guide_r2", status.guideRatePulse == 2 || status.guideRate == 2));
-  data.concat(keyValueBoolSelected("guide_r3", status.guideRate == 3));
-  data.concat(keyValueBoolSelected("guide_r4", status.guideRate == 4));
-  data.concat(keyValueBoolSelected("guide_r5", status.guideRate == 5));
-  data.concat(keyValueBoolSelected("guide_r6", status.guideRate == 6));
-  data.concat(keyValueBoolSelected("guide_r7", status.guideRate == 7));
-  data.concat(keyValueBoolSelected("guide_r8", status.guideRate == 8));
-  data.concat(keyValueBoolSelected("guide_r9", status.guideRate == 9));
+  keyValueString(data, "guide_sta", status.guiding ? L_SLEWING : L_INACTIVE);
+
+  keyValueString(data, "guide_rate", GuideRatesStr[status.guideRate]);
+
+  keyValueBoolSelected(data, "guide_r0", status.guideRatePulse == 0 || status.guideRate == 0);
+  keyValueBoolSelected(data, "guide_r1", status.guideRatePulse == 1 || status.guideRate == 1);
+  keyValueBoolSelected(data, "guide_r2", status.guideRatePulse == 2 || status.guideRate == 2);
+  keyValueBoolSelected(data, "guide_r3", status.guideRate == 3);
+  keyValueBoolSelected(data, "guide_r4", status.guideRate == 4);
+  keyValueBoolSelected(data, "guide_r5", status.guideRate == 5);
+  keyValueBoolSelected(data, "guide_r6", status.guideRate == 6);
+  keyValueBoolSelected(data, "guide_r7", status.guideRate == 7);
+  keyValueBoolSelected(data, "guide_r8", status.guideRate == 8);
+  keyValueBoolSelected(data, "guide_r9", status.guideRate == 9);
 
   www.sendContentAndClear(data);
 }
@@ -88,17 +88,17 @@ void homeParkTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void homeParkTileAjax(String &data)
 {
-  data.concat(keyValueString("hp_sta", getHomeParkStateStr()));
+  keyValueString(data, "hp_sta", getHomeParkStateStr());
 
   if (status.atHome || status.parked) {
-    data.concat(keyValueBoolEnabled("park", false));
-    data.concat(keyValueBoolEnabled("unpark", true));
+    keyValueBoolEnabled(data, "park", false);
+    keyValueBoolEnabled(data, "unpark", true);
   } else {
-    data.concat(keyValueBoolEnabled("park", !(status.parkFail || status.parking)));
-    data.concat(keyValueBoolEnabled("unpark", false));
+    keyValueBoolEnabled(data, "park", !(status.parkFail || status.parking));
+    keyValueBoolEnabled(data, "unpark", false);
   }
 
-  data.concat(keyValueToggleBoolSelected("auto_on", "auto_off", status.autoHome));
+  keyValueToggleBoolSelected(data, "auto_on", "auto_off", status.autoHome);
     
   www.sendContentAndClear(data);
 }
@@ -9,7 +9,6 @@ int currentCatalog = 0;
 char currentCatName[12] = "";
 String currentObject = L_CAT_NO_OBJECT;
 bool catalogIndexChanged = false;
-bool downloadCatalogData = false;
 bool uploadCatalogData = false;
 String showMessage = L_CAT_NO_CAT;
 unsigned long currentCatNameShowTime = 0;
@@ -24,7 +23,6 @@ void libraryTile(String &data)
   currentCatName[0] = 0;
   currentObject = L_CAT_NO_OBJECT;
   catalogIndexChanged = false;
-  downloadCatalogData = false;
   uploadCatalogData = false;
   showMessage = L_CAT_NO_CAT;
 
@@ -173,129 +171,159 @@ void libraryTileAjax(String &data)
     data.concat(F("cat_data&\n"));
     catalogIndexChanged = false;
   }
-  else if (downloadCatalogData)
+  www.sendContentAndClear(data);
+}
+
+// write one line of an uploaded catalog to the currently selected catalog, line 1 holds the catalog name
+// returns false with showMessage set on failure
+bool libraryUploadLine(String line, int lineNum)
+{
+  int i;
+  String co, cat, ra, de;
+
+  // catalog name?
+  if (lineNum == 1)
   {
-    if (currentCatalog != 0)
+    line.trim();
+    if (line.charAt(0) == '$')
     {
-      data.concat(F("cat_data&"));
-      bool success = false;
-      char temp[80] = "";
-      snprintf(temp, sizeof(temp), ":Lo%ld#", (long)currentCatalog - 1);
-      if (onStep.commandBool(temp))
+      co = line.substring(0);
+      co.trim();
+      if (co.length() < 2 || co.length() > 11)
+      {
+        showMessage = F(L_CAT_UPLOAD_FAIL);
+        return false;
+      }
+      if (!onStep.commandBool(":L$#"))
+      {
+        showMessage = F(L_CAT_UPLOAD_INDEX_FAIL);
+        return false;
+      }
+      if (!onStep.commandBool(":LD#"))
       {
-        data.concat("$");
-        data.concat(currentCatName);
-        data.concat("\r");
+        showMessage = F(L_CAT_DELETE_FAIL);
+        return false;
+      }
+      if (!onStep.commandBool((":LW" + co + "#").c_str()))
+      {
+        showMessage = F(L_CAT_WRITE_NAME_FAIL);
+        return false;
+      }
+      return true;
+    }
+    else
+    {
+      showMessage = L_CAT_UPLOAD_NO_NAME_FAIL;
+      return false;
+    }
+  }
 
-        while (true)
-        {
-          onStep.command(":LR#", temp);
-          if (temp[0] == ',')
-          {
-            success = true;
-            break;
-          }
-          if (temp[0] == 0) break;
-
-          // isolate the individual fields (and error check)
-          int i = 0;
-          String r = temp;
-          String nameS = "";
-          String catS = "";
-          String raS = "";
-          String decS = "";
-
-          r = r + ",";
-          i = r.indexOf(",");
-          if (i >= 0)
-          {
-            nameS = r.substring(0, i);
-            r = r.substring(i + 1);
-          }
-          else
-          {
-            success = false;
-            break;
-          }
-          i = r.indexOf(",");
-          if (i >= 0)
-          {
-            catS = r.substring(0, i);
-            r = r.substring(i + 1);
-          }
-          else
-          {
-            success = false;
-            break;
-          }
-          i = r.indexOf(",");
-          if (i >= 0)
-          {
-            raS = r.substring(0, i);
-            r = r.substring(i + 1);
-          }
-          else
-          {
-            success = false;
-            break;
-          }
-          i = r.indexOf(",");
-          if (i >= 0)
-          {
-            decS = r.substring(0, i);
-            r = r.substring(i + 1);
-          }
-          else
-          {
-            success = false;
-            break;
-          }
+  i = line.indexOf(",");
+  if (i >= 0)
+  {
+    co = line.substring(0, i);
+    line = line.substring(i + 1);
+  }
+  else
+  {
+    showMessage = F(L_CAT_BAD_FORM);
+    showMessage += String(lineNum);
+    return false;
+  }
 
-          // pad to the correct length (and error check)
-          i = 11 - nameS.length();
-          if (i >= 0)
-          {
-            for (int j = 0; j < i; j++)
-              nameS = nameS + " ";
-          }
-          else
-          {
-            success = false;
-            break;
-          }
-          i = 3 - catS.length();
-          if (i >= 0)
-          {
-            for (int j = 0; j < i; j++)
-              catS = catS + " ";
-          }
-          else
-          {
-            success = false;
-            break;
-          }
+  i = line.indexOf(",");
+  if (i >= 0)
+  {
+    cat = line.substring(0, i);
+    line = line.substring(i + 1);
+  }
+  else
+  {
+    showMessage = F(L_CAT_BAD_FORM);
+    showMessage += String(lineNum);
+    return false;
+  }
+
+  i = line.indexOf(",");
+  if (i >= 0)
+  {
+    ra = line.substring(0, i);
+    line = line.substring(i + 1);
+  }
+  else
+  {
+    showMessage = F(L_CAT_BAD_FORM);
+    showMessage += String(lineNum);
+    return false;
+  }
+  de = line;
 
-          r = nameS + "," + catS + "," + raS + "," + decS;
+  co.trim();
+  cat.trim();
+  ra.trim();
+  de.trim();
 
-          data.concat(r);
-          data.concat("\r");
-        }
-        if (!success)
-          showMessage = F(L_CAT_DOWNLOAD_FAIL);
-        else
-          showMessage = F(L_CAT_DOWNLOAD_SUCCESS);
-      }
-      else
-        showMessage = F(L_CAT_DOWNLOAD_INDEX_FAIL);
-    }
-    else
-      showMessage = F(L_CAT_DOWNLOAD_INDEX_FAIL);
-    data.concat("\n");
+  if (co.length() < 1 || co.length() > 11)
+  {
+    showMessage = F(L_CAT_UPLOAD_BAD_OBJECT_NAME);
+    showMessage += String(lineNum);
+    return false;
+  }
 
-    downloadCatalogData = false;
+  if (cat != "UNK" && cat != "OC" && cat != "GC" && cat != "PN" &&
+      cat != "DN" && cat != "SG" && cat != "EG" && cat != "IG" &&
+      cat != "KNT" && cat != "SNR" && cat != "GAL" && cat != "CN" &&
+      cat != "STR" && cat != "PLA" && cat != "CMT" && cat != "AST")
+  {
+    showMessage = F(L_CAT_BAD_CATEGORY);
+    showMessage += String(lineNum);
+    return false;
   }
 
-  www.sendContentAndClear(data);
+  if (!isDigit(ra.charAt(0)) || !isDigit(ra.charAt(1)) ||
+      !isDigit(ra.charAt(3)) || !isDigit(ra.charAt(4)) ||
+      !isDigit(ra.charAt(6)) || !isDigit(ra.charAt(7)) ||
+      ra.charAt(2) != ':' || ra.charAt(5) != ':' || ra.length() != 8)
+  {
+    showMessage = F(L_CAT_BAD_RA);
+    showMessage += String(lineNum);
+    return false;
+  }
+
+  if (!isDigit(de.charAt(1)) || !isDigit(de.charAt(2)) ||
+      !isDigit(de.charAt(4)) || !isDigit(de.charAt(5)) ||
+      !isDigit(de.charAt(7)) || !isDigit(de.charAt(8)) ||
+      (de.charAt(0) != '+' && de.charAt(0) != '-') ||
+      (de.charAt(3) != '*' && de.charAt(3) != ':') ||
+      de.charAt(6) != ':' || de.length() != 9)
+  {
+    showMessage = F(L_CAT_BAD_DEC);
+    showMessage += String(lineNum);
+    return false;
+  }
+
+  if (!onStep.commandBool((":Sr" + ra + "#").c_str()))
+  {
+    showMessage = F(L_CAT_UPLOAD_RA_FAIL);
+    showMessage += String(lineNum);
+    return false;
+  }
+
+  if (!onStep.commandBool((":Sd" + de + "#").c_str()))
+  {
+    showMessage = F(L_CAT_UPLOAD_DEC_FAIL);
+    showMessage += String(lineNum);
+    return false;
+  }
+
+  if (!onStep.commandBool((":LW" + co + "," + cat + "#").c_str()))
+  {
+    showMessage = F(L_CAT_UPLOAD_LINE_FAIL);
+    showMessage += String(lineNum);
+    return false;
+  }
+
+  return true;
 }
 
 // pass related data back to OnStep
@@ -374,7 +402,7 @@ void libraryTileGet()
       if (v.equals("cat_download"))
       {
         snprintf(temp, sizeof(temp), ":Lo%ld#", (long)currentCatalog - 1);
-        if (onStep.commandBool(temp)) downloadCatalogData = true; else currentCatalog = 0;
+        if (!onStep.commandBool(temp)) currentCatalog = 0;
       }
     }
   }
@@ -408,7 +436,7 @@ void libraryTileGet()
         while (v.length() > 0)
         { // any data left?
           lineNum++;
-          String line, co, cat, ra, de;
+          String line;
           i = v.indexOf("\n");
           if (i >= 0)
           {
@@ -421,155 +449,174 @@ void libraryTileGet()
             v = "";
           }
 
-          // catalog name?
-          if (lineNum == 1)
-          {
-            line.trim();
-            if (line.charAt(0) == '$')
-            {
-              co = line.substring(0);
-              co.trim();
-              if (co.length() < 2 || co.length() > 11)
-              {
-                showMessage = F(L_CAT_UPLOAD_FAIL);
-                break;
-              }
-              if (!onStep.commandBool(":L$#"))
-              {
-                showMessage = F(L_CAT_UPLOAD_INDEX_FAIL);
-                break;
-              }
-              if (!onStep.commandBool(":LD#"))
-              {
-                showMessage = F(L_CAT_DELETE_FAIL);
-                break;
-              }
-              if (!onStep.commandBool((":LW" + co + "#").c_str()))
-              {
-                showMessage = F(L_CAT_WRITE_NAME_FAIL);
-                break;
-              }
-              continue;
-            }
-            else
-            {
-              showMessage = L_CAT_UPLOAD_NO_NAME_FAIL;
-              break;
-            }
-          }
+          if (!libraryUploadLine(line, lineNum)) break;
+        }
+        if (showMessage == "")
+          showMessage = L_CAT_UPLOAD_SUCCESS ", " + String(lineNum) + " " L_CAT_UPLOAD_LINES_WRITTEN ".";
+      }
+      else
+        showMessage = F(L_CAT_UPLOAD_SELECT_FAIL);
+    }
+    else
+      showMessage = F(L_CAT_UPLOAD_NO_CAT);
+  }
+}
 
-          i = line.indexOf(",");
-          if (i >= 0)
-          {
-            co = line.substring(0, i);
-            line = line.substring(i + 1);
-          }
-          else
-          {
-            showMessage = F(L_CAT_BAD_FORM);
-            showMessage += String(lineNum);
-            break;
-          }
+// reformat a ":LR#" record as a catalog line with the name and category padded into columns
+// returns false if the record is malformed
+bool libraryFormatRecord(const char *record, char *line, int size)
+{
+  char name[12], cat[4];
+  const char *field[4];
+  int length[4];
+
+  // isolate the individual fields (and error check)
+  const char *p = record;
+  for (int i = 0; i < 4; i++) {
+    field[i] = p;
+    const char *end = strchr(p, ',');
+    if (end == NULL) {
+      if (i < 3) return false;
+      end = p + strlen(p);
+    }
+    length[i] = end - p;
+    p = end + 1;
+  }
+  if (length[0] > 11 || length[1] > 3) return false;
 
-          i = line.indexOf(",");
-          if (i >= 0)
-          {
-            cat = line.substring(0, i);
-            line = line.substring(i + 1);
-          }
-          else
-          {
-            showMessage = F(L_CAT_BAD_FORM);
-            showMessage += String(lineNum);
-            break;
-          }
+  memcpy(name, field[0], length[0]); name[length[0]] = 0;
+  memcpy(cat, field[1], length[1]); cat[length[1]] = 0;
+  snprintf(line, size, "%-11s,%-3s,%.*s,%.*s\n", name, cat, length[2], field[2], length[3], field[3]);
+  return true;
+}
 
-          i = line.indexOf(",");
-          if (i >= 0)
-          {
-            ra = line.substring(0, i);
-            line = line.substring(i + 1);
-          }
-          else
-          {
-            showMessage = F(L_CAT_BAD_FORM);
-            showMessage += String(lineNum);
-            break;
-          }
-          de = line;
+// stream the selected catalog as text, one record per line
+// neither the state lock nor the command channel is held across the stream, each :LR# takes the channel only
+// for its own round trip; the state poller sends no library commands so the record pointer isn't moved between
+void libraryCatalogDownload()
+{
+  String data;
+  char temp[80] = "", line[80];
 
-          co.trim();
-          cat.trim();
-          ra.trim();
-          de.trim();
+  www.sendHeader("Cache-Control", "no-cache");
 
-          if (co.length() < 1 || co.length() > 11)
-          {
-            showMessage = F(L_CAT_UPLOAD_BAD_OBJECT_NAME);
-            showMessage += String(lineNum);
-            break;
-          }
+  snprintf(temp, sizeof(temp), ":Lo%ld#", (long)currentCatalog - 1);
+  if (currentCatalog < 1 || currentCatalog > 15 || !onStep.commandBool(temp))
+  {
+    www.send(404, "text/plain", L_CAT_DOWNLOAD_INDEX_FAIL);
+    return;
+  }
 
-          if (cat != "UNK" && cat != "OC" && cat != "GC" && cat != "PN" &&
-              cat != "DN" && cat != "SG" && cat != "EG" && cat != "IG" &&
-              cat != "KNT" && cat != "SNR" && cat != "GAL" && cat != "CN" &&
-              cat != "STR" && cat != "PLA" && cat != "CMT" && cat != "AST")
-          {
-            showMessage = F(L_CAT_BAD_CATEGORY);
-            showMessage += String(lineNum);
-            break;
-          }
+  www.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  www.send(200, "text/plain", String());
 
-          if (!isDigit(ra.charAt(0)) || !isDigit(ra.charAt(1)) ||
-              !isDigit(ra.charAt(3)) || !isDigit(ra.charAt(4)) ||
-              !isDigit(ra.charAt(6)) || !isDigit(ra.charAt(7)) ||
-              ra.charAt(2) != ':' || ra.charAt(5) != ':' || ra.length() != 8)
-          {
-            showMessage = F(L_CAT_BAD_RA);
-            showMessage += String(lineNum);
-            break;
-          }
+  data.concat("$");
+  data.concat(currentCatName);
+  data.concat("\n");
 
-          if (!isDigit(de.charAt(1)) || !isDigit(de.charAt(2)) ||
-              !isDigit(de.charAt(4)) || !isDigit(de.charAt(5)) ||
-              !isDigit(de.charAt(7)) || !isDigit(de.charAt(8)) ||
-              (de.charAt(0) != '+' && de.charAt(0) != '-') ||
-              (de.charAt(3) != '*' && de.charAt(3) != ':') ||
-              de.charAt(6) != ':' || de.length() != 9)
-          {
-            showMessage = F(L_CAT_BAD_DEC);
-            showMessage += String(lineNum);
-            break;
-          }
+  unsigned long startTime = millis();
+  long records = 0;
+  bool success = false;
+  while (true)
+  {
+    onStep.command(":LR#", temp);
+    if (temp[0] == ',') { success = true; break; }
+    if (temp[0] == 0 || !libraryFormatRecord(temp, line, sizeof(line))) break;
+    data.concat(line);
+    records++;
+
+    // send in chunks of about a TCP segment
+    if (data.length() > 1200) www.sendContentAndClear(data);
+  }
+  if (!success) data.concat(F("!" L_CAT_DOWNLOAD_FAIL "\n"));
+  www.sendContentAndClear(data);
+  www.sendContent("");
 
-          if (!onStep.commandBool((":Sr" + ra + "#").c_str()))
-          {
-            showMessage = F(L_CAT_UPLOAD_RA_FAIL);
-            showMessage += String(lineNum);
-            break;
-          }
+  VF("MSG: Library, catalog download "); V(records); VF(" records in "); V(millis() - startTime); VLF("ms");
+}
 
-          if (!onStep.commandBool((":Sd" + de + "#").c_str()))
-          {
-            showMessage = F(L_CAT_UPLOAD_DEC_FAIL);
-            showMessage += String(lineNum);
-            break;
-          }
+// catalog upload state, the POST body is parsed a line at a time as it arrives
+String _uploadLine;
+int _uploadLineNum = 0;
+bool _uploadOk = false;
+unsigned long _uploadStartTime = 0;
 
-          if (!onStep.commandBool((":LW" + co + "," + cat + "#").c_str()))
-          {
-            showMessage = F(L_CAT_UPLOAD_LINE_FAIL);
-            showMessage += String(lineNum);
-            break;
-          }
-        }
-        if (showMessage == "")
-          showMessage = L_CAT_UPLOAD_SUCCESS ", " + String(lineNum) + " " L_CAT_UPLOAD_LINES_WRITTEN ".";
+void libraryCatalogUploadLine()
+{
+  if (!_uploadOk) return;
+  _uploadLineNum++;
+  if (!libraryUploadLine(_uploadLine, _uploadLineNum)) _uploadOk = false;
+  _uploadLine = "";
+}
+
+// receives the catalog file as the web server reads it from the client
+void libraryCatalogUploadData()
+{
+  HTTPUpload &upload = www.upload();
+
+  if (upload.status == UPLOAD_FILE_START)
+  {
+    showMessage = "";
+    currentObject = "";
+    uploadCatalogData = true;
+    _uploadLine = "";
+    _uploadLineNum = 0;
+    _uploadOk = false;
+    _uploadStartTime = millis();
+
+    char temp[20];
+    snprintf(temp, sizeof(temp), ":Lo%d#", currentCatalog - 1);
+    if (currentCatalog < 1 || currentCatalog > 15) showMessage = F(L_CAT_UPLOAD_NO_CAT); else
+    if (!onStep.commandBool(temp)) showMessage = F(L_CAT_UPLOAD_SELECT_FAIL); else
+    {
+      onStep.commandBlind(":LL#"); // clear this catalog
+      _uploadOk = true;
+    }
+  } else
+  if (upload.status == UPLOAD_FILE_WRITE)
+  {
+    for (size_t i = 0; i < upload.currentSize && _uploadOk; i++)
+    {
+      char c = upload.buf[i];
+      if (c == '\n') libraryCatalogUploadLine(); else
+      if (c != '\r')
+      {
+        // no valid line is anywhere near this long
+        if (_uploadLine.length() > 80)
+        {
+          showMessage = F(L_CAT_BAD_FORM);
+          showMessage += String(_uploadLineNum + 1);
+          _uploadOk = false;
+        } else _uploadLine.concat(c);
       }
-      else
-        showMessage = F(L_CAT_UPLOAD_SELECT_FAIL);
     }
-    else
-      showMessage = F(L_CAT_UPLOAD_NO_CAT);
+  } else
+  if (upload.status == UPLOAD_FILE_END)
+  {
+    _uploadLine.trim();
+    if (_uploadLine.length() > 0) libraryCatalogUploadLine();
+    if (_uploadOk)
+    {
+      if (_uploadLineNum == 0) showMessage = L_CAT_DATA_REMOVED "."; else
+        showMessage = L_CAT_UPLOAD_SUCCESS ", " + String(_uploadLineNum) + " " L_CAT_UPLOAD_LINES_WRITTEN ".";
+    }
+    VF("MSG: Library, catalog upload "); V(_uploadLineNum); VF(" lines in "); V(millis() - _uploadStartTime); VLF("ms");
+  } else
+  if (upload.status == UPLOAD_FILE_ABORTED)
+  {
+    showMessage = F(L_CAT_UPLOAD_LINE_FAIL);
+    showMessage += String(_uploadLineNum + 1);
+    _uploadOk = false;
   }
 }
+
+// reply once the catalog upload is complete
+void libraryCatalogUpload()
+{
+  _uploadLine = "";
+  www.sendHeader("Cache-Control", "no-cache");
+  www.send(_uploadOk ? 200 : 400, "text/plain", showMessage);
+
+  // the page shows the reply itself
+  showMessage = "";
+}
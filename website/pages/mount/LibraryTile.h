@@ -46,10 +46,10 @@ const char html_catShowMessage[] PROGMEM =
 "<div id='cat_message' style='margin: 0 auto; width: 14em; margin-top: 0.5em; margin-bottom: 1em; background-color: " COLOR_LIGHT_BACKGROUND "; color: " COLOR_LIGHT_FOREGROUND "; border: 1px solid " COLOR_BORDER "; padding: 2px;'>" L_CAT_NO_OBJECT "</div>\n";
 
 const char html_libUploadCatalog[] PROGMEM =
-"&nbsp;&nbsp;<button id='cat_upload' type='button' onclick=\"busy(); t('cat_upload',document.getElementById('cat_data').value);\" disabled>" L_UPLOAD "</button>\n";
+"&nbsp;&nbsp;<button id='cat_upload' type='button' onclick=\"catUpload();\" disabled>" L_UPLOAD "</button>\n";
 
 const char html_libDownloadCatalog[] PROGMEM =
-"&nbsp;<button id='cat_download' type='button' onclick=\"busy(); s('lib','cat_download');\" disabled>" L_DOWNLOAD "</button>\n";
+"&nbsp;<button id='cat_download' type='button' onclick=\"catDownload();\" disabled>" L_DOWNLOAD "</button>\n";
 
 const char html_libClearCatalog[] PROGMEM =
 "&nbsp;<button id='lib_clear' type='button' onclick=\"busy(); if (confirm('" L_ARE_YOU_SURE "?')) s('lib','clear')\">" L_CAT_CLEAR_LIB "</button>\n";
@@ -65,10 +65,40 @@ const char html_libCatalogHelp[] PROGMEM =
 // Javascript for library status
 const char html_script_ajax_library[] PROGMEM =
 "<script>\n"
-"function t(key,v) { if (v.length==0) v='DELETE'; s(key,v.replace(/ /g, '_')); }\n"
 "function busy() {\n"
   "document.getElementById('lib_message').innerHTML='Working...';"
   "document.getElementById('cat_upload').disabled=true;"
   "document.getElementById('cat_download').disabled=true;"
 "}\n"
+"function catRate(n,t0) { var t=(Date.now()-t0)/1000; return t>0?Math.round(n/t):n; }\n"
+"function catDownload() {\n"
+  "busy();"
+  "var m=document.getElementById('lib_message');"
+  "var t0=Date.now();"
+  "var r=new XMLHttpRequest();"
+  "r.open('GET','catalog.txt',true);"
+  "r.onprogress=function() { m.innerHTML='Working... '+(r.responseText.split('\\n').length-2); };"
+  "r.onloadend=function() {"
+    "document.getElementById('cat_download').disabled=false;"
+    "if (r.status!=200) { m.innerHTML=r.responseText; return; }"
+    "var l=r.responseText.split('\\n'); if (l[l.length-1]=='') l.pop();"
+    "if (l.length>0 && l[l.length-1].charAt(0)=='!') { m.innerHTML=l.pop().substring(1); } else "
+    "m.innerHTML='" L_CAT_DOWNLOAD_SUCCESS " '+(l.length-1)+' ('+catRate(l.length-1,t0)+'/s)';"
+    "document.getElementById('cat_data').value=l.join('\\n');"
+  "};"
+  "r.send();"
+"}\n"
+"function catUpload() {\n"
+  "busy();"
+  "var m=document.getElementById('lib_message');"
+  "var v=document.getElementById('cat_data').value;"
+  "var f=new FormData();"
+  "f.append('catalog',new Blob([v],{type:'text/plain'}),'catalog.txt');"
+  "var t0=Date.now();"
+  "var r=new XMLHttpRequest();"
+  "r.open('POST','catalog-upload.txt',true);"
+  "r.upload.onprogress=function(e) { if (e.lengthComputable) m.innerHTML='Working... '+Math.round(e.loaded*100/e.total)+'%'; };"
+  "r.onloadend=function() { m.innerHTML=r.responseText; if (r.status==200) m.innerHTML+=' ('+catRate(v.split('\\n').length,t0)+'/s)'; };"
+  "r.send(f);"
+"}\n"
 "</script>\n";
@@ -8,9 +8,24 @@
 
 void processMountGet();
 
+// tiles in view as reported by the client, for example ",goto,lib+,pec," (when not reported all tiles are updated)
+String _mountView;
+bool _mountViewReported = false;
+
+bool mountTileVisible(const char *tile, bool open)
+{
+  if (!_mountViewReported) return true;
+  char key[16];
+  snprintf(key, sizeof(key), ",%s+,", tile);
+  if (_mountView.indexOf(key) >= 0) return true;
+  if (open) return false;
+  snprintf(key, sizeof(key), ",%s,", tile);
+  return _mountView.indexOf(key) >= 0;
+}
+
 void handleMount()
 {
-  char temp[240] = "";
+  char temp[480] = "";
 
   state.updateMount(true);
 
@@ -60,6 +75,7 @@ void handleMount()
   data.concat(FPSTR(html_script_ajax_date_time_return));
   data.concat(F("<script>var ajaxPage='mount-ajax.txt';</script>\n"));
   www.sendContentAndClear(data);
+  data.concat(FPSTR(html_script_mount_view));
   data.concat(FPSTR(html_script_ajax));
   www.sendContentAndClear(data);
 
@@ -69,6 +85,9 @@ void handleMount()
   alignTile(data);
   gotoTile(data);
   libraryTile(data);
+  #if DISPLAY_OBJECT_CATALOG == ON
+    objectsTile(data);
+  #endif
   guideTile(data);
   trackingTile(data);
   if (status.pecEnabled) pecTile(data);
@@ -105,16 +124,22 @@ void mountAjax()
   www.sendHeader("Cache-Control", "no-cache");
   www.send(200, "text/plain", String());
 
+  _mountViewReported = www.hasArg("v");
+  if (_mountViewReported) _mountView = "," + www.arg("v") + ",";
+
   if (status.onStepFound)
   {
-    siteTileAjax(data);
-    homeParkTileAjax(data);
-    alignTileAjax(data);
-    gotoTileAjax(data);
-    libraryTileAjax(data);
-    guideTileAjax(data);
-    trackingTileAjax(data);
-    if (status.pecEnabled) pecTileAjax(data);
+    if (mountTileVisible("site")) siteTileAjax(data);
+    if (mountTileVisible("home")) homeParkTileAjax(data);
+    if (mountTileVisible("align")) alignTileAjax(data);
+    if (mountTileVisible("goto")) gotoTileAjax(data);
+    if (mountTileVisible("lib")) libraryTileAjax(data);
+    #if DISPLAY_OBJECT_CATALOG == ON
+      if (mountTileVisible("obj")) objectsTileAjax(data);
+    #endif
+    if (mountTileVisible("guide")) guideTileAjax(data);
+    if (mountTileVisible("trk")) trackingTileAjax(data);
+    if (status.pecEnabled && mountTileVisible("pec")) pecTileAjax(data);
     limitsTileAjax(data);
   }
   else
@@ -126,19 +151,20 @@ void mountAjax()
       "alg2", "alg3", "alga", "rpa", "trk_sid", "trk_sol", "trk_lun",
       "ot_on", "ot_ref", "ot_off", "ot_dul", "ot_sgl",
     };
-    for (int i = 0; i < 27; i++) data.concat(keyValueBoolEnabled(keys_en[i], false));
+    for (int i = 0; i < 27; i++) keyValueBoolEnabled(data, keys_en[i], false);
 
     char keys_str[14][18] = {
       "date_ut", "time_ut", "time_lst", "site_long", "site_lat", "pier_side", "idx_a1", 
       "idx_a2", "tgt_a1", "tgt_a2", "track", "align_progress", "align_lr", "align_ud",
     };
-    for (int i = 0; i < 5; i++) data.concat(keyValueString(keys_str[i], "?"));
+    for (int i = 0; i < 5; i++) keyValueString(data, keys_str[i], "?");
   }
 
   www.sendContentAndClear(data);
   www.sendContent("");
 
-  state.lastMountPageLoadTime = millis();
+  // with nothing in view (page hidden) let the mount state go stale
+  if (!_mountViewReported || _mountView.length() > 2) state.lastMountPageLoadTime = millis();
 }
 
 void processMountGet()
@@ -151,6 +177,9 @@ void processMountGet()
   alignTileGet();
   gotoTileGet();
   libraryTileGet();
+  #if DISPLAY_OBJECT_CATALOG == ON
+    objectsTileGet();
+  #endif
   guideTileGet();
   trackingTileGet();
   if (status.pecEnabled) pecTileGet();
@@ -14,7 +14,30 @@
 #include "AlignTile.h"
 #include "GotoTile.h"
 #include "LibraryTile.h"
+#if DISPLAY_OBJECT_CATALOG == ON
+  #include "ObjectsTile.h"
+#endif
 #include "GuideTile.h"
 #include "TrackingTile.h"
 #include "PecTile.h"
 #include "LimitsTile.h"
+
+// true if the client reports this tile (or with open true, one of its collapsibles) in view
+extern bool mountTileVisible(const char *tile, bool open = false);
+
+// Javascript to report the tiles in view to mountAjax, each tile is found by an element it contains
+const char html_script_mount_view[] PROGMEM =
+"<script>\n"
+"var ajaxTiles={site:'date_ut',home:'park',align:'align_lr',goto:'gto_i1',lib:'lib_message',obj:'obj_count',guide:'guide_r0',trk:'trk_on',pec:'pec_sta'};\n"
+"function ajaxView() {\n"
+  "var v=[];"
+  "if (!document.hidden) for (var k in ajaxTiles) {"
+    "var e=document.getElementById(ajaxTiles[k]); if (!e) continue;"
+    "var t=e.closest('.b1'); if (!t) continue;"
+    "var r=t.getBoundingClientRect();"
+    "if (r.bottom<0 || r.top>window.innerHeight) continue;"
+    "v.push(k+(t.querySelector('.collapsible.active')?'+':''));"
+  "}"
+  "return 'v='+v.join(',');"
+"}\n"
+"</script>\n";
@@ -0,0 +1,209 @@
+// -----------------------------------------------------------------------------------
+// Objects tile
+#include "ObjectsTile.h"
+
+#if DISPLAY_OBJECT_CATALOG == ON
+
+#include "../KeyValue.h"
+#include "../Pages.common.h"
+#include "../../libApp/catalog/ObjectCatalog.h"
+
+// most objects returned by one search
+#define OBJECT_FIND_MAX 20
+
+String objectsMessage = "";
+
+// create the related webpage tile
+void objectsTile(String &data)
+{
+  char temp[240] = "";
+
+  data.concat(FPSTR(html_script_objects));
+
+  snprintf_P(temp, sizeof(temp), html_tile_beg, "22em", "15em", L_OBJECTS);
+  data.concat(temp);
+  data.concat(F("<div style='float: right; text-align: right;' id='obj_count' class='c'>"));
+  data.concat(objectCatalog.count());
+  data.concat(" " L_OBJ_COUNT);
+  data.concat(F("</div><br /><hr>"));
+
+  data.concat(FPSTR(html_objFind));
+  data.concat(FPSTR(html_objList));
+  data.concat(FPSTR(html_objShowMessage));
+  www.sendContentAndClear(data);
+
+  data.concat(F("<hr>"));
+  snprintf_P(temp, sizeof(temp), html_collapsable_beg, L_CONTROLS "...");
+  data.concat(temp);
+  data.concat(FPSTR(html_objUpload));
+  data.concat(FPSTR(html_collapsable_end));
+
+  data.concat(FPSTR(html_tile_end));
+  www.sendContentAndClear(data);
+
+  if (objectCatalog.count() == 0) objectsMessage = L_OBJ_NONE;
+}
+
+// use Ajax key/value pairs to pass related data to the web client in the background
+void objectsTileAjax(String &data)
+{
+  char temp[40];
+  snprintf(temp, sizeof(temp), "%d " L_OBJ_COUNT, objectCatalog.count());
+  keyValueString(data, "obj_count", temp);
+
+  if (objectsMessage.length() > 0) {
+    keyValueString(data, "obj_message", objectsMessage.c_str());
+    objectsMessage = "";
+  }
+
+  www.sendContentAndClear(data);
+}
+
+// pass related data back to OnStep
+void objectsTileGet()
+{
+  String v = www.arg("obj_sel");
+  if (!v.equals(EmptyStr))
+  {
+    int i = v.toInt();
+    if (i >= 0 && i < objectCatalog.count())
+    {
+      const CatalogObject *object = objectCatalog.object(i);
+      char command[20], coord[12];
+      char name[15];
+      memcpy(name, object->name, 14); name[14] = 0;
+
+      objectCatalog.formatRa(object, coord);
+      snprintf(command, sizeof(command), ":Sr%s#", coord);
+      bool success = onStep.commandBool(command);
+      objectCatalog.formatDec(object, coord);
+      snprintf(command, sizeof(command), ":Sd%s#", coord);
+      success = success && onStep.commandBool(command);
+
+      objectsMessage = name;
+      if (success) objectsMessage += " " L_SELECTED "."; else objectsMessage += " ?";
+    }
+  }
+}
+
+// search the object catalog by name prefix (find=) or for the nearest object to a position (near=)
+// one object per line: index,name,category,RA,Dec,magnitude
+void objectsFind()
+{
+  String data;
+  char temp[80], ra[12], dec[12], magnitude[8];
+  int results[OBJECT_FIND_MAX];
+  int found = 0;
+
+  if (www.hasArg("find"))
+  {
+    String prefix = www.arg("find");
+    if (prefix.length() > 0) found = objectCatalog.find(prefix.c_str(), results, OBJECT_FIND_MAX);
+  } else
+  if (www.hasArg("near"))
+  {
+    // defaults to the nearest star brighter than 3rd magnitude to the mount's current position
+    state.lock();
+    double nearRa = state.indexRa;
+    double nearDec = state.indexDec;
+    state.unlock();
+    if (www.hasArg("ra")) nearRa = www.arg("ra").toDouble();
+    if (www.hasArg("dec")) nearDec = www.arg("dec").toDouble();
+    float magnitudeLimit = www.hasArg("mag") ? www.arg("mag").toFloat() : 3.0F;
+    int category = objectCatalog.categoryIndex(www.hasArg("cat") ? www.arg("cat").c_str() : "STR");
+    results[0] = objectCatalog.nearest(nearRa, nearDec, magnitudeLimit, category);
+    if (results[0] >= 0) found = 1;
+  }
+
+  www.sendHeader("Cache-Control", "no-cache");
+  www.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  www.send(200, "text/plain", String());
+
+  for (int i = 0; i < found; i++)
+  {
+    const CatalogObject *object = objectCatalog.object(results[i]);
+    objectCatalog.formatRa(object, ra);
+    objectCatalog.formatDec(object, dec);
+    if (object->magnitude == OBJECT_MAGNITUDE_UNKNOWN) strcpy(magnitude, "?"); else
+      sprintF(magnitude, "%1.1f", object->magnitude/10.0);
+    snprintf(temp, sizeof(temp), "%d,%.14s,%s,%s,%s,%s\n", results[i], object->name, objectCatalog.categoryName(object->category), ra, dec, magnitude);
+    data.concat(temp);
+  }
+
+  www.sendContentAndClear(data);
+  www.sendContent("");
+}
+
+// object catalog upload state, the POST body is parsed a line at a time as it arrives
+char _objectLine[80];
+int _objectLineLength = 0;
+int _objectLineNum = 0;
+bool _objectUploadOk = false;
+
+void objectsUploadLine()
+{
+  _objectLine[_objectLineLength] = 0;
+  _objectLineLength = 0;
+  _objectLineNum++;
+  if (_objectUploadOk && !objectCatalog.importLine(_objectLine)) _objectUploadOk = false;
+}
+
+// receives the object catalog file as the web server reads it from the client
+void objectsUploadData()
+{
+  HTTPUpload &upload = www.upload();
+
+  if (upload.status == UPLOAD_FILE_START)
+  {
+    _objectLineLength = 0;
+    _objectLineNum = 0;
+    _objectUploadOk = objectCatalog.importBegin();
+  } else
+  if (upload.status == UPLOAD_FILE_WRITE)
+  {
+    for (size_t i = 0; i < upload.currentSize && _objectUploadOk; i++)
+    {
+      char c = upload.buf[i];
+      if (c == '\n') objectsUploadLine(); else
+      if (c != '\r')
+      {
+        if (_objectLineLength >= (int)sizeof(_objectLine) - 1)
+        {
+          objectCatalog.importError = L_CAT_BAD_FORM;
+          _objectLineNum++;
+          _objectUploadOk = false;
+        } else _objectLine[_objectLineLength++] = c;
+      }
+    }
+  } else
+  if (upload.status == UPLOAD_FILE_END)
+  {
+    if (_objectUploadOk && _objectLineLength > 0) objectsUploadLine();
+    if (_objectUploadOk) _objectUploadOk = objectCatalog.importEnd(); else objectCatalog.importAbort();
+  } else
+  if (upload.status == UPLOAD_FILE_ABORTED)
+  {
+    objectCatalog.importAbort();
+    objectCatalog.importError = L_CAT_BAD_FORM;
+    _objectUploadOk = false;
+  }
+}
+
+// reply once the object catalog upload is complete
+void objectsUpload()
+{
+  String message;
+  if (_objectUploadOk)
+  {
+    message = L_CAT_UPLOAD_SUCCESS ", " + String(objectCatalog.count()) + " " L_OBJ_COUNT ".";
+  } else
+  {
+    message = objectCatalog.importError;
+    if (message.endsWith("# ")) message += String(_objectLineNum);
+  }
+
+  www.sendHeader("Cache-Control", "no-cache");
+  www.send(_objectUploadOk ? 200 : 400, "text/plain", message);
+}
+
+#endif
@@ -0,0 +1,64 @@
+// -----------------------------------------------------------------------------------
+// Objects tile
+#pragma once
+
+#include "../htmlHeaders.h"
+#include "../htmlMessages.h"
+#include "../htmlScripts.h"
+
+#if DISPLAY_OBJECT_CATALOG == ON
+
+extern void objectsTile(String &data);
+extern void objectsTileAjax(String &data);
+extern void objectsTileGet();
+
+const char html_objFind[] PROGMEM =
+"<input id='obj_find' type='text' style='width: 9em;' maxlength='14' placeholder='M31' oninput=\"objFind('find='+encodeURIComponent(this.value))\" />"
+"&nbsp;<button type='button' onclick=\"objFind('near=1')\">" L_OBJ_NEAREST "</button><br />\n";
+
+const char html_objList[] PROGMEM =
+"<select id='obj_list' size='6' style='width: 20em; margin-top: 0.5em; font-family: monospace;'></select><br />\n"
+"<button id='obj_select' type='button' onclick=\"s('obj_sel',document.getElementById('obj_list').value);\">" L_OBJ_SET_TARGET "</button>\n";
+
+const char html_objShowMessage[] PROGMEM =
+"<div id='obj_message' style='margin: 0 auto; width: 14em; margin-top: 0.5em; margin-bottom: 1em; background-color: " COLOR_LIGHT_BACKGROUND "; color: " COLOR_LIGHT_FOREGROUND "; border: 1px solid " COLOR_BORDER "; padding: 2px;'>" L_CAT_NO_OBJECT "</div>\n";
+
+const char html_objUpload[] PROGMEM =
+"<input id='obj_file' type='file' accept='.txt,.csv' />"
+"&nbsp;<button type='button' onclick=\"objUpload();\">" L_UPLOAD "</button><br />\n";
+
+// Javascript for object search and upload, a search typed while one is in flight is remembered (only the
+// latest) and sent when the reply arrives, the reply to the older one is then not shown
+const char html_script_objects[] PROGMEM =
+"<script>\n"
+"var objBusy=false,objNext=null;\n"
+"function objFind(q) {\n"
+  "if (objBusy) { objNext=q; return; } objBusy=true;"
+  "var r=new XMLHttpRequest();"
+  "r.open('GET','objects.txt?'+q,true);"
+  "r.onloadend=function() {"
+    "objBusy=false;"
+    "if (objNext!==null) { var n=objNext; objNext=null; objFind(n); return; }"
+    "var l=document.getElementById('obj_list'); l.innerHTML='';"
+    "if (r.status!=200) return;"
+    "r.responseText.split('\\n').forEach(function(o) {"
+      "if (o=='') return; var f=o.split(',');"
+      "var e=document.createElement('option'); e.value=f[0]; e.text=f.slice(1).join(' '); l.add(e);"
+    "});"
+    "if (l.options.length>0) l.selectedIndex=0;"
+  "};"
+  "r.send();"
+"}\n"
+"function objUpload() {\n"
+  "var fi=document.getElementById('obj_file'); if (fi.files.length==0) return;"
+  "var m=document.getElementById('obj_message');"
+  "var f=new FormData(); f.append('objects',fi.files[0]);"
+  "var r=new XMLHttpRequest();"
+  "r.open('POST','objects-upload.txt',true);"
+  "r.upload.onprogress=function(e) { if (e.lengthComputable) m.innerHTML='Working... '+Math.round(e.loaded*100/e.total)+'%'; };"
+  "r.onloadend=function() { m.innerHTML=r.responseText; };"
+  "r.send(f);"
+"}\n"
+"</script>\n";
+
+#endif
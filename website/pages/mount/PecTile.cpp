@@ -36,6 +36,17 @@ void pecTile(String &data)
   data.concat(FPSTR(html_collapsable_end));
   www.sendContentAndClear(data);
 
+  // display the PEC table
+  if (status.pecEnabled) {
+    data.concat(FPSTR(html_script_pec));
+    data.concat(F("<div style='margin-top: 0.5em';></div>"));
+    snprintf_P(temp, sizeof(temp), html_collapsable_beg, L_PAGE_PEC "...");
+    data.concat(temp);
+    data.concat(FPSTR(html_pecCurve));
+    data.concat(FPSTR(html_collapsable_end));
+    www.sendContentAndClear(data);
+  }
+
   // display steps per worm rotation
   data.concat(F("<div style='margin-top: 0.5em';></div>"));
   snprintf_P(temp, sizeof(temp), html_collapsable_beg, L_SETTINGS "...");
@@ -104,3 +115,169 @@ extern void pecTileGet()
     onStep.commandBool(temp);
   }
 }
+
+// entries sent to the client at a time
+#define PEC_CHUNK_SIZE 16
+
+// most PEC table entries handled
+#define PEC_SEGMENTS_MAX 4096
+
+// number of PEC table entries (one per sidereal second of worm rotation), 0 if unknown
+int pecSegments()
+{
+  char temp[40];
+  if (!onStep.command(":VW#", temp)) return 0;
+  long stepsPerWormRotation = atol(temp);
+  if (!onStep.command(":VS#", temp)) return 0;
+  double stepsPerSecond = atof(temp);
+  if (stepsPerSecond <= 0.0) return 0;
+
+  long segments = lround(stepsPerWormRotation/stepsPerSecond);
+  if (segments < 0) segments = 0;
+  if (segments > PEC_SEGMENTS_MAX) segments = PEC_SEGMENTS_MAX;
+  return segments;
+}
+
+// stream the PEC table as text, one entry (rate adjust in steps) per line
+// OnStep has no command to read more than one entry, so this is one :VR round trip per entry, the time
+// taken is logged; neither the state lock nor the command channel is held across the stream, each :VR
+// holds the channel only for its own round trip so the state poller's commands interleave
+void pecDownload()
+{
+  String data;
+  char temp[40];
+
+  www.sendHeader("Cache-Control", "no-cache");
+
+  int segments = status.pecEnabled ? pecSegments() : 0;
+  if (segments == 0)
+  {
+    www.send(404, "text/plain", L_DISABLED_MESSAGE);
+    return;
+  }
+
+  www.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  www.send(200, "text/plain", String());
+
+  snprintf(temp, sizeof(temp), "# PEC %d\n", segments);
+  data.concat(temp);
+
+  unsigned long startTime = millis();
+  for (int i = 0; i < segments; i += PEC_CHUNK_SIZE)
+  {
+    for (int j = i; j < i + PEC_CHUNK_SIZE && j < segments; j++)
+    {
+      char command[16];
+      snprintf(command, sizeof(command), ":VR%d#", j);
+      if (!onStep.command(command, temp)) strcpy(temp, "0");
+      data.concat(atoi(temp));
+      data.concat("\n");
+    }
+    www.sendContentAndClear(data);
+  }
+  www.sendContent("");
+
+  VF("MSG: PEC, table download "); V(segments); VF(" entries in "); V(millis() - startTime); VLF("ms");
+}
+
+// PEC table upload state, the POST body is parsed a line at a time as it arrives
+char _pecLine[16];
+int _pecLineLength = 0;
+int _pecSegments = 0;
+int _pecIndex = 0;
+int _pecWritten = 0;
+bool _pecUploadOk = false;
+String _pecMessage;
+unsigned long _pecStartTime = 0;
+
+// write an entry, only when it differs from the one held by OnStep; the channel is held for just the entry
+// and the write doesn't wait, the next entry's :VR is answered once OnStep has taken it
+void pecUploadLine()
+{
+  _pecLine[_pecLineLength] = 0;
+  _pecLineLength = 0;
+  if (_pecLine[0] == '#' || _pecLine[0] == 0) return;
+
+  char *conv_end;
+  long value = strtol(_pecLine, &conv_end, 10);
+  if (conv_end == _pecLine || value < -128 || value > 127 || _pecIndex >= _pecSegments)
+  {
+    _pecMessage = F(L_CAT_BAD_FORM);
+    _pecMessage += String(_pecIndex + 1);
+    _pecUploadOk = false;
+    return;
+  }
+
+  char command[24], temp[20];
+  snprintf(command, sizeof(command), ":VR%d#", _pecIndex);
+  onStep.lock();
+  if (!onStep.command(command, temp) || atol(temp) != value)
+  {
+    snprintf(command, sizeof(command), ":WR%d,%ld#", _pecIndex, value);
+    onStep.commandBlindNoWait(command);
+    _pecWritten++;
+  }
+  onStep.unlock();
+  _pecIndex++;
+}
+
+// receives the PEC table as the web server reads it from the client
+void pecUploadData()
+{
+  HTTPUpload &upload = www.upload();
+
+  if (upload.status == UPLOAD_FILE_START)
+  {
+    _pecLineLength = 0;
+    _pecIndex = 0;
+    _pecWritten = 0;
+    _pecMessage = "";
+    _pecStartTime = millis();
+    _pecSegments = status.pecEnabled ? pecSegments() : 0;
+    _pecUploadOk = _pecSegments > 0;
+    if (!_pecUploadOk) _pecMessage = L_DISABLED_MESSAGE;
+  } else
+  if (upload.status == UPLOAD_FILE_WRITE)
+  {
+    for (size_t i = 0; i < upload.currentSize && _pecUploadOk; i++)
+    {
+      char c = upload.buf[i];
+      if (c == '\n' || c == ',') pecUploadLine(); else
+      if (c != '\r' && c != ' ')
+      {
+        if (_pecLineLength < (int)sizeof(_pecLine) - 1) _pecLine[_pecLineLength++] = c; else
+        {
+          _pecMessage = F(L_CAT_BAD_FORM);
+          _pecMessage += String(_pecIndex + 1);
+          _pecUploadOk = false;
+        }
+      }
+    }
+  } else
+  if (upload.status == UPLOAD_FILE_END)
+  {
+    if (_pecUploadOk && _pecLineLength > 0) pecUploadLine();
+    if (_pecUploadOk && _pecIndex != _pecSegments)
+    {
+      _pecMessage = F(L_CAT_BAD_FORM);
+      _pecMessage += String(_pecIndex + 1);
+      _pecUploadOk = false;
+    }
+    VF("MSG: PEC, table upload "); V(_pecIndex); VF(" entries ("); V(_pecWritten); VF(" written) in "); V(millis() - _pecStartTime); VLF("ms");
+  } else
+  if (upload.status == UPLOAD_FILE_ABORTED)
+  {
+    _pecMessage = F(L_CAT_BAD_FORM);
+    _pecMessage += String(_pecIndex + 1);
+    _pecUploadOk = false;
+  }
+}
+
+// reply once the PEC table upload is complete
+void pecUpload()
+{
+  if (_pecUploadOk) _pecMessage = L_CAT_UPLOAD_SUCCESS ", " + String(_pecWritten) + " " L_CAT_UPLOAD_LINES_WRITTEN ".";
+
+  www.sendHeader("Cache-Control", "no-cache");
+  www.send(_pecUploadOk ? 200 : 400, "text/plain", _pecMessage);
+}
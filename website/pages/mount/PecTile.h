@@ -28,6 +28,57 @@ L_PEC_CLEAR_MESSAGE "<br />";
 const char html_pecControls4[] PROGMEM =
 "<br /><button onpointerdown=\"if (confirm('" L_ARE_YOU_SURE "?')) s('pec','wrt')\" type='submit'>" L_PEC_EEWRITE "</button><br />" L_PEC_EEWRITE_MESSAGE "<br />";
 
+const char html_pecCurve[] PROGMEM =
+"<canvas id='pecCanvas' width='300' height='150' style='border:1px solid #000000;'></canvas><br />"
+"<button type='button' onclick=\"pecShow();\">" L_DOWNLOAD "</button>&nbsp;<a href='pec.txt'>pec.txt</a><br /><br />"
+"<input id='pec_file' type='file' accept='.txt,.csv' style='width: 14em;' />"
+"&nbsp;<button type='button' onclick=\"pecUpload();\">" L_UPLOAD "</button><br />"
+"<div id='pec_message'></div>\n";
+
+// Javascript to plot the PEC table, rate adjust bars and the accumulated correction (in steps) as a line
+const char html_script_pec[] PROGMEM =
+"<script>\n"
+"function pecShow() {\n"
+  "var r=new XMLHttpRequest();"
+  "r.open('GET','pec.txt',true);"
+  "r.onloadend=function() {"
+    "var m=document.getElementById('pec_message');"
+    "if (r.status!=200) { m.innerHTML=r.responseText; return; }"
+    "var v=[]; r.responseText.split('\\n').forEach(function(l) { if (l!='' && l.charAt(0)!='#') v.push(Number(l)); });"
+    "m.innerHTML=v.length;"
+    "pecPlot(v);"
+  "};"
+  "r.send();"
+"}\n"
+"function pecPlot(v) {\n"
+  "var c=document.getElementById('pecCanvas'); var ctx=c.getContext('2d');"
+  "var w=c.width, h=c.height;"
+  "ctx.fillStyle='" COLOR_SERVO_BACKGROUND_1 "'; ctx.fillRect(0,0,w,h);"
+  "ctx.strokeStyle='" COLOR_SERVO_PEN_2 "'; ctx.beginPath(); ctx.moveTo(0,h/2); ctx.lineTo(w,h/2); ctx.stroke();"
+  "if (v.length==0) return;"
+  "var a=[], t=0, ma=1, mv=1;"
+  "for (i=0;i<v.length;i++) { t+=v[i]; a.push(t); ma=Math.max(ma,Math.abs(t)); mv=Math.max(mv,Math.abs(v[i])); }"
+  "var dx=w/v.length;"
+  "ctx.fillStyle='" COLOR_SERVO_PEN_3 "';"
+  "for (i=0;i<v.length;i++) { var y=v[i]*(h/2-2)/mv; ctx.fillRect(i*dx,h/2-Math.max(y,0),Math.max(dx,1),Math.abs(y)); }"
+  "ctx.strokeStyle='" COLOR_SERVO_PEN_4 "'; ctx.beginPath();"
+  "for (i=0;i<a.length;i++) { var y=h/2-a[i]*(h/2-2)/ma; if (i==0) ctx.moveTo(0,y); else ctx.lineTo(i*dx,y); }"
+  "ctx.stroke();"
+  "ctx.fillStyle='" COLOR_SERVO_BACKGROUND_3 "'; ctx.font='bold 12px Arial'; ctx.textBaseline='top';"
+  "ctx.fillText('+/-'+ma,2,2);"
+"}\n"
+"function pecUpload() {\n"
+  "var fi=document.getElementById('pec_file'); if (fi.files.length==0) return;"
+  "var m=document.getElementById('pec_message');"
+  "var f=new FormData(); f.append('pec',fi.files[0]);"
+  "var r=new XMLHttpRequest();"
+  "r.open('POST','pec-upload.txt',true);"
+  "r.upload.onprogress=function(e) { if (e.lengthComputable) m.innerHTML='Working... '+Math.round(e.loaded*100/e.total)+'%'; };"
+  "r.onloadend=function() { m.innerHTML=r.responseText; if (r.status==200) pecShow(); };"
+  "r.send(f);"
+"}\n"
+"</script>\n";
+
 const char html_configAxisSpwr[] PROGMEM =
 L_PEC_STEPS_PER_WORM_ROTATION ":<br />"
 "<input style='width: 7em;' value='%ld' type='number' name='spwr' min='%d' max='%ld' step='1'><br />\n";
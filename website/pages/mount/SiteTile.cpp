@@ -23,15 +23,17 @@ void siteTile(String &data)
   data.concat(F("<br/><hr>"));
 
   data.concat(FPSTR(html_browserTime));
+  state.lock();
   snprintf_P(temp, sizeof(temp), html_date, state.dateStr);
   data.concat(temp);
   snprintf_P(temp, sizeof(temp), html_time, state.timeStr);
   data.concat(temp);
   snprintf_P(temp, sizeof(temp), html_sidereal, state.lastStr);
   data.concat(temp);
-  www.sendContentAndClear(data);
-  
   snprintf_P(temp, sizeof(temp), html_site, state.latitudeStr, state.longitudeStr);
+  state.unlock();
+  www.sendContentAndClear(data);
+
   data.concat(temp);
   data.concat(FPSTR(html_setDateTime));
   data.concat(F("<hr>"));
@@ -108,12 +110,14 @@ void siteTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void siteTileAjax(String &data)
 {
-  data.concat(keyValueString("date_ut", state.dateStr));
-  data.concat(keyValueString("time_ut", state.timeStr));
-  data.concat(keyValueString("time_lst", state.lastStr));
-  data.concat(keyValueString("site_long", state.longitudeStr));
-  data.concat(keyValueString("site_lat", state.latitudeStr));
-  data.concat(keyValueString("call", "update_date_time"));
+  state.lock();
+  keyValueString(data, "date_ut", state.dateStr);
+  keyValueString(data, "time_ut", state.timeStr);
+  keyValueString(data, "time_lst", state.lastStr);
+  keyValueString(data, "site_long", state.longitudeStr);
+  keyValueString(data, "site_lat", state.latitudeStr);
+  state.unlock();
+  keyValueString(data, "call", "update_date_time");
   www.sendContentAndClear(data);
 }
 
@@ -13,7 +13,9 @@ void trackingTile(String &data)
   snprintf_P(temp, sizeof(temp), html_tile_beg, "22em", "15em", L_TRACKING);
   data.concat(temp);
   data.concat(F("<div style='float: right; text-align: right;' id='track' class='c'>"));
+  state.lock();
   data.concat(state.trackStr);
+  state.unlock();
   data.concat(F("</div><br /><hr>"));
 
   data.concat(FPSTR(html_trackingEnable));
@@ -43,7 +45,8 @@ void trackingTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void trackingTileAjax(String &data)
 {
-  data.concat(keyValueString("track", state.trackStr));
+  state.lock();
+  keyValueString(data, "track", state.trackStr);
 
   if (status.mountType != MT_ALTAZM || status.getVersionMajor() >= 10) {
     char temp[16];
@@ -52,21 +55,22 @@ void trackingTileAjax(String &data)
     if (status.rateCompensation == RC_REFR_BOTH) strcpy(temp, "RCD"); else
     if (status.rateCompensation == RC_FULL_RA) strcpy(temp, "FC"); else
     if (status.rateCompensation == RC_FULL_BOTH) strcpy(temp, "FCD");
-    data.concat(keyValueString("trk_otm", temp));
+    keyValueString(data, "trk_otm", temp);
 
-    data.concat(keyValueBoolSelected("ot_on", status.rateCompensation == RC_FULL_BOTH || status.rateCompensation == RC_FULL_RA));
-    data.concat(keyValueBoolSelected("ot_ref", status.rateCompensation == RC_REFR_BOTH || status.rateCompensation == RC_REFR_RA));
-    data.concat(keyValueBoolSelected("ot_off", status.rateCompensation == RC_NONE));
+    keyValueBoolSelected(data, "ot_on", status.rateCompensation == RC_FULL_BOTH || status.rateCompensation == RC_FULL_RA);
+    keyValueBoolSelected(data, "ot_ref", status.rateCompensation == RC_REFR_BOTH || status.rateCompensation == RC_REFR_RA);
+    keyValueBoolSelected(data, "ot_off", status.rateCompensation == RC_NONE);
 
-    data.concat(keyValueBoolSelected("ot_dul", status.rateCompensation == RC_FULL_BOTH || status.rateCompensation == RC_REFR_BOTH));
-    data.concat(keyValueBoolSelected("ot_sgl", status.rateCompensation == RC_FULL_RA || status.rateCompensation == RC_REFR_RA));
+    keyValueBoolSelected(data, "ot_dul", status.rateCompensation == RC_FULL_BOTH || status.rateCompensation == RC_REFR_BOTH);
+    keyValueBoolSelected(data, "ot_sgl", status.rateCompensation == RC_FULL_RA || status.rateCompensation == RC_REFR_RA);
   }
 
-  data.concat(keyValueToggleBoolSelected("trk_on", "trk_off", status.tracking));
-  data.concat(keyValueBoolSelected("trk_sid", status.tracking && state.trackingSidereal));
-  data.concat(keyValueBoolSelected("trk_sol", status.tracking && state.trackingSolar));
-  data.concat(keyValueBoolSelected("trk_lun", status.tracking && state.trackingLunar));
-  data.concat(keyValueBoolSelected("trk_king", status.tracking && state.trackingKing));
+  keyValueToggleBoolSelected(data, "trk_on", "trk_off", status.tracking);
+  keyValueBoolSelected(data, "trk_sid", status.tracking && state.trackingSidereal);
+  keyValueBoolSelected(data, "trk_sol", status.tracking && state.trackingSolar);
+  keyValueBoolSelected(data, "trk_lun", status.tracking && state.trackingLunar);
+  keyValueBoolSelected(data, "trk_king", status.tracking && state.trackingKing);
+  state.unlock();
 
   www.sendContentAndClear(data);
 }
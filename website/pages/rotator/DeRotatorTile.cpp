@@ -27,8 +27,8 @@ void deRotatorTile(String &data)
 void deRotatorTileAjax(String &data)
 {
   if (status.mountType == MT_ALTAZM) {
-    data.concat(keyValueToggleBoolSelected("rot_on", "rot_off", state.rotatorDerotate));
-    data.concat(keyValueBoolSelected("rot_rev", state.rotatorDerotateReverse));
+    keyValueToggleBoolSelected(data, "rot_on", "rot_off", state.rotatorDerotate);
+    keyValueBoolSelected(data, "rot_rev", state.rotatorDerotateReverse);
     www.sendContentAndClear(data);
   }
 }
@@ -10,7 +10,7 @@ extern void handleNotFound();
 void processRotatorGet();
 
 void handleRotator() {
-  char temp[240] = "";
+  char temp[480] = "";
 
   state.updateRotator(true);
   if (status.rotatorFound != SD_TRUE) { handleNotFound(); return; }
@@ -12,12 +12,14 @@ void rotatorSlewingTile(String &data)
 
   snprintf_P(temp, sizeof(temp), html_tile_beg, "22em", "13em", L_SLEWING);
   data.concat(temp);
+  state.lock();
   data.concat(F("<div style='float: right; text-align: right;' id='rot_sta' class='c'>"));
   if (state.focuserSlewing) data.concat(L_ACTIVE); else data.concat(L_INACTIVE);
   data.concat(F("</div><br /><hr>"));
 
   data.concat(L_CURRENT ": <span id='rotatorpos' class='c'>");
   data.concat(state.rotatorPositionStr);
+  state.unlock();
   data.concat(F("</span><br /><br />"));
 
   data.concat(FPSTR(html_rotPosition));
@@ -32,7 +34,9 @@ void rotatorSlewingTile(String &data)
     snprintf_P(temp, sizeof(temp), html_collapsable_beg, L_CONTROLS "...");
     data.concat(temp);
 
+    state.lock();
     snprintf_P(temp, sizeof(temp), html_rotateSlewSpeed, state.rotateSlewSpeedStr);
+    state.unlock();
     data.concat(temp);
     data.concat(FPSTR(html_rotateGotoSelect));
 
@@ -46,16 +50,17 @@ void rotatorSlewingTile(String &data)
 // use Ajax key/value pairs to pass related data to the web client in the background
 void rotatorSlewingTileAjax(String &data)
 {
-  data.concat(keyValueString("rot_sta", state.rotatorSlewing ? L_ACTIVE : L_INACTIVE));
-  data.concat(keyValueString("rotatorpos", state.rotatorPositionStr));
-  data.concat(keyValueString("rot_rate", state.rotateSlewSpeedStr));
-
-  String s;
-  s = keyValueBoolSelected("rot_rate_vs", state.rotatorGotoRate == 1); data.concat(s);
-  s = keyValueBoolSelected("rot_rate_s", state.rotatorGotoRate == 2); data.concat(s);
-  s = keyValueBoolSelected("rot_rate_n", state.rotatorGotoRate == 3); data.concat(s);
-  s = keyValueBoolSelected("rot_rate_f", state.rotatorGotoRate == 4); data.concat(s);
-  s = keyValueBoolSelected("rot_rate_vf", state.rotatorGotoRate == 5); data.concat(s);
+  state.lock();
+  keyValueString(data, "rot_sta", state.rotatorSlewing ? L_ACTIVE : L_INACTIVE);
+  keyValueString(data, "rotatorpos", state.rotatorPositionStr);
+  keyValueString(data, "rot_rate", state.rotateSlewSpeedStr);
+
+  keyValueBoolSelected(data, "rot_rate_vs", state.rotatorGotoRate == 1);
+  keyValueBoolSelected(data, "rot_rate_s", state.rotatorGotoRate == 2);
+  keyValueBoolSelected(data, "rot_rate_n", state.rotatorGotoRate == 3);
+  keyValueBoolSelected(data, "rot_rate_f", state.rotatorGotoRate == 4);
+  keyValueBoolSelected(data, "rot_rate_vf", state.rotatorGotoRate == 5);
+  state.unlock();
 
   www.sendContentAndClear(data);
 }
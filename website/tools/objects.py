@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# Builds an object catalog for the website plugin's Objects tile from public data, the output is
+# the text file uploaded on the mount page.
+#
+# Deep sky objects come from OpenNGC (https://github.com/mattiaverga/OpenNGC, CC-BY-SA-4.0):
+# NGC.csv and optionally addendum.csv. Named stars come from the HYG database
+# (https://github.com/astronexus/HYG-Database, CC-BY-SA-4.0): hygdata_v3.csv or a later version.
+#
+#   python3 objects.py --ngc NGC.csv --ngc addendum.csv --stars hygdata_v3.csv > objects.txt
+#
+# The brightest objects are kept when there are more than --max (10000 with PSRAM, use 2000 without).
+
+import argparse
+import csv
+import re
+import sys
+
+# OpenNGC object types to catalog categories, types not listed are left out
+TYPES = {
+    "OCl": "OC", "*Ass": "OC", "GCl": "GC", "Cl+N": "CN", "PN": "PN", "DrkN": "DN",
+    "HII": "KNT", "SNR": "SNR", "EmN": "UNK", "RfN": "UNK", "Neb": "UNK",
+    "G": "GAL", "GPair": "GAL", "GTrpl": "GAL", "GGroup": "GAL",
+}
+
+UNKNOWN_MAGNITUDE = 99.0
+
+
+def hms(hours):
+    s = round(hours*3600.0) % 86400
+    return "%02d:%02d:%02d" % (s // 3600, (s // 60) % 60, s % 60)
+
+
+def dms(degrees):
+    s = round(abs(degrees)*3600.0)
+    return "%c%02d*%02d:%02d" % ("-" if degrees < 0 else "+", s // 3600, (s // 60) % 60, s % 60)
+
+
+def sexagesimal(text):
+    sign = -1.0 if text.strip().startswith("-") else 1.0
+    parts = [abs(float(p)) for p in text.strip().lstrip("+-").split(":")]
+    return sign*sum(p/60.0**i for i, p in enumerate(parts))
+
+
+def magnitude(*values):
+    for value in values:
+        try:
+            return float(value)
+        except (TypeError, ValueError):
+            pass
+    return UNKNOWN_MAGNITUDE
+
+
+def galaxy(hubble):
+    # the Hubble type gives the galaxy's category when known
+    hubble = (hubble or "").strip()
+    if hubble.startswith("S"): return "SG"
+    if hubble.startswith("E"): return "EG"
+    if hubble.startswith("I"): return "IG"
+    return "GAL"
+
+
+def catalog_name(name):
+    # NGC0224 -> NGC 224, IC0001 -> IC 1, others as given
+    for prefix in ("NGC", "IC"):
+        if name.startswith(prefix) and name[len(prefix):len(prefix) + 4].isdigit():
+            return prefix + " " + name[len(prefix):].lstrip("0")
+    return name
+
+
+def read_ngc(path):
+    with open(path, newline="", encoding="utf-8") as f:
+        for row in csv.DictReader(f, delimiter=";"):
+            category = TYPES.get(row["Type"])
+            if category is None or not row["RA"] or not row["Dec"]: continue
+            if category == "GAL": category = galaxy(row.get("Hubble"))
+            ra = sexagesimal(row["RA"])
+            dec = sexagesimal(row["Dec"])
+            mag = magnitude(row.get("V-Mag"), row.get("B-Mag"))
+            yield catalog_name(row["Name"]), category, ra, dec, mag
+            if row.get("M"):
+                yield "M" + str(int(row["M"])), category, ra, dec, mag
+
+
+def read_stars(path):
+    with open(path, newline="", encoding="utf-8") as f:
+        for row in csv.DictReader(f):
+            name = row.get("proper", "").strip()
+            if not name or name == "Sol": continue
+            yield name, "STR", float(row["ra"]), float(row["dec"]), magnitude(row.get("mag"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build an Objects tile catalog from OpenNGC and HYG data")
+    parser.add_argument("--ngc", action="append", default=[], help="OpenNGC csv file (NGC.csv, addendum.csv)")
+    parser.add_argument("--stars", action="append", default=[], help="HYG database csv file, named stars are used")
+    parser.add_argument("--max", type=int, default=10000, help="most objects kept, the brightest first")
+    parser.add_argument("--mag", type=float, default=UNKNOWN_MAGNITUDE, help="faintest magnitude kept")
+    args = parser.parse_args()
+
+    objects = []
+    for path in args.ngc: objects.extend(read_ngc(path))
+    for path in args.stars: objects.extend(read_stars(path))
+
+    # objects without a magnitude are kept last, Messier objects always fit ahead of them
+    objects = [o for o in objects if o[4] <= args.mag or o[4] == UNKNOWN_MAGNITUDE]
+    objects.sort(key=lambda o: (re.fullmatch(r"M\d+", o[0]) is None, o[4]))
+    objects = objects[:args.max]
+    if len(objects) == args.max: print("objects.py: kept the brightest %d objects" % args.max, file=sys.stderr)
+
+    print("# Object Name  |Cat|---RA---|---Dec---|Mag")
+    for name, category, ra, dec, mag in sorted(objects, key=lambda o: o[0]):
+        mag = "" if mag == UNKNOWN_MAGNITUDE else "%.1f" % max(-12.0, min(12.6, mag))
+        print("%-14s,%-3s,%s,%s,%s" % (name[:14], category, hms(ra), dms(dec), mag))
+
+
+if __name__ == "__main__":
+    main()